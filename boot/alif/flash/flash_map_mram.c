@@ -22,58 +22,69 @@
 #define MRAM_ERASE_VALUE                    0x0
 #define MRAM_ADDR_ALIGN_MASK                0xFFFFFFF0U
 
-static struct flash_area bootloader =
-{
-    .fa_id = FLASH_AREA_BOOTLOADER,
-    .fa_device_id = FLASH_DEVICE_MRAM,
-    .fa_off = MRAM_BASE + BOOTLOADER_START_ADDRESS,
-    .fa_size = BOOT_BOOTLOADER_SIZE
-};
+#if (MCUBOOT_LOGICAL_SECTOR_SIZE % MRAM_SECTOR_SIZE) != 0
+#error "MCUBOOT_LOGICAL_SECTOR_SIZE must be a multiple of the MRAM sector size"
+#endif
 
-static struct flash_area primary_1 =
-{
-    .fa_id = FLASH_AREA_IMAGE_PRIMARY(0),
-    .fa_device_id = FLASH_DEVICE_MRAM,
-    .fa_off = MRAM_BASE +\
-                BOOTLOADER_START_ADDRESS +\
-                BOOT_BOOTLOADER_SIZE,
-    .fa_size = BOOT_PRIMARY_1_SIZE
-};
+/* With MCUBOOT_SWAP_USING_OFFSET, the secondary slots are one sector larger
+ * than the primary slots and set the number of sectors needed. */
+#define SLOT_FITS(size) ((size) <= MCUBOOT_MAX_IMG_SECTORS * MCUBOOT_LOGICAL_SECTOR_SIZE)
+
+_Static_assert(SLOT_FITS(BOOT_PRIMARY_1_SIZE),
+               "Primary slot needs more than MCUBOOT_MAX_IMG_SECTORS sectors");
+_Static_assert(SLOT_FITS(BOOT_SECONDARY_1_SIZE),
+               "Secondary slot needs more than MCUBOOT_MAX_IMG_SECTORS sectors");
+#if (MCUBOOT_IMAGE_NUMBER == 2)
+_Static_assert(SLOT_FITS(BOOT_PRIMARY_2_SIZE),
+               "Primary slot of image 1 needs more than MCUBOOT_MAX_IMG_SECTORS sectors");
+_Static_assert(SLOT_FITS(BOOT_SECONDARY_2_SIZE),
+               "Secondary slot of image 1 needs more than MCUBOOT_MAX_IMG_SECTORS sectors");
+#endif
 
-static struct flash_area secondary_1 =
-{
-    .fa_id = FLASH_AREA_IMAGE_SECONDARY(0),
-    .fa_device_id = FLASH_DEVICE_MRAM,
-    .fa_off = MRAM_BASE +\
-                BOOTLOADER_START_ADDRESS +\
-                BOOT_BOOTLOADER_SIZE +\
-                BOOT_PRIMARY_1_SIZE,
-    .fa_size = BOOT_SECONDARY_1_SIZE
-};
+#define MRAM_AREA(id, off, size)                \
+    [id] = {                                    \
+        .fa_id = (id),                          \
+        .fa_device_id = FLASH_DEVICE_MRAM,      \
+        .fa_off = MRAM_BASE + (off),            \
+        .fa_size = (size)                       \
+    }
 
-#ifdef MCUBOOT_SWAP_USING_SCRATCH
-static struct flash_area scratch =
+/* Flash map, indexed by flash area ID. Areas not present in the current
+ * configuration are left zero sized. */
+static struct flash_area flash_areas[FLASH_AREA_COUNT] =
 {
-    .fa_id = FLASH_AREA_IMAGE_SCRATCH,
-    .fa_device_id = FLASH_DEVICE_MRAM,
-    .fa_off = MRAM_BASE +\
-               BOOTLOADER_START_ADDRESS +\
-               BOOT_BOOTLOADER_SIZE +\
-               BOOT_PRIMARY_1_SIZE +\
-               BOOT_SECONDARY_1_SIZE,
-    .fa_size = BOOT_SCRATCH_SIZE
-};
+    MRAM_AREA(FLASH_AREA_BOOTLOADER, BOOTLOADER_START_ADDRESS,
+              BOOT_BOOTLOADER_SIZE),
+    MRAM_AREA(FLASH_AREA_IMAGE_0_PRIMARY, BOOT_PRIMARY_1_OFFSET,
+              BOOT_PRIMARY_1_SIZE),
+    MRAM_AREA(FLASH_AREA_IMAGE_0_SECONDARY, BOOT_SECONDARY_1_OFFSET,
+              BOOT_SECONDARY_1_SIZE),
+#ifdef MCUBOOT_SWAP_USING_SCRATCH
+    MRAM_AREA(FLASH_AREA_IMAGE_SCRATCH, BOOT_SCRATCH_OFFSET,
+              BOOT_SCRATCH_SIZE),
 #endif
+#if (MCUBOOT_IMAGE_NUMBER == 2)
+    MRAM_AREA(FLASH_AREA_IMAGE_1_PRIMARY, BOOT_PRIMARY_2_OFFSET,
+              BOOT_PRIMARY_2_SIZE),
+    MRAM_AREA(FLASH_AREA_IMAGE_1_SECONDARY, BOOT_SECONDARY_2_OFFSET,
+              BOOT_SECONDARY_2_SIZE),
+#endif
+};
 
-struct flash_area *boot_area_descs[] =
+/* Image index and slot of the image slot areas, indexed by flash area ID.
+ * The slot is FLASH_SLOT_DOES_NOT_EXIST for the other areas. */
+static const struct
 {
-    &bootloader,
-    &primary_1,
-    &secondary_1,
-#ifdef MCUBOOT_SWAP_USING_SCRATCH
-    &scratch,
-#endif
-    NULL
+    uint8_t image;
+    uint8_t slot;
+} area_slots[FLASH_AREA_COUNT] =
+{
+    [FLASH_AREA_BOOTLOADER]        = { 0, FLASH_SLOT_DOES_NOT_EXIST },
+    [FLASH_AREA_IMAGE_0_PRIMARY]   = { 0, 0 },
+    [FLASH_AREA_IMAGE_0_SECONDARY] = { 0, 1 },
+    [FLASH_AREA_IMAGE_SCRATCH]     = { 0, FLASH_SLOT_DOES_NOT_EXIST },
+    [FLASH_AREA_IMAGE_1_PRIMARY]   = { 1, 0 },
+    [FLASH_AREA_IMAGE_1_SECONDARY] = { 1, 1 },
 };
 
 /**
@@ -111,6 +122,36 @@ static void mram_write_128bit(void *dst, const void *src)
     }
 }
 
+static struct mram_line_stats line_stats;
+
+/**
+  \fn          static void mram_program_line(void *dst, const void *src)
+  \brief       Program one 128bit MRAM line, unless it already holds the data
+  \param[in]   dst  Destination MRAM address, 16-byte aligned
+  \param[in]   src  Source buffer address
+  \return      None
+*/
+static void mram_program_line(void *dst, const void *src)
+{
+#ifdef MCUBOOT_MRAM_SKIP_UNCHANGED_LINES
+    uint64_t line[2];
+
+    /* read back the line with aligned accesses, the slot may be mapped
+     * as device memory */
+    line[0] = ((volatile uint64_t *)dst)[0];
+    line[1] = ((volatile uint64_t *)dst)[1];
+
+    if (memcmp(line, src, MRAM_WRITE_SIZE) == 0)
+    {
+        line_stats.skipped++;
+        return;
+    }
+#endif
+
+    mram_write_128bit(dst, src);
+    line_stats.programmed++;
+}
+
 /**
   \fn          static struct flash_area *get_flash_area_from_id(uint8_t id)
   \brief       Retrieve the flash area from the flash map for the given id
@@ -119,20 +160,12 @@ static void mram_write_128bit(void *dst, const void *src)
 */
 static struct flash_area *get_flash_area_from_id(uint8_t id)
 {
-    struct flash_area *area = NULL;
-    uint32_t i = 0;
-
-    while (boot_area_descs[i] != NULL)
+    if (id >= FLASH_AREA_COUNT || flash_areas[id].fa_size == 0)
     {
-        if (boot_area_descs[i]->fa_id == id)
-        {
-            area = boot_area_descs[i];
-            break;
-        }
-        i++;
+        return NULL;
     }
 
-    return area;
+    return &flash_areas[id];
 }
 
 /**
@@ -183,6 +216,30 @@ int flash_area_read(const struct flash_area *fa, uint32_t off,
     return 0;
 }
 
+/**
+  \fn          int flash_area_get_ptr(const struct flash_area *fa, uint32_t off,
+                    uint32_t len, const void **ptr)
+  \brief       Get the address at which a range of a flash area can be read in place
+  \param[in]   fa Flash area
+  \param[in]   off Offset from the beginning of the flash area.
+  \param[in]   len Number of bytes to be accessed.
+  \param[out]  ptr Address of the first byte of the range.
+  \return      zero on success, negative in case of an error
+*/
+int flash_area_get_ptr(const struct flash_area *fa, uint32_t off,
+                       uint32_t len, const void **ptr)
+{
+    if (off > fa->fa_size || len > fa->fa_size - off)
+    {
+        return -1;
+    }
+
+    /* MRAM is memory mapped, no copy is needed */
+    *ptr = (const void *) (fa->fa_off + off);
+
+    return 0;
+}
+
 /**
   \fn          int flash_area_write(const struct flash_area *fa, uint32_t off,
                     void *src, uint32_t len)
@@ -223,7 +280,7 @@ int flash_area_write(const struct flash_area *fa, uint32_t off,
         memcpy((uint8_t*)temp_buf + offset, data, unaligned_bytes);
 
         // write back to MRAM
-        mram_write_128bit(ptr, temp_buf);
+        mram_program_line(ptr, temp_buf);
 
         data += unaligned_bytes;
         len -= unaligned_bytes;
@@ -232,7 +289,7 @@ int flash_area_write(const struct flash_area *fa, uint32_t off,
 
     // write aligned bytes
     while(len / MRAM_WRITE_SIZE) {
-        mram_write_128bit((void*)addr, data);
+        mram_program_line((void*)addr, data);
         len -= MRAM_WRITE_SIZE;
         data += MRAM_WRITE_SIZE;
         addr += MRAM_WRITE_SIZE;
@@ -250,7 +307,7 @@ int flash_area_write(const struct flash_area *fa, uint32_t off,
         memcpy(temp_buf, data, len);
 
         // write back to MRAM
-        mram_write_128bit((void*)addr, temp_buf);
+        mram_program_line((void*)addr, temp_buf);
     }
     return 0;
 }
@@ -280,12 +337,34 @@ int flash_area_erase(const struct flash_area *fa,
 
     for (i = 0; i < len; i += MRAM_WRITE_SIZE)
     {
-        mram_write_128bit((void *) (addr + i), src);
+        mram_program_line((void *) (addr + i), src);
     }
 
     return 0;
 }
 
+/**
+  \fn          void flash_area_get_line_stats(struct mram_line_stats *stats)
+  \brief       Retrieve the MRAM line programming counters
+  \param[out]  stats Buffer for the counters
+  \return      None
+*/
+void flash_area_get_line_stats(struct mram_line_stats *stats)
+{
+    *stats = line_stats;
+}
+
+/**
+  \fn          void flash_area_reset_line_stats(void)
+  \brief       Clear the MRAM line programming counters
+  \return      None
+*/
+void flash_area_reset_line_stats(void)
+{
+    line_stats.programmed = 0;
+    line_stats.skipped = 0;
+}
+
 /**
   \fn          uint32_t flash_area_align(const struct flash_area *fa)
   \brief       Get the write block size of a flash area
@@ -312,6 +391,19 @@ uint8_t flash_area_erased_val(const struct flash_area *area)
     return MRAM_ERASE_VALUE;
 }
 
+/**
+  \fn          bool flash_area_erase_required(const struct flash_area *area)
+  \brief       Check whether a flash area has to be erased before it is written
+  \param[in]   fa Flash area
+  \return      false, MRAM lines can be programmed directly with new data
+*/
+bool flash_area_erase_required(const struct flash_area *area)
+{
+    (void) area;
+
+    return false;
+}
+
 #ifdef MCUBOOT_USE_FLASH_AREA_GET_SECTORS
 /**
   \fn          int flash_area_get_sectors(int fa_id, uint32_t *count,
@@ -333,12 +425,23 @@ int flash_area_get_sectors(int fa_id, uint32_t *count,
         return -1;
     }
 
-    size_t sector_size = MRAM_SECTOR_SIZE;
+    /* MRAM has no physical erase block, report logical sectors so large
+     * slots can be described with few entries. */
+    size_t sector_size = MCUBOOT_LOGICAL_SECTOR_SIZE;
     uint32_t total_count = 0;
 
     for (uint32_t off = 0; off < fa->fa_size; off += sector_size)
     {
+        if (total_count >= *count)
+        {
+            return -1;
+        }
+
         sectors[total_count].fs_size = sector_size;
+        if (fa->fa_size - off < sector_size)
+        {
+            sectors[total_count].fs_size = fa->fa_size - off;
+        }
         sectors[total_count].fs_off  = off;
         total_count++;
     }
@@ -361,10 +464,17 @@ int flash_area_get_sectors(int fa_id, uint32_t *count,
 int flash_area_get_sector(const struct flash_area *area, uint32_t off,
                           struct flash_sector *sector)
 {
-    (void) area;
+    if (off >= area->fa_size)
+    {
+        return -1;
+    }
 
-    sector->fs_off = (off / MRAM_SECTOR_SIZE) * MRAM_SECTOR_SIZE;
-    sector->fs_size = MRAM_SECTOR_SIZE;
+    sector->fs_off = (off / MCUBOOT_LOGICAL_SECTOR_SIZE) * MCUBOOT_LOGICAL_SECTOR_SIZE;
+    sector->fs_size = MCUBOOT_LOGICAL_SECTOR_SIZE;
+    if (area->fa_size - sector->fs_off < sector->fs_size)
+    {
+        sector->fs_size = area->fa_size - sector->fs_off;
+    }
 
     return 0;
 }
@@ -397,3 +507,33 @@ int flash_area_id_from_image_slot(int slot)
 {
     return flash_area_id_from_multi_image_slot(0, slot);
 }
+
+/**
+  \fn          int flash_area_id_to_multi_image_slot(int image_index, int area_id)
+  \brief       Return the slot of a given image a flash area holds
+  \param[in]   image_index The image index
+  \param[in]   area_id ID of the flash area
+  \return      The slot, or negative if the area is not a slot of the image
+*/
+int flash_area_id_to_multi_image_slot(int image_index, int area_id)
+{
+    if (area_id < 0 || area_id >= FLASH_AREA_COUNT ||
+        area_slots[area_id].slot == FLASH_SLOT_DOES_NOT_EXIST ||
+        area_slots[area_id].image != image_index)
+    {
+        return -1;
+    }
+
+    return area_slots[area_id].slot;
+}
+
+/**
+  \fn          int flash_area_id_to_image_slot(int area_id)
+  \brief       Return the slot of the first image a flash area holds
+  \param[in]   area_id ID of the flash area
+  \return      The slot, or negative if the area is not a slot of the image
+*/
+int flash_area_id_to_image_slot(int area_id)
+{
+    return flash_area_id_to_multi_image_slot(0, area_id);
+}
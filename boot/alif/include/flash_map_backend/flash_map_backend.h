@@ -10,6 +10,7 @@
 #ifndef _FLASH_MAP_BACKEND_H_
 #define _FLASH_MAP_BACKEND_H_
 #include <inttypes.h>
+#include <stdbool.h>
 
 /** \brief Representation of a flash area */
 struct flash_area {
@@ -26,6 +27,12 @@ struct flash_sector {
   uint32_t fs_size; /**< Size of this sector, in bytes. */
 };
 
+/** \brief MRAM line programming counters */
+struct mram_line_stats {
+  uint32_t programmed;  /**< Number of 128bit lines programmed */
+  uint32_t skipped;     /**< Number of lines left untouched as they already held the data */
+};
+
 /**
   \fn          static inline uint8_t flash_area_get_device_id(const struct flash_area *fa)
   \brief       Return the ID of the device in which a given flash area resides on.
@@ -122,6 +129,19 @@ void flash_area_close(const struct flash_area *fa);
 int flash_area_read(const struct flash_area *fa, uint32_t off,
                     void *dst, uint32_t len);
 
+/**
+  \fn          int flash_area_get_ptr(const struct flash_area *fa, uint32_t off,
+                    uint32_t len, const void **ptr)
+  \brief       Get the address at which a range of a flash area can be read in place
+  \param[in]   fa Flash area
+  \param[in]   off Offset from the beginning of the flash area.
+  \param[in]   len Number of bytes to be accessed.
+  \param[out]  ptr Address of the first byte of the range.
+  \return      zero on success, negative in case of an error
+*/
+int flash_area_get_ptr(const struct flash_area *fa, uint32_t off,
+                       uint32_t len, const void **ptr);
+
 /**
   \fn          int flash_area_write(const struct flash_area *fa, uint32_t off,
                     void *src, uint32_t len)
@@ -145,6 +165,21 @@ int flash_area_write(const struct flash_area *fa, uint32_t off,
 */
 int flash_area_erase(const struct flash_area *fa,
                      uint32_t off, uint32_t len);
+/**
+  \fn          void flash_area_get_line_stats(struct mram_line_stats *stats)
+  \brief       Retrieve the MRAM line programming counters
+  \param[out]  stats Buffer for the counters
+  \return      None
+*/
+void flash_area_get_line_stats(struct mram_line_stats *stats);
+
+/**
+  \fn          void flash_area_reset_line_stats(void)
+  \brief       Clear the MRAM line programming counters
+  \return      None
+*/
+void flash_area_reset_line_stats(void);
+
 /**
   \fn          uint32_t flash_area_align(const struct flash_area *fa)
   \brief       Get the write block size of a flash area
@@ -161,6 +196,14 @@ uint32_t flash_area_align(const struct flash_area *area);
 */
 uint8_t flash_area_erased_val(const struct flash_area *area);
 
+/**
+  \fn          bool flash_area_erase_required(const struct flash_area *area)
+  \brief       Check whether a flash area has to be erased before it is written
+  \param[in]   fa Flash area
+  \return      true if data must be erased before being overwritten, false otherwise
+*/
+bool flash_area_erase_required(const struct flash_area *area);
+
 /**
   \fn          int flash_area_get_sectors(int fa_id, uint32_t *count,
                     struct flash_sector *sectors)
@@ -202,4 +245,21 @@ int flash_area_id_from_multi_image_slot(int image_index, int slot);
   \return      Flash area id or negative if the requested slot is invalid
 */
 int flash_area_id_from_image_slot(int slot);
+
+/**
+  \fn          int flash_area_id_to_multi_image_slot(int image_index, int area_id)
+  \brief       Return the slot of a given image a flash area holds
+  \param[in]   image_index The image index
+  \param[in]   area_id ID of the flash area
+  \return      The slot, or negative if the area is not a slot of the image
+*/
+int flash_area_id_to_multi_image_slot(int image_index, int area_id);
+
+/**
+  \fn          int flash_area_id_to_image_slot(int area_id)
+  \brief       Return the slot of the first image a flash area holds
+  \param[in]   area_id ID of the flash area
+  \return      The slot, or negative if the area is not a slot of the image
+*/
+int flash_area_id_to_image_slot(int area_id);
 #endif /* _FLASH_MAP_BACKEND_H_ */
@@ -25,6 +25,13 @@
 /* Uncomment for ECDSA signatures using curve P-256. */
 /* #define MCUBOOT_SIGN_EC256 */
 
+/* Uncomment to match the KEYHASH TLV against the key digests in keys.c
+ * (imgtool getpub --with-hash) instead of hashing every key on each boot. */
+#define MCUBOOT_KEY_HASH_TABLE
+
+/* Uncomment to verify RSA signatures against the pre-decoded key in keys.c
+ * (imgtool getpub --rsa-preparsed) instead of parsing it with Mbed TLS. */
+#define MCUBOOT_RSA_PREPARSED_KEYS
 
 /*
  * Upgrade mode
@@ -46,8 +53,40 @@
 /* Uncomment to only erase and overwrite those primary slot sectors needed
  * to install the new image, rather than the entire image slot. */
  #define MCUBOOT_OVERWRITE_ONLY_FAST
+/* Uncomment to hash the image while it is copied into the primary slot, so
+ * validating the primary slot after an upgrade does not read it again. Has
+ * no effect without MCUBOOT_VALIDATE_PRIMARY_SLOT. */
+ #define MCUBOOT_HASH_ON_COPY
+/* Uncomment to record the progress of the copy in the primary slot trailer,
+ * so that an upgrade interrupted by a reset resumes where it stopped. The
+ * image must then end before the sectors holding the trailer, whose status
+ * area is MCUBOOT_MAX_IMG_SECTORS * 3 MRAM lines. */
+/* #define MCUBOOT_OVERWRITE_ONLY_RESUME */
+/* Uncomment to compare each primary slot sector with the image before
+ * copying it, and leave the sectors that already hold it alone. Unchanged
+ * MRAM lines are skipped by MCUBOOT_MRAM_SKIP_UNCHANGED_LINES anyway, so
+ * this only saves the write calls. */
+/* #define MCUBOOT_OVERWRITE_ONLY_DIFF */
+/* Uncomment to accept delta images, made by imgtool with --delta-base, in
+ * the secondary slot. The patch is applied window by window in place, with
+ * the progress recorded as for MCUBOOT_OVERWRITE_ONLY_RESUME, so the images
+ * must also end before the sectors holding the trailer. */
+/* #define MCUBOOT_DELTA_UPGRADE */
+/* Uncomment to accept images compressed by imgtool with --compression lz4
+ * in the secondary slot. They are decompressed into the primary slot
+ * through a RAM window of MCUBOOT_DECOMPRESS_WINDOW_SIZE bytes, 4096 by
+ * default, which must be at least the window they were compressed with. */
+/* #define MCUBOOT_DECOMPRESS_IMAGES */
 #endif
 
+/* Uncomment, instead of MCUBOOT_OVERWRITE_ONLY, to swap the images in a
+ * single pass without a scratch area. The update image is then stored one
+ * sector into the secondary slot, so BOOT_SECONDARY_<n>_SIZE should be one
+ * sector larger than BOOT_PRIMARY_<n>_SIZE. The larger slot must still fit
+ * in MCUBOOT_MAX_IMG_SECTORS sectors, which defaults to one more sector
+ * than otherwise for that. */
+/* #define MCUBOOT_SWAP_USING_OFFSET */
+
 /* Uncomment to enable the direct-xip code path. */
 /* #define MCUBOOT_DIRECT_XIP */
 /* Uncomment to enable the revert mechanism in direct-xip mode. */
@@ -77,6 +116,23 @@
  */
 #define MCUBOOT_VALIDATE_PRIMARY_SLOT
 
+/*
+ * Uncomment to remember the last successful validation of the image in the
+ * primary slot, so that following boots of the same image only check a MAC
+ * over its header, size, security counter and hash instead of hashing the
+ * whole image. The platform must provide the functions declared in
+ * bootutil/validation_cache.h.
+ */
+/* #define MCUBOOT_VALIDATION_CACHE */
+
+/*
+ * Uncomment to record the type, offset and length of every TLV of a slot in a
+ * single pass, the first time the slot's TLVs are looked at during a boot.
+ * Later lookups use the index instead of walking the TLV area again.
+ * MCUBOOT_TLV_INDEX_MAX_TLVS sets the number of TLVs an index can hold.
+ */
+#define MCUBOOT_TLV_INDEX
+
 /*
  * Flash abstraction
  */
@@ -85,13 +141,56 @@
  * See the flash APIs for more details. */
 #define MCUBOOT_USE_FLASH_AREA_GET_SECTORS
 
+/* Uncomment if the flash device can be programmed without erasing it first.
+ * Erase passes that only prepare a region for being rewritten are skipped
+ * and only the trailer and image magic are explicitly set to the erased
+ * value. The flash map API must provide flash_area_erase_required(). */
+#define MCUBOOT_SUPPORT_DEV_WITHOUT_ERASE
+
+/* Uncomment to read back each 128bit MRAM line before programming it and
+ * skip the program cycle when the line already holds the data. This saves
+ * update time and cell wear when only a part of the image changes. The lines
+ * programmed and skipped are logged with MCUBOOT_BOOT_TIME_MEASUREMENT. */
+#define MCUBOOT_MRAM_SKIP_UNCHANGED_LINES
+
+/* Uncomment to map the image slots as Normal write-through read-allocate
+ * memory while the images are validated and copied. The slots are set back
+ * to Device nGnRE before jumping to the image. Measure the boot time with
+ * and without it first, see MCUBOOT_BOOT_TIME_MEASUREMENT. */
+/* #define MCUBOOT_CACHED_SLOTS_DURING_BOOT */
+
+/* Uncomment if your flash map API supports flash_area_get_ptr(), i.e. the
+ * flash is memory mapped and can be read in place. Image hashing and TLV
+ * parsing then read the slots directly instead of copying them through a
+ * buffer. The slots must be mapped as Normal memory, since the crypto code
+ * performs unaligned accesses. */
+#ifdef MCUBOOT_CACHED_SLOTS_DURING_BOOT
+#define MCUBOOT_FLASH_AREA_DIRECT_ACCESS
+#endif
+
 /* Default maximum number of flash sectors per image slot; change
- * as desirable. */
+ * as desirable. With MCUBOOT_SWAP_USING_OFFSET the secondary slot holds
+ * the sectors of the primary slot and one more. */
+#ifdef MCUBOOT_SWAP_USING_OFFSET
+#define MCUBOOT_MAX_IMG_SECTORS 65
+#else
 #define MCUBOOT_MAX_IMG_SECTORS 64
+#endif
+
+/* Size of the sectors reported by flash_area_get_sectors(). MRAM has no
+ * physical erase block, so any multiple of the 1 KiB MRAM sector can be
+ * used. Larger sectors let a slot of up to MCUBOOT_MAX_IMG_SECTORS sectors
+ * grow accordingly, without growing the sector arrays or the trailer. */
+#ifndef MCUBOOT_LOGICAL_SECTOR_SIZE
+#define MCUBOOT_LOGICAL_SECTOR_SIZE 0x400
+#endif
 
 /* Default number of separately updateable images; change in case of
- * multiple images. */
+ * multiple images. Up to two images are supported, for instance one for
+ * each of the M55-HP and M55-HE cores. */
+#ifndef MCUBOOT_IMAGE_NUMBER
 #define MCUBOOT_IMAGE_NUMBER 	1
+#endif
 
 /*
  * Logging
@@ -117,6 +216,22 @@
  *    MCUBOOT_LOG_ERR > MCUBOOT_LOG_WRN > MCUBOOT_LOG_INF > MCUBOOT_LOG_DBG
  */
 #define MCUBOOT_HAVE_LOGGING 1
+
+/* Uncomment to log the number of cycles spent in boot_go(), e.g. to compare
+ * the validation time with and without MCUBOOT_CACHED_SLOTS_DURING_BOOT. */
+/* #define MCUBOOT_BOOT_TIME_MEASUREMENT */
+
+/* Uncomment to record the start and end of the boot phases (header reads,
+ * slot validation, image hashing, signature checks, swap steps and region
+ * copies) with their DWT cycle count, and log them at the end of boot_go().
+ * MCUBOOT_BOOT_TIMELINE_SIZE sets the number of markers kept. */
+/* #define MCUBOOT_USE_BENCH */
+/* #define MCUBOOT_BOOT_TIMELINE */
+
+/* Uncomment to count the flash reads, writes and erases of each flash area,
+ * with histograms of their sizes and alignments, and log them at the end of
+ * boot_go(). With MCUBOOT_USE_BENCH the time spent in them is counted too. */
+/* #define MCUBOOT_FLASH_STATS */
 #define MCUBOOT_LOG_LEVEL MCUBOOT_LOG_LEVEL_DEBUG
 
 #define CONFIG_MCUBOOT 1
@@ -0,0 +1,35 @@
+/* Copyright (C) 2024 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ *
+ */
+
+#ifndef H_ALIF_BENCH_H__
+#define H_ALIF_BENCH_H__
+
+#include <inttypes.h>
+#include <stdint.h>
+#include "bootutil/bootutil_log.h"
+
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+/* The DWT cycle counter, started by main() before boot_go(). */
+typedef uint32_t bench_state_t;
+
+#define plat_bench_cycles() (DWT->CYCCNT)
+
+#define plat_bench_start(_s) do { \
+    *(_s) = plat_bench_cycles(); \
+} while (0)
+
+#define plat_bench_stop(_s) do { \
+    uint32_t _stop_time = plat_bench_cycles(); \
+    BOOT_LOG_INF("bench: %" PRIu32 " cycles", _stop_time - *(_s)); \
+} while (0)
+
+#endif /* not H_ALIF_BENCH_H__ */
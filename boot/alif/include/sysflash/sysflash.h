@@ -20,6 +20,15 @@
 #define FLASH_AREA_IMAGE_0_PRIMARY          1
 #define FLASH_AREA_IMAGE_0_SECONDARY        2
 #define FLASH_AREA_IMAGE_SCRATCH            3
+#define FLASH_AREA_IMAGE_1_PRIMARY          4
+#define FLASH_AREA_IMAGE_1_SECONDARY        5
+
+/* Number of flash area IDs, the IDs are used as indices into the flash map */
+#define FLASH_AREA_COUNT                    6
+
+#if (MCUBOOT_IMAGE_NUMBER > 2)
+#error "The Alif flash map supports up to two images"
+#endif
 
 #ifndef BOOTLOADER_START_ADDRESS
 #define BOOTLOADER_START_ADDRESS            (0x0)
@@ -37,15 +46,54 @@
 #define BOOT_SECONDARY_1_SIZE               (0x10000)
 #endif
 
+#ifndef BOOT_PRIMARY_2_SIZE
+#define BOOT_PRIMARY_2_SIZE                 (0x10000)
+#endif
+
+#ifndef BOOT_SECONDARY_2_SIZE
+#define BOOT_SECONDARY_2_SIZE               (0x10000)
+#endif
+
 #ifndef BOOT_SCRATCH_SIZE
 #define BOOT_SCRATCH_SIZE                   (0x1000)
 #endif
 
+/* Offsets of the areas in MRAM. The slots of the second image, used for
+ * instance to run separate images on the M55-HP and M55-HE cores, follow
+ * the slots of the first one, the scratch area comes last. */
+#define BOOT_PRIMARY_1_OFFSET               (BOOTLOADER_START_ADDRESS + \
+                                             BOOT_BOOTLOADER_SIZE)
+#define BOOT_SECONDARY_1_OFFSET             (BOOT_PRIMARY_1_OFFSET + \
+                                             BOOT_PRIMARY_1_SIZE)
+#define BOOT_PRIMARY_2_OFFSET               (BOOT_SECONDARY_1_OFFSET + \
+                                             BOOT_SECONDARY_1_SIZE)
+#define BOOT_SECONDARY_2_OFFSET             (BOOT_PRIMARY_2_OFFSET + \
+                                             BOOT_PRIMARY_2_SIZE)
+
+#if (MCUBOOT_IMAGE_NUMBER == 2)
+#define BOOT_SCRATCH_OFFSET                 (BOOT_SECONDARY_2_OFFSET + \
+                                             BOOT_SECONDARY_2_SIZE)
+#else
+#define BOOT_SCRATCH_OFFSET                 (BOOT_PRIMARY_2_OFFSET)
+#endif
 
+#if (MCUBOOT_IMAGE_NUMBER == 2)
+#define FLASH_AREA_IMAGE_PRIMARY(x)    (((x) == 0) ?          \
+                                         FLASH_AREA_IMAGE_0_PRIMARY : \
+                                        ((x) == 1) ?          \
+                                         FLASH_AREA_IMAGE_1_PRIMARY : \
+                                         FLASH_SLOT_DOES_NOT_EXIST)
+#define FLASH_AREA_IMAGE_SECONDARY(x)  (((x) == 0) ?          \
+                                         FLASH_AREA_IMAGE_0_SECONDARY : \
+                                        ((x) == 1) ?          \
+                                         FLASH_AREA_IMAGE_1_SECONDARY : \
+                                         FLASH_SLOT_DOES_NOT_EXIST)
+#else
 #define FLASH_AREA_IMAGE_PRIMARY(x)    (((x) == 0) ?          \
                                          FLASH_AREA_IMAGE_0_PRIMARY : \
                                          FLASH_SLOT_DOES_NOT_EXIST)
 #define FLASH_AREA_IMAGE_SECONDARY(x)  (((x) == 0) ?          \
                                          FLASH_AREA_IMAGE_0_SECONDARY : \
                                          FLASH_SLOT_DOES_NOT_EXIST)
+#endif
 #endif /* _SYSFLASH_H_ */
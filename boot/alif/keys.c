@@ -40,11 +40,66 @@ const unsigned char rsa_pub_key[] = {
     0xc9, 0x02, 0x03, 0x01, 0x00, 0x01,
 };
 const unsigned int rsa_pub_key_len = 270;
+const unsigned char rsa_pub_key_hash[] = {
+    0xfc, 0x57, 0x01, 0xdc, 0x61, 0x35, 0xe1, 0x32,
+    0x38, 0x47, 0xbd, 0xc4, 0x0f, 0x04, 0xd2, 0xe5,
+    0xbe, 0xe5, 0x83, 0x3b, 0x23, 0xc2, 0x9f, 0x93,
+    0x59, 0x3d, 0x00, 0x01, 0x8c, 0xfa, 0x99, 0x94,
+};
+const unsigned int rsa_pub_key_hash_len = 32;
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+const struct bootutil_rsa_pub_key rsa_pub_key_preparsed = {
+    .n0inv = 0x80aee787,
+    .n = {
+        0x62e1d1c9, 0xefb14b2c, 0xd167c647, 0xaf5c3aa7,
+        0xfa0d119d, 0x666435ec, 0xdcce681b, 0x59f81cab,
+        0xf81a2466, 0x1a1dfee8, 0xab873e93, 0x692723f3,
+        0x8217f28a, 0x31ad5fb0, 0x4cc88881, 0x5818f65e,
+        0x2bd0d308, 0x54f43ee1, 0xe0fa8237, 0x2abeafb8,
+        0xfeb8cefa, 0xa76a9df9, 0xa3aed20f, 0x1339833f,
+        0xffb7fdf3, 0xe4530d2f, 0x85d55c4a, 0x3ec80ed7,
+        0xf8656e64, 0x896924fb, 0xbe7b7221, 0xdb7773d4,
+        0x7eb7e115, 0x35ca6261, 0x4baa8d38, 0xc3776754,
+        0x7e473c94, 0xb4a9c888, 0x6fe75bba, 0xf8cf3d1e,
+        0x5c14dff2, 0xac414d9e, 0x698c2f5f, 0xb43c10e6,
+        0x2849a701, 0x4160ed15, 0x840baa77, 0x99dfe04d,
+        0x5ceeecb3, 0x080f0dbb, 0x2c44d167, 0x435e0d57,
+        0x7f10537e, 0xdb42e78c, 0xcbf3bc74, 0xf09c341b,
+        0x188019f9, 0xd35ae96d, 0xaad24b18, 0xbbee5ef9,
+        0x0da34f1f, 0xe8fbfdf7, 0x18442c18, 0xd106081a,
+    },
+    .rr = {
+        0xa46d7e40, 0x61d887b3, 0x1af6c61d, 0xa0bf6f48,
+        0xb8cec2e8, 0x6f6895e7, 0x723eaea3, 0x9f4cf49b,
+        0xc1648e24, 0x4933b156, 0xb620cc9e, 0x6a3d596a,
+        0xd7607b1c, 0xb9c7f122, 0x05a7314e, 0xfabdabfa,
+        0xb7ee0465, 0x9d9422c6, 0x7760b779, 0x7ef32296,
+        0xc25d8581, 0xa71a32cb, 0xfa31586c, 0xed49b341,
+        0x5249dd8c, 0xdae158dc, 0x936a5cd7, 0x2fb58c91,
+        0x1f617238, 0xf4c40bbe, 0xfc9ef774, 0xbb62bd84,
+        0xba88107e, 0xef1a0c45, 0x52124603, 0x6557f87a,
+        0x9c26779b, 0x05863028, 0x35875518, 0xf9b8d106,
+        0x51c66c09, 0x7941f544, 0xbcf6f070, 0x39b53706,
+        0x3166a931, 0xc97f93f7, 0x23f7bd3a, 0x5edb8506,
+        0xabe50eda, 0xfc98167d, 0xa4ca5244, 0xf93f6a95,
+        0x447cd5a9, 0x15ef7110, 0xa57c2d5e, 0x2e5d61f4,
+        0x613d3217, 0x4ff52cce, 0xafe3f5e1, 0x696f8e30,
+        0x1ef051f7, 0x006e298c, 0xb97f1d14, 0xa920a3e8,
+    },
+};
+#endif
 
 const struct bootutil_key bootutil_keys[] = {
     {
         .key = rsa_pub_key,
         .len = &rsa_pub_key_len,
+#ifdef MCUBOOT_KEY_HASH_TABLE
+        .hash = rsa_pub_key_hash,
+        .hash_len = &rsa_pub_key_hash_len,
+#endif
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+        .rsa = &rsa_pub_key_preparsed,
+#endif
     },
 };
 const int bootutil_key_cnt = 1;
@@ -9,21 +9,41 @@
  */
 
 #include <bootutil/bootutil.h>
+#include <bootutil/bootutil_log.h>
 #include <sysflash/sysflash.h>
+#include <flash_map_backend/flash_map_backend.h>
 
 #include "RTE_Components.h"
 #include CMSIS_device_header
 
+BOOT_LOG_MODULE_REGISTER(mcuboot);
+
 #define BOOTLOADER_START_ADDR           (MRAM_BASE + BOOTLOADER_START_ADDRESS)
 #define BOOTLOADER_END_ADDR             (BOOTLOADER_START_ADDR + \
                                          BOOT_BOOTLOADER_SIZE - 1)
 
 #define APP_IMAGE_SLOTS_START_ADDR      (BOOTLOADER_START_ADDR + BOOT_BOOTLOADER_SIZE)
-#define APP_IMAGE_SLOTS_END_ADDR        (APP_IMAGE_SLOTS_START_ADDR + \
-                                         BOOT_PRIMARY_1_SIZE + \
-                                         BOOT_SECONDARY_1_SIZE + \
+/* The scratch area comes after the slots of all the images. */
+#define APP_IMAGE_SLOTS_END_ADDR        (MRAM_BASE + BOOT_SCRATCH_OFFSET + \
                                          BOOT_SCRATCH_SIZE - 1)
 
+#define MEMATTRIDX_DEVICE_nGnRE              0
+#define MEMATTRIDX_NORMAL_WT_RA              1
+
+/* MPU region covering the application image slots and scratch area */
+#define MPU_REGION_APP_IMAGE_SLOTS           2
+
+/* MRAM region 2 (Application image slots and scratch area) : RO-0, NP-1, XN-0 */
+#define APP_IMAGE_SLOTS_RBAR            ARM_MPU_RBAR(APP_IMAGE_SLOTS_START_ADDR, \
+                                                     ARM_MPU_SH_NON, 0, 1, 0)
+#define APP_IMAGE_SLOTS_RLAR(attr)      ARM_MPU_RLAR(APP_IMAGE_SLOTS_END_ADDR, attr)
+
+#ifdef MCUBOOT_CACHED_SLOTS_DURING_BOOT
+#define APP_IMAGE_SLOTS_BOOT_ATTR       MEMATTRIDX_NORMAL_WT_RA
+#else
+#define APP_IMAGE_SLOTS_BOOT_ATTR       MEMATTRIDX_DEVICE_nGnRE
+#endif
+
 struct arm_vector_table {
     uint32_t msp;
     uint32_t reset;
@@ -32,12 +52,12 @@ struct arm_vector_table {
 /*
  * Override the weak implementation of MPU_Load_Regions and setup the
  * memory regions accessed by the bootloader and their attributes.
+ *
+ * The image slots are set up with the boot phase attributes, see
+ * set_app_image_slots_attr().
  */
 void MPU_Load_Regions(void)
 {
-#define MEMATTRIDX_DEVICE_nGnRE              0
-#define MEMATTRIDX_NORMAL_WT_RA              1
-
     static const ARM_MPU_Region_t mpu_table[] __STARTUP_RO_DATA_ATTRIBUTE =
     {
         {   /* Host Peripherals - 16MB : RO-0, NP-1, XN-1 */
@@ -48,9 +68,9 @@ void MPU_Load_Regions(void)
             .RBAR = ARM_MPU_RBAR(BOOTLOADER_START_ADDR, ARM_MPU_SH_NON, 1, 1, 0),
             .RLAR = ARM_MPU_RLAR(BOOTLOADER_END_ADDR, MEMATTRIDX_NORMAL_WT_RA)
         },
-        {   /* MRAM region 2 (Application image slots and scratch area) : RO-0, NP-1, XN-0 */
-            .RBAR = ARM_MPU_RBAR(APP_IMAGE_SLOTS_START_ADDR, ARM_MPU_SH_NON, 0, 1, 0),
-            .RLAR = ARM_MPU_RLAR(APP_IMAGE_SLOTS_END_ADDR, MEMATTRIDX_DEVICE_nGnRE)
+        {   /* MRAM region 2 (Application image slots and scratch area) */
+            .RBAR = APP_IMAGE_SLOTS_RBAR,
+            .RLAR = APP_IMAGE_SLOTS_RLAR(APP_IMAGE_SLOTS_BOOT_ATTR)
         },
     };
 
@@ -70,13 +90,87 @@ void MPU_Load_Regions(void)
     ARM_MPU_Load(0, mpu_table, sizeof(mpu_table)/sizeof(ARM_MPU_Region_t));
 }
 
+#ifdef MCUBOOT_CACHED_SLOTS_DURING_BOOT
+/*
+ * Switch the memory attributes of the application image slots. The slots
+ * are read through the cache while the images are validated and copied,
+ * and must be set back to the strict device attributes before jumping to
+ * the image.
+ */
+static void set_app_image_slots_attr(uint8_t attr)
+{
+    __DMB();
+    ARM_MPU_SetRegion(MPU_REGION_APP_IMAGE_SLOTS, APP_IMAGE_SLOTS_RBAR,
+                      APP_IMAGE_SLOTS_RLAR(attr));
+    __DSB();
+    __ISB();
+
+#if defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    /* Do not leave lines of the slots behind for the application.
+     * The region is write-through so there is nothing to clean, but only
+     * its own lines are dropped: invalidating the whole cache would lose
+     * dirty lines of the bootloader's stack and data. */
+    SCB_InvalidateDCache_by_Addr((volatile void *)APP_IMAGE_SLOTS_START_ADDR,
+                                 APP_IMAGE_SLOTS_END_ADDR -
+                                 APP_IMAGE_SLOTS_START_ADDR + 1);
+#endif
+}
+#endif
+
+#if defined(MCUBOOT_BOOT_TIME_MEASUREMENT) || defined(MCUBOOT_BOOT_TIMELINE)
+static void cycle_counter_start(void)
+{
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+#endif
+
+#ifdef MCUBOOT_BOOT_TIME_MEASUREMENT
+static uint32_t cycle_counter_read(void)
+{
+    return DWT->CYCCNT;
+}
+#endif
+
 int main(void)
 {
     struct arm_vector_table *vt;
     struct boot_rsp rsp;
+#ifdef MCUBOOT_BOOT_TIME_MEASUREMENT
+    uint32_t cycles;
+#endif
+#if defined(MCUBOOT_BOOT_TIME_MEASUREMENT) || defined(MCUBOOT_FLASH_STATS)
+    struct mram_line_stats line_stats;
+#endif
+
+#if defined(MCUBOOT_BOOT_TIME_MEASUREMENT) || defined(MCUBOOT_BOOT_TIMELINE)
+    cycle_counter_start();
+#endif
 
     int rv = boot_go(&rsp);
 
+#ifdef MCUBOOT_BOOT_TIME_MEASUREMENT
+    cycles = cycle_counter_read();
+    BOOT_LOG_INF("boot_go: %lu cycles (%lu ms), image slots mapped as %s",
+                 (unsigned long)cycles,
+                 (unsigned long)(cycles / (SystemCoreClock / 1000)),
+                 APP_IMAGE_SLOTS_BOOT_ATTR == MEMATTRIDX_NORMAL_WT_RA ?
+                     "normal WT-RA" : "device nGnRE");
+#endif
+
+#if defined(MCUBOOT_BOOT_TIME_MEASUREMENT) || defined(MCUBOOT_FLASH_STATS)
+    /* Lines left untouched by MCUBOOT_MRAM_SKIP_UNCHANGED_LINES. */
+    flash_area_get_line_stats(&line_stats);
+    BOOT_LOG_INF("MRAM lines: %lu programmed, %lu skipped",
+                 (unsigned long)line_stats.programmed,
+                 (unsigned long)line_stats.skipped);
+#endif
+
+#ifdef MCUBOOT_CACHED_SLOTS_DURING_BOOT
+    set_app_image_slots_attr(MEMATTRIDX_DEVICE_nGnRE);
+#endif
+
     if (rv == 0)
     {
         /* Jump to the starting point of the image */
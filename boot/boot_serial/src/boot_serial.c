@@ -624,6 +624,24 @@ static off_t erase_range(const struct flash_area *fap, off_t start, off_t end)
 }
 #endif
 
+#ifdef MCUBOOT_VALIDATION_CACHE
+/*
+ * Drops the validation cache entry of the image whose primary slot is about
+ * to be written, so the uploaded image is fully validated on the next boot.
+ */
+static void
+bs_validation_cache_invalidate(const struct flash_area *fap)
+{
+    int image_index;
+
+    for (image_index = 0; image_index < BOOT_IMAGE_NUMBER; image_index++) {
+        if (flash_area_get_id(fap) == FLASH_AREA_IMAGE_PRIMARY(image_index)) {
+            boot_validation_cache_invalidate(image_index);
+        }
+    }
+}
+#endif
+
 /*
  * Image upload request.
  */
@@ -746,6 +764,11 @@ bs_upload(char *buf, int len)
 
 #endif
 
+        bootutil_tlv_index_invalidate(fap);
+#ifdef MCUBOOT_VALIDATION_CACHE
+        bs_validation_cache_invalidate(fap);
+#endif
+
 #ifndef MCUBOOT_ERASE_PROGRESSIVELY
         /* Non-progressive erase erases entire image slot when first chunk of
          * an image is received.
@@ -19,6 +19,10 @@
 #ifndef H_BOOTUTIL_BENCH_H__
 #define H_BOOTUTIL_BENCH_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mcuboot_config/mcuboot_config.h"
 #include "ignore.h"
 
 #ifdef MCUBOOT_USE_BENCH
@@ -65,4 +69,81 @@ typedef int bench_state_t;
 
 #endif /* not MCUBOOT_USE_BENCH */
 
+/*
+ * Boot timeline.  With MCUBOOT_BOOT_TIMELINE, the start and end of the
+ * phases below are recorded in a ring buffer of
+ * MCUBOOT_BOOT_TIMELINE_SIZE entries, the oldest being overwritten.  The
+ * timestamps come from `plat_bench_cycles()`, which the platform-specific
+ * benchmark code must provide, returning a free running 32-bit cycle
+ * counter.  The timeline is logged at the end of `boot_go()` and, with
+ * MCUBOOT_DATA_SHARING, passed to the application in the shared data area.
+ */
+enum boot_phase {
+    BOOT_PHASE_READ_HEADERS,    /* boot_read_image_headers() */
+    BOOT_PHASE_VALIDATE_SLOT,   /* boot_validate_slot() */
+    BOOT_PHASE_IMAGE_HASH,      /* Hashing of the image */
+    BOOT_PHASE_SIG_VERIFY,      /* Verification of one signature TLV */
+    BOOT_PHASE_ENC_KEY_LOAD,    /* Decryption of the image key */
+    BOOT_PHASE_SWAP_STEP,       /* Swap or move of one sector (group) */
+    BOOT_PHASE_COPY_REGION,     /* boot_copy_region() */
+    BOOT_PHASE_MAX,
+};
+
+#define BOOT_TIMELINE_BEGIN 0
+#define BOOT_TIMELINE_END   1
+
+/* One marker, as also found in the BLINFO_BOOT_TIMELINE shared data. */
+struct boot_timeline_entry {
+    uint32_t cycles;    /* plat_bench_cycles() when the marker was hit */
+    uint32_t bytes;     /* Bytes processed by the phase, on end markers */
+    uint8_t phase;      /* enum boot_phase */
+    uint8_t event;      /* BOOT_TIMELINE_BEGIN or BOOT_TIMELINE_END */
+    uint16_t reserved;
+};
+
+#ifdef MCUBOOT_BOOT_TIMELINE
+
+#ifndef MCUBOOT_USE_BENCH
+#error "MCUBOOT_BOOT_TIMELINE requires MCUBOOT_USE_BENCH"
+#endif
+
+#ifndef MCUBOOT_BOOT_TIMELINE_SIZE
+#define MCUBOOT_BOOT_TIMELINE_SIZE 32
+#endif
+
+/* Empties the timeline, called when `boot_go()` starts. */
+void boot_timeline_reset(void);
+
+/* Records a marker of `phase`. */
+void boot_timeline_mark(uint8_t phase, uint8_t event, uint32_t bytes);
+
+/*
+ * Copies up to `max` entries of the timeline to `entries`, oldest first.
+ *
+ * @return  The number of entries copied.
+ */
+size_t boot_timeline_read(struct boot_timeline_entry *entries, size_t max);
+
+/* Logs the duration and byte count of every completed phase. */
+void boot_timeline_dump(void);
+
+#define BOOT_PHASE_BEGIN(_phase) \
+    boot_timeline_mark((_phase), BOOT_TIMELINE_BEGIN, 0)
+
+#define BOOT_PHASE_END(_phase, _bytes) \
+    boot_timeline_mark((_phase), BOOT_TIMELINE_END, (uint32_t)(_bytes))
+
+#else /* not MCUBOOT_BOOT_TIMELINE */
+
+#define boot_timeline_reset() do { } while (0)
+#define boot_timeline_dump() do { } while (0)
+
+#define BOOT_PHASE_BEGIN(_phase) do { } while (0)
+
+#define BOOT_PHASE_END(_phase, _bytes) do { \
+    IGNORE(_bytes); \
+} while (0)
+
+#endif /* not MCUBOOT_BOOT_TIMELINE */
+
 #endif /* not H_BOOTUTIL_BENCH_H__ */
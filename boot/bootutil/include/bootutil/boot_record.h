@@ -81,6 +81,15 @@ int boot_save_shared_data(const struct image_header *hdr,
                           const uint8_t active_slot,
                           const int max_app_size);
 
+/**
+ * Add the timeline of the current boot to the shared memory area between
+ * the bootloader and runtime SW, as an array of struct boot_timeline_entry,
+ * oldest first.
+ *
+ * @return                    0 on success; nonzero on failure.
+ */
+int boot_save_boot_timeline(void);
+
 #ifdef __cplusplus
 }
 #endif
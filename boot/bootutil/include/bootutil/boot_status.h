@@ -114,6 +114,7 @@ extern "C" {
 #define BLINFO_RUNNING_SLOT         0x03
 #define BLINFO_BOOTLOADER_VERSION   0x04
 #define BLINFO_MAX_APPLICATION_SIZE 0x05
+#define BLINFO_BOOT_TIMELINE        0x06 /* struct boot_timeline_entry[] */
 
 enum mcuboot_mode {
     MCUBOOT_MODE_SINGLE_SLOT,
@@ -123,7 +124,8 @@ enum mcuboot_mode {
     MCUBOOT_MODE_DIRECT_XIP,
     MCUBOOT_MODE_DIRECT_XIP_WITH_REVERT,
     MCUBOOT_MODE_RAM_LOAD,
-    MCUBOOT_MODE_FIRMWARE_LOADER
+    MCUBOOT_MODE_FIRMWARE_LOADER,
+    MCUBOOT_MODE_SWAP_USING_OFFSET
 };
 
 enum mcuboot_signature_type {
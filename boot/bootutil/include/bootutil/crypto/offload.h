@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Interface to a crypto engine that hashes and decrypts in the background,
+ * enabled with MCUBOOT_CRYPTO_OFFLOAD. The platform provides the functions
+ * declared here; MCUboot submits SHA updates and AES-CTR operations on image
+ * data and keeps reading flash while they are processed.
+ *
+ * The contexts are those of the crypto library selected for MCUboot,
+ * initialised and finalised with the usual `bootutil_sha_*()` and
+ * `bootutil_aes_ctr_*()` calls. An engine that keeps its own state loads
+ * and stores the running state from and to them.
+ *
+ * Jobs are processed in the order they were submitted. Until a job has
+ * completed, its context, counter and buffers belong to the engine and
+ * must not be touched by the caller.
+ */
+
+#ifndef __BOOTUTIL_CRYPTO_OFFLOAD_H_
+#define __BOOTUTIL_CRYPTO_OFFLOAD_H_
+
+#include <stdint.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+#include "bootutil/crypto/sha.h"
+#ifdef MCUBOOT_ENC_IMAGES
+#include "bootutil/crypto/aes_ctr.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct boot_crypto_job;
+
+/*
+ * Called once the job has completed, with 0 on success or nonzero on
+ * failure. May be called from any context, including an interrupt handler
+ * or the submit function itself.
+ */
+typedef void (*boot_crypto_done_t)(struct boot_crypto_job *job, int rc);
+
+struct boot_crypto_job {
+    boot_crypto_done_t done;
+};
+
+/*
+ * Queues hashing `len` bytes at `data` into `ctx`.
+ *
+ * @return 0 if the job was queued, in which case `job->done` is called
+ *         exactly once; nonzero otherwise.
+ */
+int boot_crypto_sha_update_submit(struct boot_crypto_job *job,
+                                  bootutil_sha_context *ctx,
+                                  const void *data, uint32_t len);
+
+#ifdef MCUBOOT_ENC_IMAGES
+/*
+ * Queues AES-CTR processing of `len` bytes from `in` to `out`, which may be
+ * the same buffer. `counter` and `blk_off` are as for
+ * `bootutil_aes_ctr_encrypt()`; `counter` is updated when the job completes.
+ *
+ * @return 0 if the job was queued, in which case `job->done` is called
+ *         exactly once; nonzero otherwise.
+ */
+int boot_crypto_aes_ctr_submit(struct boot_crypto_job *job,
+                               bootutil_aes_ctr_context *ctx,
+                               uint8_t *counter, const uint8_t *in,
+                               uint32_t len, uint32_t blk_off, uint8_t *out);
+#endif
+
+/*
+ * Waits until `job`, and with it every job submitted before it, has
+ * completed and its `done` callback has returned.
+ */
+void boot_crypto_wait(struct boot_crypto_job *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOTUTIL_CRYPTO_OFFLOAD_H_ */
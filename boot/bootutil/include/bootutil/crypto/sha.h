@@ -16,6 +16,10 @@
  * that MCUBOOT_USE_MBED_TLS supports. For this reason, it's allowed to have
  * both of them defined, and for crypto modules that support both abstractions,
  * the MCUBOOT_USE_PSA_CRYPTO will take precedence.
+ *
+ * With MCUBOOT_SIGN_EC384, MCUBOOT_SHA384_USE_TINYCRYPT computes the SHA-384
+ * image hash with ext/tinycrypt-sha512 instead of the PSA Crypto API, which
+ * is still used for the signature itself.
  */
 
 #ifndef __BOOTUTIL_CRYPTO_SHA_H_
@@ -42,11 +46,20 @@
     #define EXPECTED_HASH_TLV IMAGE_TLV_SHA256
 #endif /* MCUBOOT_SIGN_EC384 */
 
+#if defined(MCUBOOT_SHA384_USE_TINYCRYPT) && !defined(MCUBOOT_SIGN_EC384)
+    #error "MCUBOOT_SHA384_USE_TINYCRYPT requires MCUBOOT_SIGN_EC384"
+#endif
+
 /* Universal defines for SHA-256 */
 #define BOOTUTIL_CRYPTO_SHA256_BLOCK_SIZE  (64)
 #define BOOTUTIL_CRYPTO_SHA256_DIGEST_SIZE (32)
 
-#if defined(MCUBOOT_USE_PSA_CRYPTO)
+#if defined(MCUBOOT_SHA384_USE_TINYCRYPT)
+
+#include <tinycrypt/sha512.h>
+#include <tinycrypt/constants.h>
+
+#elif defined(MCUBOOT_USE_PSA_CRYPTO)
 
 #include <psa/crypto.h>
 
@@ -75,7 +88,36 @@
 extern "C" {
 #endif
 
-#if defined(MCUBOOT_USE_PSA_CRYPTO)
+#if defined(MCUBOOT_SHA384_USE_TINYCRYPT)
+
+typedef struct tc_sha512_state_struct bootutil_sha_context;
+
+static inline int bootutil_sha_init(bootutil_sha_context *ctx)
+{
+    tc_sha384_init(ctx);
+    return 0;
+}
+
+static inline int bootutil_sha_drop(bootutil_sha_context *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+
+static inline int bootutil_sha_update(bootutil_sha_context *ctx,
+                                      const void *data,
+                                      uint32_t data_len)
+{
+    return tc_sha512_update(ctx, data, data_len);
+}
+
+static inline int bootutil_sha_finish(bootutil_sha_context *ctx,
+                                      uint8_t *output)
+{
+    return tc_sha384_final(output, ctx);
+}
+
+#elif defined(MCUBOOT_USE_PSA_CRYPTO)
 
 typedef psa_hash_operation_t bootutil_sha_context;
 
@@ -0,0 +1,135 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Flash I/O accounting, enabled with MCUBOOT_FLASH_STATS.
+ *
+ * The flash_area_read(), flash_area_write() and flash_area_erase() calls of
+ * bootutil go through wrappers that count the calls, bytes and errors of
+ * each flash area, and histograms of the request sizes and of the alignment
+ * of the request offsets. With MCUBOOT_USE_BENCH the time spent in each call
+ * is accumulated as well, in plat_bench_cycles() units.
+ *
+ * The wrappers are macros defined by this header, so they work with any
+ * flash map backend. A file that implements the flash_area_*() functions
+ * and includes bootutil_priv.h must define BOOT_FLASH_STATS_NO_WRAP before
+ * including it.
+ *
+ * The counters are reset when boot_go() starts and logged when it ends.
+ */
+
+#ifndef H_BOOTUTIL_FLASH_STATS_H_
+#define H_BOOTUTIL_FLASH_STATS_H_
+
+#include <stdint.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum boot_flash_op {
+    BOOT_FLASH_OP_READ,
+    BOOT_FLASH_OP_WRITE,
+    BOOT_FLASH_OP_ERASE,
+    BOOT_FLASH_OP_MAX,
+};
+
+/*
+ * Histogram buckets. Bucket i of the size histogram counts the requests of
+ * 2^i to 2^(i+1) - 1 bytes, bucket 0 also those of 0 bytes. Bucket i of the
+ * alignment histogram counts the requests whose offset is a multiple of 2^i
+ * but not of 2^(i+1). The last bucket of each holds everything above.
+ */
+#define BOOT_FLASH_STATS_BUCKETS 13
+
+struct boot_flash_op_stats {
+    uint64_t cycles;
+    uint32_t calls;
+    uint32_t errors;
+    uint32_t bytes;
+    uint32_t size_hist[BOOT_FLASH_STATS_BUCKETS];
+    uint32_t align_hist[BOOT_FLASH_STATS_BUCKETS];
+};
+
+struct boot_flash_area_stats {
+    uint8_t fa_id;
+    uint8_t used;
+    struct boot_flash_op_stats ops[BOOT_FLASH_OP_MAX];
+};
+
+#ifdef MCUBOOT_FLASH_STATS
+
+#ifndef MCUBOOT_FLASH_STATS_MAX_AREAS
+#define MCUBOOT_FLASH_STATS_MAX_AREAS 6
+#endif
+
+struct flash_area;
+
+/* Clears the counters of all flash areas. */
+void boot_flash_stats_reset(void);
+
+/*
+ * Returns the counters of the flash area `fa_id`, or NULL if it has not
+ * been accessed since the last reset.
+ */
+const struct boot_flash_area_stats *boot_flash_stats_get(uint8_t fa_id);
+
+/* Logs the counters of every flash area accessed since the last reset. */
+void boot_flash_stats_dump(void);
+
+int boot_flash_stats_read(const struct flash_area *fa, uint32_t off,
+                          void *dst, uint32_t len);
+int boot_flash_stats_write(const struct flash_area *fa, uint32_t off,
+                           const void *src, uint32_t len);
+int boot_flash_stats_erase(const struct flash_area *fa, uint32_t off,
+                           uint32_t len);
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+int boot_flash_stats_read_start(const struct flash_area *fa, uint32_t off,
+                                void *dst, uint32_t len);
+int boot_flash_stats_read_wait(const struct flash_area *fa);
+#endif
+
+#ifndef BOOT_FLASH_STATS_NO_WRAP
+#define flash_area_read(fa, off, dst, len) \
+    boot_flash_stats_read((fa), (off), (dst), (len))
+#define flash_area_write(fa, off, src, len) \
+    boot_flash_stats_write((fa), (off), (src), (len))
+#define flash_area_erase(fa, off, len) \
+    boot_flash_stats_erase((fa), (off), (len))
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+#define flash_area_read_start(fa, off, dst, len) \
+    boot_flash_stats_read_start((fa), (off), (dst), (len))
+#define flash_area_read_wait(fa) \
+    boot_flash_stats_read_wait((fa))
+#endif
+#endif /* !BOOT_FLASH_STATS_NO_WRAP */
+
+#else /* !MCUBOOT_FLASH_STATS */
+
+#define boot_flash_stats_reset() do { } while (0)
+#define boot_flash_stats_dump() do { } while (0)
+
+#endif /* !MCUBOOT_FLASH_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BOOTUTIL_FLASH_STATS_H_ */
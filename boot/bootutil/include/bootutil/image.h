@@ -65,6 +65,18 @@ struct flash_area;
  */
 #define IMAGE_F_RAM_LOAD                 0x00000020
 
+/*
+ * Indicates that the payload is a patch against the image in the primary
+ * slot, see IMAGE_TLV_DELTA_*.  Only valid in the secondary slot.
+ */
+#define IMAGE_F_DELTA                    0x00000040
+
+/*
+ * Indicates that the payload is an LZ4 compressed image, see
+ * IMAGE_TLV_DECOMP_*.  Only valid in the secondary slot.
+ */
+#define IMAGE_F_COMPRESSED_LZ4           0x00000080
+
 /*
  * Indicates that ih_load_addr stores information on flash/ROM address the
  * image has been built for.
@@ -101,6 +113,11 @@ struct flash_area;
 #define IMAGE_TLV_DEPENDENCY        0x40   /* Image depends on other image */
 #define IMAGE_TLV_SEC_CNT           0x50   /* security counter */
 #define IMAGE_TLV_BOOT_RECORD       0x60   /* measured boot record */
+#define IMAGE_TLV_DELTA_BASE        0x80   /* hash TLV of the patched image */
+#define IMAGE_TLV_DELTA_TARGET      0x81   /* hash TLV of the patch result */
+#define IMAGE_TLV_DELTA_INFO        0x82   /* struct image_delta_info */
+#define IMAGE_TLV_DECOMP_HASH       0x83   /* hash TLV of the decompressed image */
+#define IMAGE_TLV_DECOMP_INFO       0x84   /* struct image_decomp_info */
 					   /*
 					    * vendor reserved TLVs at xxA0-xxFF,
 					    * where xx denotes the upper byte
@@ -130,6 +147,17 @@ struct image_dependency {
                                              */
 };
 
+/** Delta image parameters.  All fields are in little endian byte order. */
+struct image_delta_info {
+    uint32_t idi_target_size;   /* Size of the patch result (bytes). */
+    uint32_t idi_window_size;   /* Output window of the patch (bytes). */
+} __packed;
+
+struct image_decomp_info {
+    uint32_t idc_size;          /* Size of the decompressed image (bytes). */
+    uint32_t idc_window_size;   /* Largest LZ4 match offset (bytes). */
+} __packed;
+
 /** Image header.  All fields are in little endian byte order. */
 struct image_header {
     uint32_t ih_magic;
@@ -170,6 +198,8 @@ fih_ret bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
                               uint8_t *tmp_buf, uint32_t tmp_buf_sz,
                               uint8_t *seed, int seed_len, uint8_t *out_hash);
 
+struct image_tlv_index;
+
 struct image_tlv_iter {
     const struct image_header *hdr;
     const struct flash_area *fap;
@@ -178,6 +208,9 @@ struct image_tlv_iter {
     uint32_t prot_end;
     uint32_t tlv_off;
     uint32_t tlv_end;
+    const uint8_t *tlv_data; /* TLV area mapped in place, or NULL */
+    const struct image_tlv_index *idx; /* TLV index of the slot, or NULL */
+    uint16_t idx_pos;
 };
 
 int bootutil_tlv_iter_begin(struct image_tlv_iter *it,
@@ -186,6 +219,14 @@ int bootutil_tlv_iter_begin(struct image_tlv_iter *it,
                             bool prot);
 int bootutil_tlv_iter_next(struct image_tlv_iter *it, uint32_t *off,
                            uint16_t *len, uint16_t *type);
+int bootutil_tlv_find(const struct image_header *hdr,
+                      const struct flash_area *fap, uint16_t type, bool prot,
+                      uint32_t *off, uint16_t *len);
+int bootutil_tlv_read(const struct image_header *hdr,
+                      const struct flash_area *fap, uint16_t type, bool prot,
+                      void *buf, uint16_t *len);
+void bootutil_tlv_index_invalidate(const struct flash_area *fap);
+void bootutil_tlv_index_reset(void);
 
 int32_t bootutil_get_img_security_cnt(struct image_header *hdr,
                                       const struct flash_area *fap,
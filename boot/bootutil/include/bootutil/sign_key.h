@@ -33,9 +33,32 @@ extern "C" {
 #endif
 
 #ifndef MCUBOOT_HW_KEY
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+#define BOOTUTIL_RSA_LIMBS (MCUBOOT_SIGN_RSA_LEN / 32)
+
+/* RSA public key with e = 65537, decoded ahead of time so that signature
+ * verification needs neither ASN.1 parsing nor Montgomery setup. Emitted by
+ * `imgtool getpub --rsa-preparsed`. Limbs are least significant first. */
+struct bootutil_rsa_pub_key {
+    uint32_t n0inv;                     /* -N^-1 mod 2^32 */
+    uint32_t n[BOOTUTIL_RSA_LIMBS];     /* modulus N */
+    uint32_t rr[BOOTUTIL_RSA_LIMBS];    /* R^2 mod N, R = 2^MCUBOOT_SIGN_RSA_LEN */
+};
+#endif
+
 struct bootutil_key {
     const uint8_t *key;
     const unsigned int *len;
+#ifdef MCUBOOT_KEY_HASH_TABLE
+    /* Digest of `key` with the image hash algorithm, as found in the
+     * KEYHASH TLV. Emitted by `imgtool getpub --with-hash`. */
+    const uint8_t *hash;
+    const unsigned int *hash_len;
+#endif
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+    /* `key`, pre-decoded. Used instead of `key` to verify signatures. */
+    const struct bootutil_rsa_pub_key *rsa;
+#endif
 };
 
 extern const struct bootutil_key bootutil_keys[];
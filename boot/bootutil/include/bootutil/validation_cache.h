@@ -0,0 +1,71 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ */
+
+#ifndef __VALIDATION_CACHE_H__
+#define __VALIDATION_CACHE_H__
+
+/**
+ * @file validation_cache.h
+ * @note The validation cache remembers the last successful validation of the
+ *       image in the primary slot, so a cold boot with an unchanged image can
+ *       skip hashing the image and verifying its signature. An entry is bound
+ *       to the image header, size, security counter and hash TLV by a MAC
+ *       keyed with a device unique secret.
+ * @note The entry must be kept outside of the image slots, and the key must
+ *       not be readable by the application. Anything other than MCUboot that
+ *       writes to the primary slot must invalidate the entry, MCUboot does so
+ *       itself before upgrading an image or uploading one through serial
+ *       recovery.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_VALIDATION_CACHE_MAGIC     0x48434156 /* "VACH" */
+#define BOOT_VALIDATION_CACHE_MAC_SIZE  32
+
+struct boot_validation_cache {
+    uint32_t magic;         /* BOOT_VALIDATION_CACHE_MAGIC when valid. */
+    uint32_t img_size;      /* Size of the image, including its TLVs. */
+    uint32_t security_cnt;  /* Security counter of the image. */
+    uint32_t pad;
+    uint8_t mac[BOOT_VALIDATION_CACHE_MAC_SIZE];
+};
+
+/**
+ * Reads the validation cache entry of a given image.
+ * @param image_id          Index of the image (from 0).
+ * @param entry             Pointer to store the entry.
+ * @return                  0 on success; nonzero on failure.
+ */
+int boot_validation_cache_load(uint32_t image_id,
+                               struct boot_validation_cache *entry);
+
+/**
+ * Writes the validation cache entry of a given image.
+ * @param image_id          Index of the image (from 0).
+ * @param entry             The entry to store.
+ * @return                  0 on success; nonzero on failure.
+ */
+int boot_validation_cache_store(uint32_t image_id,
+                                const struct boot_validation_cache *entry);
+
+/**
+ * Retrieves the device unique key the entries are authenticated with.
+ * @param key               Pointer to store the address of the key.
+ * @param key_len           Pointer to store the length of the key.
+ * @return                  0 on success; nonzero on failure.
+ */
+int boot_validation_cache_get_key(const uint8_t **key, uint32_t *key_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VALIDATION_CACHE_H__ */
@@ -242,6 +242,8 @@ int boot_save_shared_data(const struct image_header *hdr, const struct flash_are
     uint8_t mode = MCUBOOT_MODE_UPGRADE_ONLY;
 #elif defined(MCUBOOT_SWAP_USING_MOVE)
     uint8_t mode = MCUBOOT_MODE_SWAP_USING_MOVE;
+#elif defined(MCUBOOT_SWAP_USING_OFFSET)
+    uint8_t mode = MCUBOOT_MODE_SWAP_USING_OFFSET;
 #elif defined(MCUBOOT_DIRECT_XIP)
 #if defined(MCUBOOT_DIRECT_XIP_REVERT)
     uint8_t mode = MCUBOOT_MODE_DIRECT_XIP_WITH_REVERT;
@@ -335,3 +337,21 @@ int boot_save_shared_data(const struct image_header *hdr, const struct flash_are
     return rc;
 }
 #endif /* MCUBOOT_DATA_SHARING_BOOTINFO */
+
+#if defined(MCUBOOT_DATA_SHARING) && defined(MCUBOOT_BOOT_TIMELINE)
+int boot_save_boot_timeline(void)
+{
+    struct boot_timeline_entry entries[MCUBOOT_BOOT_TIMELINE_SIZE];
+    size_t count;
+
+    count = boot_timeline_read(entries, MCUBOOT_BOOT_TIMELINE_SIZE);
+    if (count == 0) {
+        return 0;
+    }
+
+    return boot_add_data_to_shared_area(TLV_MAJOR_BLINFO,
+                                        BLINFO_BOOT_TIMELINE,
+                                        count * sizeof(entries[0]),
+                                        (const uint8_t *)entries);
+}
+#endif /* MCUBOOT_DATA_SHARING && MCUBOOT_BOOT_TIMELINE */
@@ -0,0 +1,173 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_BOOT_TIMELINE
+
+#include "bootutil/bench.h"
+#include "bootutil/bootutil_log.h"
+
+BOOT_LOG_MODULE_DECLARE(mcuboot);
+
+/* Phases that can be open at the same time, e.g. a signature check within a
+ * slot validation within a swap. */
+#define BOOT_TIMELINE_MAX_DEPTH 8
+
+struct boot_timeline {
+    struct boot_timeline_entry entries[MCUBOOT_BOOT_TIMELINE_SIZE];
+    uint32_t first;
+    uint32_t count;
+    uint32_t lost;
+};
+
+#ifdef __BOOTSIM__
+/* The simulator runs its tests in parallel threads. */
+static __thread struct boot_timeline boot_timeline;
+#else
+static struct boot_timeline boot_timeline;
+#endif
+
+static const char *const boot_phase_names[BOOT_PHASE_MAX] = {
+    [BOOT_PHASE_READ_HEADERS] = "read headers",
+    [BOOT_PHASE_VALIDATE_SLOT] = "validate slot",
+    [BOOT_PHASE_IMAGE_HASH] = "image hash",
+    [BOOT_PHASE_SIG_VERIFY] = "signature",
+    [BOOT_PHASE_ENC_KEY_LOAD] = "enc key load",
+    [BOOT_PHASE_SWAP_STEP] = "swap step",
+    [BOOT_PHASE_COPY_REGION] = "copy region",
+};
+
+void
+boot_timeline_reset(void)
+{
+    boot_timeline.first = 0;
+    boot_timeline.count = 0;
+    boot_timeline.lost = 0;
+}
+
+void
+boot_timeline_mark(uint8_t phase, uint8_t event, uint32_t bytes)
+{
+    struct boot_timeline_entry *entry;
+    uint32_t idx;
+
+    if (boot_timeline.count < MCUBOOT_BOOT_TIMELINE_SIZE) {
+        idx = (boot_timeline.first + boot_timeline.count) %
+              MCUBOOT_BOOT_TIMELINE_SIZE;
+        boot_timeline.count++;
+    } else {
+        /* Full, overwrite the oldest entry. */
+        idx = boot_timeline.first;
+        boot_timeline.first = (idx + 1) % MCUBOOT_BOOT_TIMELINE_SIZE;
+        boot_timeline.lost++;
+    }
+
+    entry = &boot_timeline.entries[idx];
+    entry->cycles = plat_bench_cycles();
+    entry->bytes = bytes;
+    entry->phase = phase;
+    entry->event = event;
+    entry->reserved = 0;
+}
+
+size_t
+boot_timeline_read(struct boot_timeline_entry *entries, size_t max)
+{
+    size_t i;
+
+    for (i = 0; i < boot_timeline.count && i < max; i++) {
+        entries[i] = boot_timeline.entries[(boot_timeline.first + i) %
+                                           MCUBOOT_BOOT_TIMELINE_SIZE];
+    }
+
+    return i;
+}
+
+static const char *
+boot_phase_name(uint8_t phase)
+{
+    if (phase >= BOOT_PHASE_MAX) {
+        return "unknown";
+    }
+    return boot_phase_names[phase];
+}
+
+void
+boot_timeline_dump(void)
+{
+    const struct boot_timeline_entry *entry;
+    const struct boot_timeline_entry *open[BOOT_TIMELINE_MAX_DEPTH];
+    uint32_t start;
+    uint32_t i;
+    int depth;
+    int j;
+
+    if (boot_timeline.count == 0) {
+        return;
+    }
+
+    BOOT_LOG_INF("Boot timeline: %lu markers, %lu lost",
+                 (unsigned long)boot_timeline.count,
+                 (unsigned long)boot_timeline.lost);
+
+    start = boot_timeline.entries[boot_timeline.first].cycles;
+    depth = 0;
+
+    /* Pair every end marker with the innermost open phase of the same type.
+     * Phases are logged as they end, with their start relative to the
+     * oldest marker; the begin markers of the oldest phases may have been
+     * overwritten. */
+    for (i = 0; i < boot_timeline.count; i++) {
+        entry = &boot_timeline.entries[(boot_timeline.first + i) %
+                                       MCUBOOT_BOOT_TIMELINE_SIZE];
+
+        if (entry->event == BOOT_TIMELINE_BEGIN) {
+            if (depth < BOOT_TIMELINE_MAX_DEPTH) {
+                open[depth++] = entry;
+            }
+            continue;
+        }
+
+        for (j = depth - 1; j >= 0; j--) {
+            if (open[j]->phase == entry->phase) {
+                break;
+            }
+        }
+
+        if (j < 0) {
+            BOOT_LOG_INF("  %s: ended at %lu, %lu bytes",
+                         boot_phase_name(entry->phase),
+                         (unsigned long)(entry->cycles - start),
+                         (unsigned long)entry->bytes);
+            continue;
+        }
+
+        BOOT_LOG_INF("  %s: %lu cycles at %lu, %lu bytes",
+                     boot_phase_name(entry->phase),
+                     (unsigned long)(entry->cycles - open[j]->cycles),
+                     (unsigned long)(open[j]->cycles - start),
+                     (unsigned long)entry->bytes);
+        depth = j;
+    }
+}
+
+#endif /* MCUBOOT_BOOT_TIMELINE */
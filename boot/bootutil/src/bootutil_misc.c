@@ -336,7 +336,8 @@ uint32_t bootutil_max_image_size(const struct flash_area *fap)
 #if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SINGLE_APPLICATION_SLOT) || \
     defined(MCUBOOT_FIRMWARE_LOADER)
     return boot_status_off(fap);
-#elif defined(MCUBOOT_SWAP_USING_MOVE)
+#elif defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || \
+      defined(MCUBOOT_DELTA_UPGRADE)
     struct flash_sector sector;
     /* get the last sector offset */
     int rc = flash_area_get_sector(fap, boot_status_off(fap), &sector);
@@ -347,6 +348,18 @@ uint32_t bootutil_max_image_size(const struct flash_area *fap)
                    */
     }
     return flash_sector_get_off(&sector);
+#elif defined(MCUBOOT_SWAP_USING_OFFSET)
+    struct flash_sector sector;
+    /* get the last sector offset */
+    int rc = flash_area_get_sector(fap, boot_status_off(fap), &sector);
+    if (rc) {
+        BOOT_LOG_ERR("Unable to determine flash sector of the image trailer");
+        return 0; /* Returning of zero here should cause any check which uses
+                   * this value to fail.
+                   */
+    }
+    /* The image in the secondary slot starts one sector into it. */
+    return flash_sector_get_off(&sector) - boot_img_hdr_off(fap);
 #elif defined(MCUBOOT_OVERWRITE_ONLY)
     return boot_swap_info_off(fap);
 #elif defined(MCUBOOT_DIRECT_XIP)
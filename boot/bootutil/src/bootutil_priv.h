@@ -28,6 +28,7 @@
 #ifndef H_BOOTUTIL_PRIV_
 #define H_BOOTUTIL_PRIV_
 
+#include <stddef.h>
 #include <string.h>
 
 #include "sysflash/sysflash.h"
@@ -37,12 +38,19 @@
 #include "bootutil/bootutil.h"
 #include "bootutil/image.h"
 #include "bootutil/fault_injection_hardening.h"
+#include "bootutil/bench.h"
+#include "bootutil/flash_stats.h"
 #include "mcuboot_config/mcuboot_config.h"
 
 #ifdef MCUBOOT_ENC_IMAGES
 #include "bootutil/enc_key.h"
 #endif
 
+#include "bootutil/crypto/sha.h"
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+#include "bootutil/crypto/offload.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,14 +64,16 @@ struct flash_area;
 
 #if (defined(MCUBOOT_OVERWRITE_ONLY) + \
      defined(MCUBOOT_SWAP_USING_MOVE) + \
+     defined(MCUBOOT_SWAP_USING_OFFSET) + \
      defined(MCUBOOT_DIRECT_XIP) + \
      defined(MCUBOOT_RAM_LOAD) + \
      defined(MCUBOOT_FIRMWARE_LOADER)) > 1
-#error "Please enable only one of MCUBOOT_OVERWRITE_ONLY, MCUBOOT_SWAP_USING_MOVE, MCUBOOT_DIRECT_XIP, MCUBOOT_RAM_LOAD or MCUBOOT_FIRMWARE_LOADER"
+#error "Please enable only one of MCUBOOT_OVERWRITE_ONLY, MCUBOOT_SWAP_USING_MOVE, MCUBOOT_SWAP_USING_OFFSET, MCUBOOT_DIRECT_XIP, MCUBOOT_RAM_LOAD or MCUBOOT_FIRMWARE_LOADER"
 #endif
 
 #if !defined(MCUBOOT_OVERWRITE_ONLY) && \
     !defined(MCUBOOT_SWAP_USING_MOVE) && \
+    !defined(MCUBOOT_SWAP_USING_OFFSET) && \
     !defined(MCUBOOT_DIRECT_XIP) && \
     !defined(MCUBOOT_RAM_LOAD) && \
     !defined(MCUBOOT_SINGLE_APPLICATION_SLOT) && \
@@ -174,6 +184,33 @@ _Static_assert(sizeof(boot_img_magic) == BOOT_MAGIC_SZ, "Invalid size for image
 #endif /* MCUBOOT_DIRECT_XIP && MCUBOOT_ENC_IMAGES */
 #endif /* MCUBOOT_DIRECT_XIP || MCUBOOT_RAM_LOAD */
 
+#if defined(MCUBOOT_HASH_ON_COPY) && \
+    !defined(MCUBOOT_OVERWRITE_ONLY) && !defined(MCUBOOT_BOOTSTRAP)
+#error "MCUBOOT_HASH_ON_COPY requires MCUBOOT_OVERWRITE_ONLY or MCUBOOT_BOOTSTRAP"
+#endif
+
+#if defined(MCUBOOT_HASH_ON_COPY) && !defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
+/* The hash only spares reading the primary slot back when it is validated,
+ * don't compute it otherwise. */
+#undef MCUBOOT_HASH_ON_COPY
+#endif
+
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) && !defined(MCUBOOT_OVERWRITE_ONLY)
+#error "MCUBOOT_OVERWRITE_ONLY_RESUME requires MCUBOOT_OVERWRITE_ONLY"
+#endif
+
+#if defined(MCUBOOT_OVERWRITE_ONLY_DIFF) && !defined(MCUBOOT_OVERWRITE_ONLY)
+#error "MCUBOOT_OVERWRITE_ONLY_DIFF requires MCUBOOT_OVERWRITE_ONLY"
+#endif
+
+#if defined(MCUBOOT_DELTA_UPGRADE) && !defined(MCUBOOT_OVERWRITE_ONLY)
+#error "MCUBOOT_DELTA_UPGRADE requires MCUBOOT_OVERWRITE_ONLY"
+#endif
+
+#if defined(MCUBOOT_DECOMPRESS_IMAGES) && !defined(MCUBOOT_OVERWRITE_ONLY)
+#error "MCUBOOT_DECOMPRESS_IMAGES requires MCUBOOT_OVERWRITE_ONLY"
+#endif
+
 #define BOOT_MAX_IMG_SECTORS       MCUBOOT_MAX_IMG_SECTORS
 
 #define BOOT_LOG_IMAGE_INFO(slot, hdr)                                    \
@@ -188,6 +225,9 @@ _Static_assert(sizeof(boot_img_magic) == BOOT_MAGIC_SZ, "Invalid size for image
 #define BOOT_STATUS_MOVE_STATE_COUNT    1
 #define BOOT_STATUS_SWAP_STATE_COUNT    2
 #define BOOT_STATUS_STATE_COUNT         (BOOT_STATUS_MOVE_STATE_COUNT + BOOT_STATUS_SWAP_STATE_COUNT)
+#elif defined(MCUBOOT_SWAP_USING_OFFSET)
+#define BOOT_STATUS_SWAP_STATE_COUNT    2
+#define BOOT_STATUS_STATE_COUNT         BOOT_STATUS_SWAP_STATE_COUNT
 #else
 #define BOOT_STATUS_STATE_COUNT         3
 #endif
@@ -214,6 +254,18 @@ typedef struct flash_area boot_sector_t;
 #endif
 
 /** Private state maintained during boot. */
+#ifdef MCUBOOT_HASH_ON_COPY
+/** Hash of an image computed while it is copied into the primary slot. */
+struct boot_copy_hash {
+    bootutil_sha_context sha;
+    uint32_t off;       /* Offset of the next byte expected to be written. */
+    uint32_t size;      /* Size of the hashed header, payload and TLVs. */
+    bool active;        /* A copy is being hashed. */
+    bool valid;         /* `hash` holds the hash of the last copy. */
+    uint8_t hash[IMAGE_HASH_SIZE];
+};
+#endif
+
 struct boot_loader_state {
     struct {
         struct image_header hdr;
@@ -242,6 +294,10 @@ struct boot_loader_state {
     bool img_mask[BOOT_IMAGE_NUMBER];
 #endif
 
+#ifdef MCUBOOT_HASH_ON_COPY
+    struct boot_copy_hash copy_hash[BOOT_IMAGE_NUMBER];
+#endif
+
 #if defined(MCUBOOT_DIRECT_XIP) || defined(MCUBOOT_RAM_LOAD)
     struct slot_usage_t {
         /* Index of the slot chosen to be loaded */
@@ -295,8 +351,20 @@ int boot_copy_region(struct boot_loader_state *state,
                      const struct flash_area *fap_dst,
                      uint32_t off_src, uint32_t off_dst, uint32_t sz);
 int boot_erase_region(const struct flash_area *fap, uint32_t off, uint32_t sz);
+int boot_erase_region_if_required(const struct flash_area *fap, uint32_t off,
+                                  uint32_t sz);
 bool boot_status_is_reset(const struct boot_status *bs);
 
+#ifdef MCUBOOT_SWAP_USING_OFFSET
+/*
+ * Offset of the image header from the beginning of the flash area. An upgrade
+ * image is stored one sector into the secondary slot, see swap_offset.c.
+ */
+uint32_t boot_img_hdr_off(const struct flash_area *fap);
+#else
+#define boot_img_hdr_off(fap) ((void)(fap), (uint32_t)0)
+#endif
+
 #ifdef MCUBOOT_ENC_IMAGES
 int boot_write_enc_key(const struct flash_area *fap, uint8_t slot,
                        const struct boot_status *bs);
@@ -314,6 +382,22 @@ int boot_read_enc_key(const struct flash_area *fap, uint8_t slot,
 bool bootutil_buffer_is_erased(const struct flash_area *area,
                                const void *buffer, size_t len);
 
+/**
+ * Checks whether the device a flash area resides on must be erased before
+ * it can be written. Devices that can be programmed in place (e.g. MRAM)
+ * are only supported when MCUBOOT_SUPPORT_DEV_WITHOUT_ERASE is enabled.
+ */
+static inline bool
+boot_device_requires_erase(const struct flash_area *fap)
+{
+#if defined(MCUBOOT_SUPPORT_DEV_WITHOUT_ERASE)
+    return flash_area_erase_required(fap);
+#else
+    (void)fap;
+    return true;
+#endif
+}
+
 /**
  * Safe (non-overflowing) uint32_t addition.  Returns true, and stores
  * the result in *dest if it can be done without overflow.  Otherwise,
@@ -368,6 +452,9 @@ static inline bool boot_u16_safe_add(uint16_t *dest, uint16_t a, uint16_t b)
 #define BOOT_IMG_AREA(state, slot) (BOOT_IMG(state, slot).area)
 #define BOOT_WRITE_SZ(state) ((state)->write_sz)
 #define BOOT_SWAP_TYPE(state) ((state)->swap_type[BOOT_CURR_IMG(state)])
+#ifdef MCUBOOT_HASH_ON_COPY
+#define BOOT_COPY_HASH(state) ((state)->copy_hash[BOOT_CURR_IMG(state)])
+#endif
 #define BOOT_TLV_OFF(hdr) ((hdr)->ih_hdr_size + (hdr)->ih_img_size)
 
 #define BOOT_IS_UPGRADE(swap_type)             \
@@ -461,15 +548,244 @@ struct bootsim_ram_info *bootsim_get_ram_info(void);
 #define LOAD_IMAGE_DATA(hdr, fap, start, output, size)       \
     (memcpy((output),(void*)(IMAGE_RAM_BASE + (hdr)->ih_load_addr + (start)), \
     (size)), 0)
+
+#define IMAGE_DATA_PTR(hdr, fap, start, size)                \
+    ((const uint8_t *)(IMAGE_RAM_BASE + (hdr)->ih_load_addr + (start)))
 #else
 #define IMAGE_RAM_BASE ((uintptr_t)0)
 
 #define LOAD_IMAGE_DATA(hdr, fap, start, output, size)       \
-    (flash_area_read((fap), (start), (output), (size)))
+    (flash_area_read((fap), boot_img_hdr_off(fap) + (start), (output), (size)))
+
+#if defined(MCUBOOT_FLASH_AREA_DIRECT_ACCESS)
+/*
+ * Returns the address at which a range of a flash area can be read in place,
+ * or NULL if the backend cannot map the range.
+ */
+static inline const uint8_t *
+boot_flash_area_ptr(const struct flash_area *fap, uint32_t off, uint32_t len)
+{
+    const void *ptr;
+
+    if (flash_area_get_ptr(fap, off, len, &ptr) != 0) {
+        return NULL;
+    }
+
+    return ptr;
+}
+
+#define IMAGE_DATA_PTR(hdr, fap, start, size)                \
+    (boot_flash_area_ptr((fap), boot_img_hdr_off(fap) + (start), (size)))
+#else
+#define IMAGE_DATA_PTR(hdr, fap, start, size)                \
+    ((const uint8_t *)NULL)
+#endif /* MCUBOOT_FLASH_AREA_DIRECT_ACCESS */
 #endif /* MCUBOOT_RAM_LOAD */
 
 uint32_t bootutil_max_image_size(const struct flash_area *fap);
 
+/*
+ * A flash read that may complete in the background, see
+ * `boot_read_start()`.
+ */
+struct boot_read_req {
+    const struct flash_area *fap;
+    uint32_t off;
+    void *dst;
+    uint32_t len;
+};
+
+/*
+ * Starts reading `len` bytes at `off` into `dst`. The data is only
+ * available, and `dst` must only be touched, once `boot_read_wait()` has
+ * returned. Only one read per flash area may be outstanding.
+ *
+ * Without MCUBOOT_FLASH_AREA_ASYNC_READ the read is deferred to
+ * `boot_read_wait()`, so callers behave as with plain synchronous reads.
+ */
+static inline int
+boot_read_start(struct boot_read_req *req, const struct flash_area *fap,
+                uint32_t off, void *dst, uint32_t len)
+{
+    req->fap = fap;
+    req->off = off;
+    req->dst = dst;
+    req->len = len;
+
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+    return flash_area_read_start(fap, off, dst, len);
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Waits for a read started with `boot_read_start()` to complete.
+ *
+ * @return 0 on success; nonzero on failure.
+ */
+static inline int
+boot_read_wait(struct boot_read_req *req)
+{
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+    return flash_area_read_wait(req->fap);
+#else
+    return flash_area_read(req->fap, req->off, req->dst, req->len);
+#endif
+}
+
+/*
+ * Crypto work on one buffer that may complete in the background, see
+ * `boot_sha_update_start()`. A SHA update and, for encrypted images, an
+ * AES-CTR operation may be outstanding at the same time.
+ */
+struct boot_crypto_req {
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+    struct boot_crypto_job sha;
+#ifdef MCUBOOT_ENC_IMAGES
+    struct boot_crypto_job aes;
+#endif
+    struct boot_crypto_job *last;   /* Last job submitted, NULL if none. */
+#endif
+#ifdef MCUBOOT_ENC_IMAGES
+    uint8_t counter[16];            /* AES-CTR counter of the `aes` job. */
+#endif
+    int rc;
+};
+
+static inline void
+boot_crypto_req_init(struct boot_crypto_req *req)
+{
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+    req->last = NULL;
+#endif
+    req->rc = 0;
+}
+
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+static inline void
+boot_crypto_req_done(struct boot_crypto_req *req, int rc)
+{
+    if (rc != 0) {
+        req->rc = rc;
+    }
+}
+
+static inline void
+boot_crypto_sha_done(struct boot_crypto_job *job, int rc)
+{
+    /* As with `bootutil_sha_update()`, whose return value is not uniform
+     * across crypto libraries, a failed update shows up as a wrong hash. */
+    (void)job;
+    (void)rc;
+}
+
+#ifdef MCUBOOT_ENC_IMAGES
+static inline void
+boot_crypto_aes_done(struct boot_crypto_job *job, int rc)
+{
+    boot_crypto_req_done((struct boot_crypto_req *)
+            ((uint8_t *)job - offsetof(struct boot_crypto_req, aes)), rc);
+}
+#endif
+#endif /* MCUBOOT_CRYPTO_OFFLOAD */
+
+/*
+ * Starts hashing `len` bytes at `data` into `ctx`. `data` and `ctx` must
+ * not be touched until `boot_crypto_req_wait()` has returned.
+ *
+ * Without MCUBOOT_CRYPTO_OFFLOAD the update is done straight away.
+ *
+ * @return 0 on success; nonzero if the update could not be started.
+ */
+static inline int
+boot_sha_update_start(struct boot_crypto_req *req, bootutil_sha_context *ctx,
+                      const void *data, uint32_t len)
+{
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+    int rc;
+
+    req->sha.done = boot_crypto_sha_done;
+    rc = boot_crypto_sha_update_submit(&req->sha, ctx, data, len);
+    if (rc != 0) {
+        req->rc = rc;
+        return rc;
+    }
+    req->last = &req->sha;
+#else
+    (void)req;
+    (void)bootutil_sha_update(ctx, data, len);
+#endif
+    return 0;
+}
+
+/*
+ * Waits for the work started on `req` to complete.
+ *
+ * @return 0 if all of it succeeded; nonzero otherwise.
+ */
+static inline int
+boot_crypto_req_wait(struct boot_crypto_req *req)
+{
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+    if (req->last != NULL) {
+        boot_crypto_wait(req->last);
+        req->last = NULL;
+    }
+#endif
+    return req->rc;
+}
+
+#ifdef MCUBOOT_ENC_IMAGES
+int boot_encrypt_start(struct boot_crypto_req *req,
+                       struct enc_key_data *enc_state, int image_index,
+                       const struct flash_area *fap, uint32_t off,
+                       uint32_t sz, uint32_t blk_off, uint8_t *buf);
+#endif
+
+#ifdef MCUBOOT_HASH_ON_COPY
+fih_ret bootutil_img_validate_hashed(int image_index, struct image_header *hdr,
+                                     const struct flash_area *fap,
+                                     const uint8_t *hash);
+void boot_copy_hash_set(struct boot_loader_state *state, const uint8_t *hash,
+                        uint32_t size);
+#endif
+
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || defined(MCUBOOT_DELTA_UPGRADE)
+/* Progress journal of overwrite upgrades, in the primary slot's trailer. */
+int boot_copy_journal_trailer_off(const struct flash_area *fap,
+                                  uint32_t *trailer_off);
+uint32_t boot_copy_journal_entries(struct boot_loader_state *state,
+                                   const struct flash_area *fap);
+int boot_copy_journal_start(struct boot_loader_state *state,
+                            const struct flash_area *fap, uint32_t size);
+bool boot_copy_journal_matches(struct boot_loader_state *state,
+                               const struct flash_area *fap, uint32_t size);
+int boot_copy_journal_read_entry(struct boot_loader_state *state,
+                                 const struct flash_area *fap, size_t entry);
+int boot_copy_journal_write(struct boot_loader_state *state,
+                            const struct flash_area *fap, size_t entry);
+int boot_copy_journal_drop(const struct flash_area *fap);
+#endif
+
+#ifdef MCUBOOT_DELTA_UPGRADE
+int boot_delta_check(struct boot_loader_state *state);
+int boot_delta_apply(struct boot_loader_state *state, uint32_t *size);
+#endif
+
+#ifdef MCUBOOT_DECOMPRESS_IMAGES
+int boot_decomp_check(struct boot_loader_state *state);
+int boot_decomp_apply(struct boot_loader_state *state, uint32_t *size);
+#endif
+
+#ifdef MCUBOOT_VALIDATION_CACHE
+fih_ret boot_validation_cache_check(int image_index, struct image_header *hdr,
+                                    const struct flash_area *fap);
+void boot_validation_cache_update(int image_index, struct image_header *hdr,
+                                  const struct flash_area *fap);
+void boot_validation_cache_invalidate(int image_index);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
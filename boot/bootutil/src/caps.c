@@ -45,9 +45,26 @@ uint32_t bootutil_get_caps(void)
     res |= BOOTUTIL_CAP_OVERWRITE_UPGRADE;
 #elif defined(MCUBOOT_SWAP_USING_MOVE)
     res |= BOOTUTIL_CAP_SWAP_USING_MOVE;
+#elif defined(MCUBOOT_SWAP_USING_OFFSET)
+    res |= BOOTUTIL_CAP_SWAP_USING_OFFSET;
 #else
     res |= BOOTUTIL_CAP_SWAP_USING_SCRATCH;
 #endif
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME)
+    res |= BOOTUTIL_CAP_OVERWRITE_RESUME;
+#endif
+#if defined(MCUBOOT_OVERWRITE_ONLY_DIFF)
+    res |= BOOTUTIL_CAP_OVERWRITE_DIFF;
+#endif
+#if defined(MCUBOOT_DELTA_UPGRADE)
+    res |= BOOTUTIL_CAP_DELTA_UPGRADE;
+#endif
+#if defined(MCUBOOT_DECOMPRESS_IMAGES)
+    res |= BOOTUTIL_CAP_DECOMPRESS_IMAGES;
+#endif
+#if defined(MCUBOOT_VALIDATION_CACHE)
+    res |= BOOTUTIL_CAP_VALIDATION_CACHE;
+#endif
 #if defined(MCUBOOT_ENCRYPT_RSA)
     res |= BOOTUTIL_CAP_ENC_RSA;
 #endif
@@ -0,0 +1,495 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compressed images.
+ *
+ * A compressed image is a signed image flagged with IMAGE_F_COMPRESSED_LZ4,
+ * whose payload is a single LZ4 block (the raw block format, without a frame)
+ * holding a whole signed image, from its header to its last TLV. Its
+ * protected TLVs hold the hash TLV of that image, and the sizes of the image
+ * and of the decompression window, so the signature covers both the
+ * compressed form and the hash of what it decompresses to. Its version,
+ * security counter and dependencies are those of the image it holds.
+ *
+ * The image is decompressed straight into the primary slot. Only the last
+ * idc_window_size bytes produced are kept, in RAM, and written out each time
+ * the window fills up; so the LZ4 matches may not reach further back than
+ * that, which imgtool ensures.
+ *
+ * Before the upgrade starts, the image is decompressed once without writing
+ * anything, and its hash checked against the hash TLV, so that a stream that
+ * does not decompress to the signed image is rejected while the primary slot
+ * is still intact. The secondary slot is left untouched until the upgrade is
+ * complete, so an interrupted one is simply started again.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bootutil/bootutil.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/crypto/sha.h"
+#include "bootutil/image.h"
+#include "bootutil_priv.h"
+
+#include "mcuboot_config/mcuboot_config.h"
+
+BOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#ifdef MCUBOOT_DECOMPRESS_IMAGES
+
+#ifndef MCUBOOT_DECOMPRESS_WINDOW_SIZE
+#define MCUBOOT_DECOMPRESS_WINDOW_SIZE 4096
+#endif
+
+/* See loader.c. */
+#if !defined(__BOOTSIM__)
+#define TARGET_STATIC static
+#else
+#define TARGET_STATIC
+#endif
+
+/* Size of the buffer the compressed stream is read through. */
+#define BOOT_DECOMP_READ_SZ         256
+
+/* Shortest LZ4 match, which the match lengths are relative to. */
+#define BOOT_DECOMP_MIN_MATCH       4
+
+struct boot_decomp {
+    struct boot_loader_state *state;
+    const struct flash_area *fap_pri;
+    const struct flash_area *fap_sec;
+    const struct image_header *hdr; /* Header of the compressed image. */
+    uint32_t size;
+    uint32_t window_size;
+    uint32_t hash_sz;       /* Size of the hashed part of the image. */
+    bool write;
+    bootutil_sha_context sha;
+
+    /* Compressed stream. */
+    uint32_t in_off;        /* Next byte to read from the secondary slot. */
+    uint32_t in_end;
+    uint32_t in_pos;        /* Next byte of the buffer. */
+    uint32_t in_len;
+    uint8_t in_buf[BOOT_DECOMP_READ_SZ];
+
+    /* Window, holding the last bytes produced. */
+    uint8_t *win;
+    uint32_t win_pos;       /* Next byte of the window. */
+    uint32_t out_off;       /* Image offset of the window. */
+};
+
+/**
+ * Reads the parameters of the compressed image in the secondary slot, and
+ * checks that the primary slot has room for the image it holds.
+ *
+ * @param d                     Receives the parameters.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_decomp_init(struct boot_loader_state *state, struct boot_decomp *d)
+{
+    struct image_decomp_info info;
+    uint16_t len;
+    int rc;
+
+    memset(d, 0, sizeof(*d));
+    d->state = state;
+    d->fap_pri = BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT);
+    d->fap_sec = BOOT_IMG_AREA(state, BOOT_SECONDARY_SLOT);
+    d->hdr = boot_img_hdr(state, BOOT_SECONDARY_SLOT);
+
+    if (IS_ENCRYPTED(d->hdr)) {
+        BOOT_LOG_ERR("Encrypted compressed images are not supported");
+        return BOOT_EBADIMAGE;
+    }
+
+    len = sizeof(info);
+    rc = bootutil_tlv_read(d->hdr, d->fap_sec, IMAGE_TLV_DECOMP_INFO, true,
+                           &info, &len);
+    if (rc != 0 || len != sizeof(info)) {
+        BOOT_LOG_ERR("Compressed image without parameters");
+        return BOOT_EBADIMAGE;
+    }
+
+    d->size = info.idc_size;
+    d->window_size = info.idc_window_size;
+    if (d->window_size < sizeof(struct image_header) ||
+        d->window_size > MCUBOOT_DECOMPRESS_WINDOW_SIZE ||
+        d->window_size % BOOT_WRITE_SZ(state) != 0) {
+        BOOT_LOG_ERR("Unsupported decompression window size: 0x%lx",
+                     (unsigned long)d->window_size);
+        return BOOT_EBADIMAGE;
+    }
+
+    if (d->size < sizeof(struct image_header) ||
+        d->size > bootutil_max_image_size(d->fap_pri)) {
+        BOOT_LOG_ERR("Decompressed image does not fit in the primary slot");
+        return BOOT_EBADIMAGE;
+    }
+
+    return 0;
+}
+
+/**
+ * Checks the hash of the decompressed image against the hash TLV.
+ */
+static int
+boot_decomp_check_hash(struct boot_decomp *d, const uint8_t *hash)
+{
+    uint8_t expected[IMAGE_HASH_SIZE];
+    uint16_t len;
+    int rc;
+
+    len = sizeof(expected);
+    rc = bootutil_tlv_read(d->hdr, d->fap_sec, IMAGE_TLV_DECOMP_HASH, true,
+                           expected, &len);
+    if (rc != 0 || len != sizeof(expected) ||
+        memcmp(expected, hash, sizeof(expected)) != 0) {
+        BOOT_LOG_ERR("Image %d decompressed image does not match its hash",
+                     BOOT_CURR_IMG(d->state));
+        return BOOT_EBADIMAGE;
+    }
+
+    return 0;
+}
+
+/* Reads the next byte of the compressed stream. */
+static int
+boot_decomp_read(struct boot_decomp *d, uint8_t *byte)
+{
+    uint32_t len;
+    int rc;
+
+    if (d->in_pos == d->in_len) {
+        if (d->in_off == d->in_end) {
+            return BOOT_EBADIMAGE;
+        }
+        len = d->in_end - d->in_off;
+        if (len > sizeof(d->in_buf)) {
+            len = sizeof(d->in_buf);
+        }
+        rc = flash_area_read(d->fap_sec, d->in_off, d->in_buf, len);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+        d->in_off += len;
+        d->in_pos = 0;
+        d->in_len = len;
+    }
+
+    *byte = d->in_buf[d->in_pos++];
+    return 0;
+}
+
+static bool
+boot_decomp_read_done(const struct boot_decomp *d)
+{
+    return d->in_pos == d->in_len && d->in_off == d->in_end;
+}
+
+/*
+ * Reads the rest of an LZ4 length, whose first 4 bits are `len`. Lengths
+ * past the size of the image are rejected, which also keeps them from
+ * overflowing.
+ */
+static int
+boot_decomp_read_len(struct boot_decomp *d, uint32_t len, uint32_t *val)
+{
+    uint8_t byte;
+    int rc;
+
+    if (len == 15) {
+        do {
+            rc = boot_decomp_read(d, &byte);
+            if (rc != 0) {
+                return rc;
+            }
+            len += byte;
+            if (len > d->size) {
+                return BOOT_EBADIMAGE;
+            }
+        } while (byte == 255);
+    }
+
+    *val = len;
+    return 0;
+}
+
+/**
+ * Hashes the bytes in the window and, when writing, writes them to the
+ * primary slot. Only the last flush may be of a partial window.
+ */
+static int
+boot_decomp_flush(struct boot_decomp *d)
+{
+    const struct image_header *img;
+    uint32_t len;
+    int rc;
+
+    if (d->out_off == 0) {
+        img = (const struct image_header *)d->win;
+        if (d->win_pos < sizeof(*img) || img->ih_magic != IMAGE_MAGIC) {
+            return BOOT_EBADIMAGE;
+        }
+        d->hash_sz = BOOT_TLV_OFF(img) + img->ih_protect_tlv_size;
+        if (d->hash_sz > d->size) {
+            return BOOT_EBADIMAGE;
+        }
+    }
+
+    if (d->out_off < d->hash_sz) {
+        bootutil_sha_update(&d->sha, d->win,
+                            (d->hash_sz - d->out_off < d->win_pos) ?
+                            d->hash_sz - d->out_off : d->win_pos);
+    }
+
+    if (d->write) {
+        len = ALIGN_UP(d->win_pos, BOOT_WRITE_SZ(d->state));
+        memset(&d->win[d->win_pos], flash_area_erased_val(d->fap_pri),
+               len - d->win_pos);
+        rc = flash_area_write(d->fap_pri, d->out_off, d->win, len);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+    }
+
+    d->out_off += d->win_pos;
+    d->win_pos = 0;
+
+    MCUBOOT_WATCHDOG_FEED();
+
+    return 0;
+}
+
+/* Appends a byte to the image. */
+static int
+boot_decomp_put(struct boot_decomp *d, uint8_t byte)
+{
+    if (d->out_off + d->win_pos == d->size) {
+        return BOOT_EBADIMAGE;
+    }
+
+    d->win[d->win_pos++] = byte;
+    if (d->win_pos == d->window_size) {
+        return boot_decomp_flush(d);
+    }
+
+    return 0;
+}
+
+/**
+ * Decompresses the image, hashing it.
+ *
+ * @param write                 Whether to write the image to the primary
+ *                                  slot, or to only hash it.
+ * @param hash                  Receives the hash of the image.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_decomp_run(struct boot_decomp *d, bool write, uint8_t *hash)
+{
+    uint32_t lit_len;
+    uint32_t match_len;
+    uint32_t match_off;
+    uint32_t src;
+    uint32_t i;
+    uint8_t token;
+    uint8_t lo;
+    uint8_t hi;
+    uint8_t byte;
+    int rc;
+
+    TARGET_STATIC uint8_t win[MCUBOOT_DECOMPRESS_WINDOW_SIZE]
+        __attribute__((aligned(4)));
+
+    d->in_off = boot_img_hdr_off(d->fap_sec) + d->hdr->ih_hdr_size;
+    d->in_end = d->in_off + d->hdr->ih_img_size;
+    d->in_pos = 0;
+    d->in_len = 0;
+    d->win = win;
+    d->win_pos = 0;
+    d->out_off = 0;
+    d->hash_sz = 0;
+    d->write = write;
+
+    bootutil_sha_init(&d->sha);
+
+    for (;;) {
+        rc = boot_decomp_read(d, &token);
+        if (rc == 0) {
+            rc = boot_decomp_read_len(d, token >> 4, &lit_len);
+        }
+        for (i = 0; i < lit_len && rc == 0; i++) {
+            rc = boot_decomp_read(d, &byte);
+            if (rc == 0) {
+                rc = boot_decomp_put(d, byte);
+            }
+        }
+        if (rc != 0) {
+            goto out;
+        }
+
+        /* The last sequence ends with its literals. */
+        if (boot_decomp_read_done(d)) {
+            break;
+        }
+
+        rc = boot_decomp_read(d, &lo);
+        if (rc == 0) {
+            rc = boot_decomp_read(d, &hi);
+        }
+        if (rc == 0) {
+            rc = boot_decomp_read_len(d, token & 0x0f, &match_len);
+        }
+        if (rc != 0) {
+            goto out;
+        }
+
+        match_off = lo | ((uint32_t)hi << 8);
+        if (match_off == 0 || match_off > d->window_size ||
+            match_off > d->out_off + d->win_pos) {
+            rc = BOOT_EBADIMAGE;
+            goto out;
+        }
+
+        /* The window is a ring buffer, only flushed once full. */
+        src = (d->win_pos >= match_off) ? d->win_pos - match_off :
+              d->win_pos + d->window_size - match_off;
+        for (i = 0; i < match_len + BOOT_DECOMP_MIN_MATCH && rc == 0; i++) {
+            byte = d->win[src];
+            src = (src + 1 == d->window_size) ? 0 : src + 1;
+            rc = boot_decomp_put(d, byte);
+        }
+        if (rc != 0) {
+            goto out;
+        }
+    }
+
+    if (d->out_off + d->win_pos != d->size) {
+        rc = BOOT_EBADIMAGE;
+        goto out;
+    }
+    if (d->win_pos != 0) {
+        rc = boot_decomp_flush(d);
+        if (rc != 0) {
+            goto out;
+        }
+    }
+
+    bootutil_sha_finish(&d->sha, hash);
+    rc = 0;
+
+out:
+    bootutil_sha_drop(&d->sha);
+    return rc;
+}
+
+/**
+ * Checks that the compressed image in the secondary slot decompresses to the
+ * image whose hash it holds.
+ *
+ * @return                      0 if the image can be decompressed; nonzero
+ *                                  otherwise.
+ */
+int
+boot_decomp_check(struct boot_loader_state *state)
+{
+    struct boot_decomp d;
+    uint8_t hash[IMAGE_HASH_SIZE];
+    int rc;
+
+    rc = boot_decomp_init(state, &d);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = boot_decomp_run(&d, false, hash);
+    if (rc != 0) {
+        BOOT_LOG_ERR("Image %d does not decompress", BOOT_CURR_IMG(state));
+        return rc;
+    }
+
+    return boot_decomp_check_hash(&d, hash);
+}
+
+/**
+ * Decompresses the compressed image in the secondary slot to the primary
+ * slot, which is erased first. The image must have passed
+ * `boot_decomp_check()`.
+ *
+ * @param size                  On success, the size of the decompressed
+ *                                  image.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_decomp_apply(struct boot_loader_state *state, uint32_t *size)
+{
+    struct boot_decomp d;
+    uint8_t hash[IMAGE_HASH_SIZE];
+    uint32_t off;
+    uint32_t sz;
+    size_t sect;
+    int rc;
+
+    rc = boot_decomp_init(state, &d);
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* The slot may be written without being erased first. */
+    bootutil_tlv_index_invalidate(d.fap_pri);
+
+    BOOT_LOG_INF("Erasing the primary slot");
+    for (sect = 0, off = 0; sect < boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
+         sect++) {
+        sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, sect);
+        rc = boot_erase_region_if_required(d.fap_pri, off, sz);
+        if (rc != 0) {
+            return rc;
+        }
+        off += sz;
+    }
+
+    BOOT_LOG_INF("Image %d decompressing the secondary slot to the primary "
+                 "slot: 0x%lx bytes", BOOT_CURR_IMG(state),
+                 (unsigned long)d.size);
+    rc = boot_decomp_run(&d, true, hash);
+    if (rc == 0) {
+        rc = boot_decomp_check_hash(&d, hash);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+#ifdef MCUBOOT_HASH_ON_COPY
+    /* Validating the primary slot reuses the hash of the image. */
+    boot_copy_hash_set(state, hash, d.hash_sz);
+#endif
+
+    *size = d.size;
+    return 0;
+}
+
+#endif /* MCUBOOT_DECOMPRESS_IMAGES */
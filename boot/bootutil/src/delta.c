@@ -0,0 +1,727 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Delta upgrades.
+ *
+ * A delta image is a signed image flagged with IMAGE_F_DELTA, whose payload
+ * is a patch turning the image in the primary slot (the base) into the new
+ * image (the target). Its protected TLVs hold the hash TLV of the base and
+ * of the target, and the sizes of the target and of the patch windows. Its
+ * version, security counter and dependencies are those of the target.
+ *
+ * The patch is a sequence of records, each made of:
+ *
+ *   copy     LEB128 number of bytes to copy from the base
+ *   insert   LEB128 number of bytes to take from the patch
+ *   seek     zigzag LEB128 move of the base position after the copy
+ *   data     the `insert` bytes
+ *
+ * with the base position starting at 0. The target, from its header to its
+ * last TLV, is produced in windows of idi_window_size bytes, each one built
+ * in RAM and then written over the same range of the primary slot. So a
+ * window may only copy from the base at or after its own start. A window
+ * that copies from its own range, and the first one, are first stashed in
+ * the secondary slot, right before the sector holding the trailer, so that
+ * they can be written again if a reset interrupts their write.
+ *
+ * The progress is kept in the journal of overwrite upgrades, see loader.c:
+ * entry 2k is set once window k has been written, and entry 2k + 1 once it
+ * has been stashed. An interrupted upgrade replays the patch from the
+ * start, reading back the windows already written instead of building them,
+ * and goes on from the first window not written, restoring it from the stash
+ * if it was stashed.
+ *
+ * Before the upgrade starts, the patch is run once without writing anything,
+ * and the hash of its result checked against the target hash TLV, so that a
+ * delta that does not apply to the primary slot is rejected while the base
+ * is still intact.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bootutil/bootutil.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/crypto/sha.h"
+#include "bootutil/image.h"
+#include "bootutil_priv.h"
+
+#include "mcuboot_config/mcuboot_config.h"
+
+BOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#ifdef MCUBOOT_DELTA_UPGRADE
+
+#ifndef MCUBOOT_DELTA_WINDOW_SIZE
+#define MCUBOOT_DELTA_WINDOW_SIZE 4096
+#endif
+
+/* See loader.c. */
+#if !defined(__BOOTSIM__)
+#define TARGET_STATIC static
+#else
+#define TARGET_STATIC
+#endif
+
+/* A record starts with three LEB128 values of at most 5 bytes. */
+#define BOOT_DELTA_REC_HDR_MAX      15
+
+/* Journal entries of window k. */
+#define BOOT_DELTA_WRITTEN(k)       (2 * (k))
+#define BOOT_DELTA_STASHED(k)       (2 * (k) + 1)
+
+struct boot_delta {
+    struct boot_loader_state *state;
+    const struct flash_area *fap_pri;
+    const struct flash_area *fap_sec;
+    const struct image_header *hdr; /* Header of the delta image. */
+    uint32_t target_size;
+    uint32_t window_size;
+    uint32_t num_windows;
+    uint32_t base_end;      /* End of the base that may be copied from. */
+    uint32_t stash_off;     /* Stash, in the secondary slot. */
+    uint32_t stash_sz;
+    uint32_t hash_sz;       /* Size of the hashed part of the target. */
+
+    /* Patch decoder. */
+    uint32_t patch_off;     /* Next byte of the patch. */
+    uint32_t patch_end;
+    uint32_t base_off;      /* Base position of the next record. */
+    uint32_t copy_off;      /* Next base byte to copy. */
+    uint32_t copy_left;
+    uint32_t insert_left;
+};
+
+/**
+ * Reads the parameters of the delta image in the secondary slot, and checks
+ * that the slots have room for its windows, its stash and its journal.
+ *
+ * @param d                     Receives the parameters.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_delta_init(struct boot_loader_state *state, struct boot_delta *d)
+{
+    struct image_delta_info info;
+    struct image_tlv_iter it;
+    struct flash_sector sector;
+    uint32_t off;
+    uint32_t end;
+    uint16_t len;
+    size_t sect;
+    int rc;
+
+    memset(d, 0, sizeof(*d));
+    d->state = state;
+    d->fap_pri = BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT);
+    d->fap_sec = BOOT_IMG_AREA(state, BOOT_SECONDARY_SLOT);
+    d->hdr = boot_img_hdr(state, BOOT_SECONDARY_SLOT);
+
+    if (IS_ENCRYPTED(d->hdr)) {
+        BOOT_LOG_ERR("Encrypted delta images are not supported");
+        return BOOT_EBADIMAGE;
+    }
+
+    len = sizeof(info);
+    rc = bootutil_tlv_read(d->hdr, d->fap_sec, IMAGE_TLV_DELTA_INFO, true,
+                           &info, &len);
+    if (rc != 0 || len != sizeof(info)) {
+        BOOT_LOG_ERR("Delta image without parameters");
+        return BOOT_EBADIMAGE;
+    }
+
+    d->target_size = info.idi_target_size;
+    d->window_size = info.idi_window_size;
+    if (d->window_size < sizeof(struct image_header) ||
+        d->window_size > MCUBOOT_DELTA_WINDOW_SIZE ||
+        d->window_size % BOOT_WRITE_SZ(state) != 0) {
+        BOOT_LOG_ERR("Unsupported delta window size: 0x%lx",
+                     (unsigned long)d->window_size);
+        return BOOT_EBADIMAGE;
+    }
+
+    /* The target must end before the trailer, which holds the journal. */
+    rc = boot_copy_journal_trailer_off(d->fap_pri, &d->base_end);
+    if (rc != 0) {
+        return rc;
+    }
+    if (d->target_size < sizeof(struct image_header) ||
+        d->target_size > d->base_end) {
+        BOOT_LOG_ERR("Delta target does not fit in the primary slot");
+        return BOOT_EBADIMAGE;
+    }
+
+    d->num_windows = (d->target_size + d->window_size - 1) / d->window_size;
+    if (BOOT_DELTA_STASHED(d->num_windows - 1) >=
+            boot_copy_journal_entries(state, d->fap_pri)) {
+        BOOT_LOG_ERR("Too many delta windows: %lu",
+                     (unsigned long)d->num_windows);
+        return BOOT_EBADIMAGE;
+    }
+
+    /* Each window is erased on its own. */
+    if (boot_device_requires_erase(d->fap_pri)) {
+        for (sect = 0; sect < boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
+             sect++) {
+            off = boot_img_sector_off(state, BOOT_PRIMARY_SLOT, sect);
+            if (off >= d->target_size) {
+                break;
+            }
+            end = off + boot_img_sector_size(state, BOOT_PRIMARY_SLOT, sect);
+            if (off / d->window_size != (end - 1) / d->window_size) {
+                BOOT_LOG_ERR("Delta window splits the sector at 0x%lx",
+                             (unsigned long)off);
+                return BOOT_EBADIMAGE;
+            }
+        }
+    }
+
+    /* The stash takes the sectors before the secondary slot's trailer. */
+    rc = flash_area_get_sector(d->fap_sec, boot_status_off(d->fap_sec),
+                               &sector);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+    end = flash_sector_get_off(&sector);
+    if (end < d->window_size) {
+        BOOT_LOG_ERR("No room for the delta stash");
+        return BOOT_EBADIMAGE;
+    }
+    d->stash_off = end - d->window_size;
+    if (boot_device_requires_erase(d->fap_sec)) {
+        rc = flash_area_get_sector(d->fap_sec, d->stash_off, &sector);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+        d->stash_off = flash_sector_get_off(&sector);
+    }
+    d->stash_sz = end - d->stash_off;
+
+    rc = bootutil_tlv_iter_begin(&it, d->hdr, d->fap_sec, IMAGE_TLV_ANY,
+                                 false);
+    if (rc != 0) {
+        return BOOT_EBADIMAGE;
+    }
+    if (boot_img_hdr_off(d->fap_sec) + it.tlv_end > d->stash_off) {
+        BOOT_LOG_ERR("Delta image overlaps its stash");
+        return BOOT_EBADIMAGE;
+    }
+
+    return 0;
+}
+
+/**
+ * Checks whether the journal in the primary slot belongs to an interrupted
+ * run of this delta.
+ */
+static bool
+boot_delta_in_progress(struct boot_delta *d)
+{
+    if (!boot_copy_journal_matches(d->state, d->fap_pri, d->target_size)) {
+        return false;
+    }
+
+    return boot_copy_journal_read_entry(d->state, d->fap_pri,
+                                        BOOT_DELTA_WRITTEN(0)) == 1 ||
+           boot_copy_journal_read_entry(d->state, d->fap_pri,
+                                        BOOT_DELTA_STASHED(0)) == 1;
+}
+
+/**
+ * Checks that the image in the primary slot is the base of the delta.
+ */
+static bool
+boot_delta_base_matches(struct boot_delta *d)
+{
+    const struct image_header *hdr_pri;
+    uint8_t base[IMAGE_HASH_SIZE];
+    uint8_t hash[IMAGE_HASH_SIZE];
+    uint16_t len;
+    int rc;
+
+    hdr_pri = boot_img_hdr(d->state, BOOT_PRIMARY_SLOT);
+    if (hdr_pri->ih_magic != IMAGE_MAGIC) {
+        return false;
+    }
+
+    len = sizeof(base);
+    rc = bootutil_tlv_read(d->hdr, d->fap_sec, IMAGE_TLV_DELTA_BASE, true,
+                           base, &len);
+    if (rc != 0 || len != sizeof(base)) {
+        return false;
+    }
+
+    len = sizeof(hash);
+    rc = bootutil_tlv_read(hdr_pri, d->fap_pri, EXPECTED_HASH_TLV, false,
+                           hash, &len);
+    if (rc != 0 || len != sizeof(hash)) {
+        return false;
+    }
+
+    return memcmp(base, hash, sizeof(hash)) == 0;
+}
+
+/**
+ * Checks the hash of the result of the patch against the target hash TLV.
+ */
+static int
+boot_delta_check_target(struct boot_delta *d, const uint8_t *hash)
+{
+    uint8_t target[IMAGE_HASH_SIZE];
+    uint16_t len;
+    int rc;
+
+    len = sizeof(target);
+    rc = bootutil_tlv_read(d->hdr, d->fap_sec, IMAGE_TLV_DELTA_TARGET, true,
+                           target, &len);
+    if (rc != 0 || len != sizeof(target) ||
+        memcmp(target, hash, sizeof(target)) != 0) {
+        BOOT_LOG_ERR("Image %d delta result does not match its hash",
+                     BOOT_CURR_IMG(d->state));
+        return BOOT_EBADIMAGE;
+    }
+
+    return 0;
+}
+
+/* Decodes a LEB128 value of at most 32 bits. */
+static int
+boot_delta_leb128(const uint8_t *buf, size_t len, size_t *pos, uint32_t *val)
+{
+    uint32_t shift;
+    uint8_t byte;
+
+    *val = 0;
+    for (shift = 0; shift <= 28; shift += 7) {
+        if (*pos >= len) {
+            return -1;
+        }
+        byte = buf[(*pos)++];
+        if (shift == 28 && (byte & 0xf0) != 0) {
+            return -1;
+        }
+        *val |= (uint32_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/* Reads the next record of the patch. */
+static int
+boot_delta_next_record(struct boot_delta *d)
+{
+    uint8_t buf[BOOT_DELTA_REC_HDR_MAX];
+    uint32_t copy;
+    uint32_t insert;
+    uint32_t seek;
+    int64_t next;
+    size_t len;
+    size_t pos;
+    int rc;
+
+    len = d->patch_end - d->patch_off;
+    if (len > sizeof(buf)) {
+        len = sizeof(buf);
+    }
+
+    rc = flash_area_read(d->fap_sec, d->patch_off, buf, len);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    pos = 0;
+    if (boot_delta_leb128(buf, len, &pos, &copy) != 0 ||
+        boot_delta_leb128(buf, len, &pos, &insert) != 0 ||
+        boot_delta_leb128(buf, len, &pos, &seek) != 0) {
+        return BOOT_EBADIMAGE;
+    }
+    d->patch_off += pos;
+
+    if (insert > d->patch_end - d->patch_off ||
+        copy > d->base_end - d->base_off) {
+        return BOOT_EBADIMAGE;
+    }
+
+    /* Zigzag encoding: 0, -1, 1, -2, ... */
+    next = (int64_t)d->base_off + copy;
+    if (seek & 1) {
+        next -= (int64_t)(seek >> 1) + 1;
+    } else {
+        next += seek >> 1;
+    }
+    if (next < 0 || next > d->base_end) {
+        return BOOT_EBADIMAGE;
+    }
+
+    d->copy_off = d->base_off;
+    d->copy_left = copy;
+    d->insert_left = insert;
+    d->base_off = (uint32_t)next;
+
+    return 0;
+}
+
+/**
+ * Runs the patch over the next window of the target.
+ *
+ * @param win_off               The offset of the window.
+ * @param win_sz                The size of the window.
+ * @param buf                   Receives the window, or NULL to only skip it.
+ * @param self_ref              Set if the window copies from its own range
+ *                                  of the base.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_delta_fill(struct boot_delta *d, uint32_t win_off, uint32_t win_sz,
+                uint8_t *buf, bool *self_ref)
+{
+    uint32_t chunk;
+    uint32_t n;
+    int rc;
+
+    *self_ref = false;
+    for (n = 0; n < win_sz; n += chunk) {
+        chunk = win_sz - n;
+
+        if (d->copy_left == 0 && d->insert_left == 0) {
+            if (d->patch_off == d->patch_end) {
+                return BOOT_EBADIMAGE;
+            }
+            rc = boot_delta_next_record(d);
+            if (rc != 0) {
+                return rc;
+            }
+            chunk = 0;
+        } else if (d->copy_left != 0) {
+            if (chunk > d->copy_left) {
+                chunk = d->copy_left;
+            }
+            if (buf != NULL) {
+                /* The base before the window is overwritten already. */
+                if (d->copy_off < win_off) {
+                    return BOOT_EBADIMAGE;
+                }
+                if (d->copy_off < win_off + d->window_size) {
+                    *self_ref = true;
+                }
+                rc = flash_area_read(d->fap_pri, d->copy_off, buf + n, chunk);
+                if (rc != 0) {
+                    return BOOT_EFLASH;
+                }
+            }
+            d->copy_off += chunk;
+            d->copy_left -= chunk;
+        } else {
+            if (chunk > d->insert_left) {
+                chunk = d->insert_left;
+            }
+            if (buf != NULL) {
+                rc = flash_area_read(d->fap_sec, d->patch_off, buf + n, chunk);
+                if (rc != 0) {
+                    return BOOT_EFLASH;
+                }
+            }
+            d->patch_off += chunk;
+            d->insert_left -= chunk;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Writes a window of the target to the primary slot.
+ *
+ * @param win                   The index of the window.
+ * @param buf                   The window, with room for padding it up to
+ *                                  the window size.
+ * @param win_sz                The size of the window.
+ * @param stash                 Whether to stash the window first.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_delta_write_window(struct boot_delta *d, uint32_t win, uint8_t *buf,
+                        uint32_t win_sz, bool stash)
+{
+    struct flash_sector sector;
+    uint32_t win_off;
+    uint32_t len;
+    int rc;
+
+    win_off = win * d->window_size;
+    len = ALIGN_UP(win_sz, BOOT_WRITE_SZ(d->state));
+    memset(buf + win_sz, flash_area_erased_val(d->fap_pri), len - win_sz);
+
+    if (stash) {
+        rc = boot_erase_region_if_required(d->fap_sec, d->stash_off,
+                                           d->stash_sz);
+        if (rc == 0) {
+            rc = flash_area_write(d->fap_sec, d->stash_off, buf, len);
+        }
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+
+        rc = boot_copy_journal_write(d->state, d->fap_pri,
+                                     BOOT_DELTA_STASHED(win));
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    bootutil_tlv_index_invalidate(d->fap_pri);
+
+    /* Only the last window may end in the middle of a sector. */
+    rc = flash_area_get_sector(d->fap_pri, win_off + win_sz - 1, &sector);
+    if (rc == 0) {
+        rc = boot_erase_region_if_required(d->fap_pri, win_off,
+                                           flash_sector_get_off(&sector) +
+                                           flash_sector_get_size(&sector) -
+                                           win_off);
+    }
+    if (rc == 0) {
+        rc = flash_area_write(d->fap_pri, win_off, buf, len);
+    }
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    return boot_copy_journal_write(d->state, d->fap_pri,
+                                   BOOT_DELTA_WRITTEN(win));
+}
+
+/**
+ * Produces the target from the start, hashing it.
+ *
+ * @param done                  The number of windows already written to the
+ *                                  primary slot.
+ * @param stashed               Whether window `done` has been stashed.
+ * @param write                 Whether to write the target to the primary
+ *                                  slot, or to only hash it.
+ * @param hash                  Receives the hash of the target.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_delta_run(struct boot_delta *d, uint32_t done, bool stashed, bool write,
+               uint8_t *hash)
+{
+    const struct image_header *target;
+    bootutil_sha_context sha;
+    uint32_t win_off;
+    uint32_t win_sz;
+    uint32_t win;
+    bool self_ref;
+    bool replay;
+    int rc;
+
+    TARGET_STATIC uint8_t buf[MCUBOOT_DELTA_WINDOW_SIZE]
+        __attribute__((aligned(4)));
+
+    d->patch_off = boot_img_hdr_off(d->fap_sec) + d->hdr->ih_hdr_size;
+    d->patch_end = d->patch_off + d->hdr->ih_img_size;
+    d->base_off = 0;
+    d->copy_left = 0;
+    d->insert_left = 0;
+    d->hash_sz = 0;
+
+    bootutil_sha_init(&sha);
+
+    for (win = 0; win < d->num_windows; win++) {
+        win_off = win * d->window_size;
+        win_sz = d->target_size - win_off;
+        if (win_sz > d->window_size) {
+            win_sz = d->window_size;
+        }
+
+        replay = write && (win < done || (win == done && stashed));
+        rc = boot_delta_fill(d, win_off, win_sz, replay ? NULL : buf,
+                             &self_ref);
+        if (rc != 0) {
+            goto out;
+        }
+
+        if (replay) {
+            if (win < done) {
+                rc = flash_area_read(d->fap_pri, win_off, buf, win_sz);
+            } else {
+                rc = flash_area_read(d->fap_sec, d->stash_off, buf, win_sz);
+            }
+            if (rc != 0) {
+                rc = BOOT_EFLASH;
+                goto out;
+            }
+        }
+
+        /* Window 0 is always stashed, so that the journal shows the run
+         * started before the base header gets erased.
+         */
+        if (write && win >= done) {
+            rc = boot_delta_write_window(d, win, buf, win_sz,
+                                         (self_ref || win == 0) && !replay);
+            if (rc != 0) {
+                goto out;
+            }
+        }
+
+        if (win == 0) {
+            target = (const struct image_header *)buf;
+            d->hash_sz = BOOT_TLV_OFF(target) + target->ih_protect_tlv_size;
+            if (target->ih_magic != IMAGE_MAGIC ||
+                d->hash_sz > d->target_size) {
+                rc = BOOT_EBADIMAGE;
+                goto out;
+            }
+        }
+
+        if (win_off < d->hash_sz) {
+            bootutil_sha_update(&sha, buf,
+                                (d->hash_sz - win_off < win_sz) ?
+                                d->hash_sz - win_off : win_sz);
+        }
+
+        MCUBOOT_WATCHDOG_FEED();
+    }
+
+    /* The patch must end with the target. */
+    if (d->copy_left != 0 || d->insert_left != 0 ||
+        d->patch_off != d->patch_end) {
+        rc = BOOT_EBADIMAGE;
+        goto out;
+    }
+
+    bootutil_sha_finish(&sha, hash);
+    rc = 0;
+
+out:
+    bootutil_sha_drop(&sha);
+    return rc;
+}
+
+/**
+ * Checks that the delta image in the secondary slot can be applied to the
+ * primary slot: either its base is there and the patch produces its target,
+ * or an interrupted run of it is to be resumed.
+ *
+ * @return                      0 if the delta can be applied; nonzero
+ *                                  otherwise.
+ */
+int
+boot_delta_check(struct boot_loader_state *state)
+{
+    struct boot_delta d;
+    uint8_t hash[IMAGE_HASH_SIZE];
+    int rc;
+
+    rc = boot_delta_init(state, &d);
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* The base of an interrupted run is partly overwritten already. */
+    if (boot_delta_in_progress(&d)) {
+        return 0;
+    }
+
+    if (!boot_delta_base_matches(&d)) {
+        BOOT_LOG_ERR("Image %d delta does not apply to the primary slot",
+                     BOOT_CURR_IMG(state));
+        return BOOT_EBADIMAGE;
+    }
+
+    rc = boot_delta_run(&d, 0, false, false, hash);
+    if (rc != 0) {
+        return rc;
+    }
+
+    return boot_delta_check_target(&d, hash);
+}
+
+/**
+ * Applies the delta image in the secondary slot to the primary slot, or
+ * resumes an interrupted run. The delta must have passed
+ * `boot_delta_check()`.
+ *
+ * @param size                  On success, the size of the target.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_delta_apply(struct boot_loader_state *state, uint32_t *size)
+{
+    struct boot_delta d;
+    uint8_t hash[IMAGE_HASH_SIZE];
+    uint32_t done;
+    bool stashed;
+    int rc;
+
+    rc = boot_delta_init(state, &d);
+    if (rc != 0) {
+        return rc;
+    }
+
+    done = 0;
+    stashed = false;
+    if (boot_delta_in_progress(&d)) {
+        while (done < d.num_windows &&
+               boot_copy_journal_read_entry(state, d.fap_pri,
+                                            BOOT_DELTA_WRITTEN(done)) == 1) {
+            done++;
+        }
+        stashed = done < d.num_windows &&
+                  boot_copy_journal_read_entry(state, d.fap_pri,
+                                               BOOT_DELTA_STASHED(done)) == 1;
+        BOOT_LOG_INF("Image %d resuming the delta after %lu of %lu windows",
+                     BOOT_CURR_IMG(state), (unsigned long)done,
+                     (unsigned long)d.num_windows);
+    } else {
+        rc = boot_copy_journal_start(state, d.fap_pri, d.target_size);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    BOOT_LOG_INF("Image %d applying a delta: 0x%lx bytes",
+                 BOOT_CURR_IMG(state), (unsigned long)d.target_size);
+    rc = boot_delta_run(&d, done, stashed, true, hash);
+    if (rc == 0) {
+        rc = boot_delta_check_target(&d, hash);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+#ifdef MCUBOOT_HASH_ON_COPY
+    /* Validating the primary slot reuses the hash of the target. */
+    boot_copy_hash_set(state, hash, d.hash_sz);
+#endif
+
+    *size = d.target_size;
+    return 0;
+}
+
+#endif /* MCUBOOT_DELTA_UPGRADE */
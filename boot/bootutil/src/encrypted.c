@@ -610,7 +610,6 @@ boot_enc_load(struct enc_key_data *enc_state, int image_index,
 {
     uint32_t off;
     uint16_t len;
-    struct image_tlv_iter it;
 #if MCUBOOT_SWAP_SAVE_ENCTLV
     uint8_t *buf;
 #else
@@ -633,12 +632,7 @@ boot_enc_load(struct enc_key_data *enc_state, int image_index,
     /* Initialize the AES context */
     boot_enc_init(enc_state, slot);
 
-    rc = bootutil_tlv_iter_begin(&it, hdr, fap, EXPECTED_ENC_TLV, false);
-    if (rc) {
-        return -1;
-    }
-
-    rc = bootutil_tlv_iter_next(&it, &off, &len, NULL);
+    rc = bootutil_tlv_find(hdr, fap, EXPECTED_ENC_TLV, false, &off, &len);
     if (rc != 0) {
         return rc;
     }
@@ -652,12 +646,17 @@ boot_enc_load(struct enc_key_data *enc_state, int image_index,
     memset(buf, 0xff, BOOT_ENC_TLV_ALIGN_SIZE);
 #endif
 
-    rc = flash_area_read(fap, off, buf, EXPECTED_ENC_LEN);
+    rc = flash_area_read(fap, boot_img_hdr_off(fap) + off, buf,
+                         EXPECTED_ENC_LEN);
     if (rc) {
         return -1;
     }
 
-    return boot_enc_decrypt(buf, bs->enckey[slot]);
+    BOOT_PHASE_BEGIN(BOOT_PHASE_ENC_KEY_LOAD);
+    rc = boot_enc_decrypt(buf, bs->enckey[slot]);
+    BOOT_PHASE_END(BOOT_PHASE_ENC_KEY_LOAD, EXPECTED_ENC_LEN);
+
+    return rc;
 }
 
 bool
@@ -676,21 +675,17 @@ boot_enc_valid(struct enc_key_data *enc_state, int image_index,
     return enc_state[rc].valid;
 }
 
-void
-boot_encrypt(struct enc_key_data *enc_state, int image_index,
-        const struct flash_area *fap, uint32_t off, uint32_t sz,
-        uint32_t blk_off, uint8_t *buf)
+/*
+ * Returns the AES-CTR context of the slot of `fap`, and sets `nonce` to the
+ * counter of the block at `off` bytes into the payload.
+ */
+static bootutil_aes_ctr_context *
+boot_enc_ctr(struct enc_key_data *enc_state, int image_index,
+        const struct flash_area *fap, uint32_t off, uint8_t *nonce)
 {
     struct enc_key_data *enc;
-    uint8_t nonce[16];
     int rc;
 
-    /* boot_copy_region will call boot_encrypt with sz = 0 when skipping over
-       the TLVs. */
-    if (sz == 0) {
-       return;
-    }
-
     memset(nonce, 0, 12);
     off >>= 4;
     nonce[12] = (uint8_t)(off >> 24);
@@ -701,12 +696,73 @@ boot_encrypt(struct enc_key_data *enc_state, int image_index,
     rc = flash_area_id_to_multi_image_slot(image_index, flash_area_get_id(fap));
     if (rc < 0) {
         assert(0);
-        return;
+        return NULL;
     }
 
     enc = &enc_state[rc];
     assert(enc->valid == 1);
-    bootutil_aes_ctr_encrypt(&enc->aes_ctr, nonce, buf, sz, blk_off, buf);
+    return &enc->aes_ctr;
+}
+
+void
+boot_encrypt(struct enc_key_data *enc_state, int image_index,
+        const struct flash_area *fap, uint32_t off, uint32_t sz,
+        uint32_t blk_off, uint8_t *buf)
+{
+    bootutil_aes_ctr_context *ctx;
+    uint8_t nonce[16];
+
+    /* boot_copy_region will call boot_encrypt with sz = 0 when skipping over
+       the TLVs. */
+    if (sz == 0) {
+       return;
+    }
+
+    ctx = boot_enc_ctr(enc_state, image_index, fap, off, nonce);
+    if (ctx == NULL) {
+        return;
+    }
+
+    bootutil_aes_ctr_encrypt(ctx, nonce, buf, sz, blk_off, buf);
+}
+
+/*
+ * As `boot_encrypt()`, but the operation may complete in the background;
+ * `buf` must not be touched until `boot_crypto_req_wait()` has returned.
+ */
+int
+boot_encrypt_start(struct boot_crypto_req *req,
+        struct enc_key_data *enc_state, int image_index,
+        const struct flash_area *fap, uint32_t off, uint32_t sz,
+        uint32_t blk_off, uint8_t *buf)
+{
+    bootutil_aes_ctr_context *ctx;
+    int rc;
+
+    if (sz == 0) {
+        return 0;
+    }
+
+    ctx = boot_enc_ctr(enc_state, image_index, fap, off, req->counter);
+    if (ctx == NULL) {
+        req->rc = -1;
+        return -1;
+    }
+
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+    req->aes.done = boot_crypto_aes_done;
+    rc = boot_crypto_aes_ctr_submit(&req->aes, ctx, req->counter, buf, sz,
+                                    blk_off, buf);
+    if (rc == 0) {
+        req->last = &req->aes;
+    }
+#else
+    rc = bootutil_aes_ctr_encrypt(ctx, req->counter, buf, sz, blk_off, buf);
+#endif
+    if (rc != 0) {
+        req->rc = rc;
+    }
+    return rc;
 }
 
 /**
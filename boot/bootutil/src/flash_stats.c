@@ -0,0 +1,292 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_FLASH_STATS
+
+/* This file calls the flash map backend itself. */
+#define BOOT_FLASH_STATS_NO_WRAP
+
+#include <flash_map_backend/flash_map_backend.h>
+
+#include "bootutil/bench.h"
+#include "bootutil/bootutil_log.h"
+#include "bootutil/flash_stats.h"
+
+BOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#ifdef MCUBOOT_USE_BENCH
+#define BOOT_FLASH_STATS_NOW() plat_bench_cycles()
+#else
+#define BOOT_FLASH_STATS_NOW() 0
+#endif
+
+#ifdef __BOOTSIM__
+/* The simulator runs its tests in parallel threads. */
+static __thread struct boot_flash_area_stats
+    boot_flash_stats[MCUBOOT_FLASH_STATS_MAX_AREAS];
+static __thread uint32_t boot_flash_stats_untracked;
+#else
+static struct boot_flash_area_stats
+    boot_flash_stats[MCUBOOT_FLASH_STATS_MAX_AREAS];
+static uint32_t boot_flash_stats_untracked;
+#endif
+
+static const char *const boot_flash_op_names[BOOT_FLASH_OP_MAX] = {
+    [BOOT_FLASH_OP_READ] = "read",
+    [BOOT_FLASH_OP_WRITE] = "write",
+    [BOOT_FLASH_OP_ERASE] = "erase",
+};
+
+void
+boot_flash_stats_reset(void)
+{
+    memset(boot_flash_stats, 0, sizeof(boot_flash_stats));
+    boot_flash_stats_untracked = 0;
+}
+
+const struct boot_flash_area_stats *
+boot_flash_stats_get(uint8_t fa_id)
+{
+    size_t i;
+
+    for (i = 0; i < MCUBOOT_FLASH_STATS_MAX_AREAS; i++) {
+        if (boot_flash_stats[i].used && boot_flash_stats[i].fa_id == fa_id) {
+            return &boot_flash_stats[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct boot_flash_op_stats *
+boot_flash_stats_find(const struct flash_area *fa, enum boot_flash_op op)
+{
+    uint8_t fa_id = (uint8_t)flash_area_get_id(fa);
+    size_t i;
+
+    for (i = 0; i < MCUBOOT_FLASH_STATS_MAX_AREAS; i++) {
+        if (!boot_flash_stats[i].used) {
+            boot_flash_stats[i].used = 1;
+            boot_flash_stats[i].fa_id = fa_id;
+        }
+        if (boot_flash_stats[i].fa_id == fa_id) {
+            return &boot_flash_stats[i].ops[op];
+        }
+    }
+
+    /* More areas than MCUBOOT_FLASH_STATS_MAX_AREAS. */
+    boot_flash_stats_untracked++;
+    return NULL;
+}
+
+/* Returns floor(log2(val)), capped to the last histogram bucket. */
+static uint8_t
+boot_flash_stats_bucket(uint32_t val)
+{
+    uint8_t bucket = 0;
+
+    while (val > 1 && bucket < BOOT_FLASH_STATS_BUCKETS - 1) {
+        val >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/* Returns the number of trailing zero bits of off, capped to the last
+ * histogram bucket. */
+static uint8_t
+boot_flash_stats_align_bucket(uint32_t off)
+{
+    uint8_t bucket = 0;
+
+    while (!(off & 1) && bucket < BOOT_FLASH_STATS_BUCKETS - 1) {
+        off >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+static void
+boot_flash_stats_add(const struct flash_area *fa, enum boot_flash_op op,
+                     uint32_t off, uint32_t len, uint32_t start, int rc)
+{
+    struct boot_flash_op_stats *st;
+    uint32_t cycles = (uint32_t)BOOT_FLASH_STATS_NOW() - start;
+
+    st = boot_flash_stats_find(fa, op);
+    if (st == NULL) {
+        return;
+    }
+
+    st->calls++;
+    st->bytes += len;
+    st->cycles += cycles;
+    if (rc != 0) {
+        st->errors++;
+    }
+    st->size_hist[boot_flash_stats_bucket(len)]++;
+    st->align_hist[boot_flash_stats_align_bucket(off)]++;
+}
+
+int
+boot_flash_stats_read(const struct flash_area *fa, uint32_t off,
+                      void *dst, uint32_t len)
+{
+    uint32_t start = BOOT_FLASH_STATS_NOW();
+    int rc;
+
+    rc = flash_area_read(fa, off, dst, len);
+    boot_flash_stats_add(fa, BOOT_FLASH_OP_READ, off, len, start, rc);
+
+    return rc;
+}
+
+int
+boot_flash_stats_write(const struct flash_area *fa, uint32_t off,
+                       const void *src, uint32_t len)
+{
+    uint32_t start = BOOT_FLASH_STATS_NOW();
+    int rc;
+
+    rc = flash_area_write(fa, off, src, len);
+    boot_flash_stats_add(fa, BOOT_FLASH_OP_WRITE, off, len, start, rc);
+
+    return rc;
+}
+
+int
+boot_flash_stats_erase(const struct flash_area *fa, uint32_t off,
+                       uint32_t len)
+{
+    uint32_t start = BOOT_FLASH_STATS_NOW();
+    int rc;
+
+    rc = flash_area_erase(fa, off, len);
+    boot_flash_stats_add(fa, BOOT_FLASH_OP_ERASE, off, len, start, rc);
+
+    return rc;
+}
+
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+/* A split read counts as one read call; the time spent waiting for it is
+ * added to the time of the reads. */
+int
+boot_flash_stats_read_start(const struct flash_area *fa, uint32_t off,
+                            void *dst, uint32_t len)
+{
+    uint32_t start = BOOT_FLASH_STATS_NOW();
+    int rc;
+
+    rc = flash_area_read_start(fa, off, dst, len);
+    boot_flash_stats_add(fa, BOOT_FLASH_OP_READ, off, len, start, rc);
+
+    return rc;
+}
+
+int
+boot_flash_stats_read_wait(const struct flash_area *fa)
+{
+    struct boot_flash_op_stats *st;
+    uint32_t start = BOOT_FLASH_STATS_NOW();
+    int rc;
+
+    rc = flash_area_read_wait(fa);
+
+    st = boot_flash_stats_find(fa, BOOT_FLASH_OP_READ);
+    if (st != NULL) {
+        st->cycles += (uint32_t)BOOT_FLASH_STATS_NOW() - start;
+        if (rc != 0) {
+            st->errors++;
+        }
+    }
+
+    return rc;
+}
+#endif /* MCUBOOT_FLASH_AREA_ASYNC_READ */
+
+/* Formats the non-empty buckets of a histogram as "<2^i>:<count> ...". */
+static void
+boot_flash_stats_format_hist(char *buf, size_t size, const uint32_t *hist)
+{
+    size_t used = 0;
+    int n;
+    int i;
+
+    buf[0] = '\0';
+    for (i = 0; i < BOOT_FLASH_STATS_BUCKETS && used < size; i++) {
+        if (hist[i] == 0) {
+            continue;
+        }
+        n = snprintf(buf + used, size - used, " %lu:%lu",
+                     1UL << i, (unsigned long)hist[i]);
+        if (n < 0) {
+            break;
+        }
+        used += (size_t)n;
+    }
+}
+
+void
+boot_flash_stats_dump(void)
+{
+    const struct boot_flash_op_stats *st;
+    char hist[BOOT_FLASH_STATS_BUCKETS * 16];
+    size_t i;
+    int op;
+
+    for (i = 0; i < MCUBOOT_FLASH_STATS_MAX_AREAS; i++) {
+        if (!boot_flash_stats[i].used) {
+            continue;
+        }
+
+        for (op = 0; op < BOOT_FLASH_OP_MAX; op++) {
+            st = &boot_flash_stats[i].ops[op];
+            if (st->calls == 0) {
+                continue;
+            }
+
+            BOOT_LOG_INF("Flash area %u %s: %lu calls, %lu bytes, "
+                         "%lu cycles, %lu errors",
+                         boot_flash_stats[i].fa_id, boot_flash_op_names[op],
+                         (unsigned long)st->calls, (unsigned long)st->bytes,
+                         (unsigned long)st->cycles,
+                         (unsigned long)st->errors);
+
+            boot_flash_stats_format_hist(hist, sizeof(hist), st->size_hist);
+            BOOT_LOG_INF("  sizes:%s", hist);
+            boot_flash_stats_format_hist(hist, sizeof(hist), st->align_hist);
+            BOOT_LOG_INF("  alignments:%s", hist);
+        }
+    }
+
+    if (boot_flash_stats_untracked != 0) {
+        BOOT_LOG_INF("Flash calls of untracked areas: %lu",
+                     (unsigned long)boot_flash_stats_untracked);
+    }
+}
+
+#endif /* MCUBOOT_FLASH_STATS */
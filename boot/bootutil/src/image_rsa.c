@@ -41,6 +41,15 @@
  * while for other crypto backends we need to implement each step at this
  * abstraction level
  */
+#if defined(MCUBOOT_RSA_PREPARSED_KEYS)
+#if defined(MCUBOOT_USE_PSA_CRYPTO)
+#error "MCUBOOT_RSA_PREPARSED_KEYS is not supported with MCUBOOT_USE_PSA_CRYPTO"
+#endif
+#if defined(MCUBOOT_HW_KEY)
+#error "MCUBOOT_RSA_PREPARSED_KEYS is not supported with MCUBOOT_HW_KEY"
+#endif
+#endif
+
 #if !defined(MCUBOOT_USE_PSA_CRYPTO)
 
 #include "bootutil/crypto/sha.h"
@@ -112,14 +121,123 @@ pss_mgf1(uint8_t *mask, const uint8_t *hash)
     bootutil_sha_drop(&ctx);
 }
 
+#if defined(MCUBOOT_RSA_PREPARSED_KEYS)
+/*
+ * Montgomery multiplication, r = a * b / R mod N, with R = 2^(32 * limbs)
+ * (CIOS). r may alias a or b.
+ */
+static void
+rsa_mont_mul(uint32_t *r, const uint32_t *a, const uint32_t *b,
+             const struct bootutil_rsa_pub_key *key)
+{
+    uint32_t t[BOOTUTIL_RSA_LIMBS + 2];
+    uint64_t c;
+    uint32_t m;
+    uint32_t borrow;
+    int i;
+    int j;
+
+    memset(t, 0, sizeof(t));
+
+    for (i = 0; i < BOOTUTIL_RSA_LIMBS; i++) {
+        /* t += a * b[i] */
+        c = 0;
+        for (j = 0; j < BOOTUTIL_RSA_LIMBS; j++) {
+            c += (uint64_t)a[j] * b[i] + t[j];
+            t[j] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[BOOTUTIL_RSA_LIMBS];
+        t[BOOTUTIL_RSA_LIMBS] = (uint32_t)c;
+        t[BOOTUTIL_RSA_LIMBS + 1] = (uint32_t)(c >> 32);
+
+        /* t = (t + m * N) / 2^32, m chosen so the low limb cancels */
+        m = t[0] * key->n0inv;
+        c = ((uint64_t)m * key->n[0] + t[0]) >> 32;
+        for (j = 1; j < BOOTUTIL_RSA_LIMBS; j++) {
+            c += (uint64_t)m * key->n[j] + t[j];
+            t[j - 1] = (uint32_t)c;
+            c >>= 32;
+        }
+        c += t[BOOTUTIL_RSA_LIMBS];
+        t[BOOTUTIL_RSA_LIMBS - 1] = (uint32_t)c;
+        t[BOOTUTIL_RSA_LIMBS] = t[BOOTUTIL_RSA_LIMBS + 1] + (uint32_t)(c >> 32);
+    }
+
+    /* t < 2N: subtract N once if t >= N */
+    borrow = 0;
+    for (j = 0; j < BOOTUTIL_RSA_LIMBS; j++) {
+        c = (uint64_t)t[j] - key->n[j] - borrow;
+        r[j] = (uint32_t)c;
+        borrow = (uint32_t)(c >> 32) & 1;
+    }
+    if (t[BOOTUTIL_RSA_LIMBS] < borrow) {
+        /* t < N, keep it */
+        memcpy(r, t, BOOTUTIL_RSA_LIMBS * sizeof(uint32_t));
+    }
+}
+
+/*
+ * RSAVP1 with a pre-decoded key: em = sig^65537 mod N. Returns nonzero if
+ * the signature is not below N.
+ */
+static int
+bootutil_rsa_public_preparsed(const struct bootutil_rsa_pub_key *key,
+                              const uint8_t *sig, uint8_t *em)
+{
+    uint32_t a[BOOTUTIL_RSA_LIMBS];
+    uint32_t x[BOOTUTIL_RSA_LIMBS];
+    const uint8_t *p;
+    uint8_t *q;
+    int i;
+
+    for (i = 0; i < BOOTUTIL_RSA_LIMBS; i++) {
+        p = &sig[PSS_EMLEN - 4 * (i + 1)];
+        a[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+               ((uint32_t)p[2] << 8) | p[3];
+    }
+
+    for (i = BOOTUTIL_RSA_LIMBS - 1; i >= 0; i--) {
+        if (a[i] != key->n[i]) {
+            break;
+        }
+    }
+    if (i < 0 || a[i] > key->n[i]) {
+        return -1;
+    }
+
+    /* x = a * R, then a^(2^16) * R, then a^65537 */
+    rsa_mont_mul(x, a, key->rr, key);
+    for (i = 0; i < 16; i++) {
+        rsa_mont_mul(x, x, x, key);
+    }
+    rsa_mont_mul(x, x, a, key);
+
+    for (i = 0; i < BOOTUTIL_RSA_LIMBS; i++) {
+        q = &em[PSS_EMLEN - 4 * (i + 1)];
+        q[0] = (uint8_t)(x[i] >> 24);
+        q[1] = (uint8_t)(x[i] >> 16);
+        q[2] = (uint8_t)(x[i] >> 8);
+        q[3] = (uint8_t)x[i];
+    }
+
+    return 0;
+}
+#endif /* MCUBOOT_RSA_PREPARSED_KEYS */
+
 /*
  * Validate an RSA signature, using RSA-PSS, as described in PKCS #1
  * v2.2, section 9.1.2, with many parameters required to have fixed
  * values. RSASSA-PSS-VERIFY RFC8017 section 8.1.2
  */
 static fih_ret
+#if defined(MCUBOOT_RSA_PREPARSED_KEYS)
+bootutil_cmp_rsasig(const struct bootutil_rsa_pub_key *key, uint8_t *hash,
+  uint32_t hlen, uint8_t *sig, size_t slen)
+#else
 bootutil_cmp_rsasig(bootutil_rsa_context *ctx, uint8_t *hash, uint32_t hlen,
   uint8_t *sig, size_t slen)
+#endif
 {
     bootutil_sha_context shactx;
     uint8_t em[MBEDTLS_MPI_MAX_SIZE];
@@ -139,7 +257,11 @@ bootutil_cmp_rsasig(bootutil_rsa_context *ctx, uint8_t *hash, uint32_t hlen,
     }
 
     /* Apply RSAVP1 to produce em = sig^E mod N using the public key */
+#if defined(MCUBOOT_RSA_PREPARSED_KEYS)
+    if (bootutil_rsa_public_preparsed(key, sig, em)) {
+#else
     if (bootutil_rsa_public(ctx, sig, em)) {
+#endif
         goto out;
     }
 
@@ -258,6 +380,22 @@ bootutil_cmp_rsasig(bootutil_rsa_context *ctx, uint8_t *hash, uint32_t hlen,
 
 #endif /* MCUBOOT_USE_PSA_CRYPTO */
 
+#if defined(MCUBOOT_RSA_PREPARSED_KEYS)
+fih_ret
+bootutil_verify_sig(uint8_t *hash, uint32_t hlen, uint8_t *sig, size_t slen,
+  uint8_t key_id)
+{
+    const struct bootutil_rsa_pub_key *key = bootutil_keys[key_id].rsa;
+    FIH_DECLARE(fih_rc, FIH_FAILURE);
+
+    if (key == NULL || slen != PSS_EMLEN) {
+        FIH_RET(fih_rc);
+    }
+    FIH_CALL(bootutil_cmp_rsasig, fih_rc, key, hash, hlen, sig, slen);
+
+    FIH_RET(fih_rc);
+}
+#else
 fih_ret
 bootutil_verify_sig(uint8_t *hash, uint32_t hlen, uint8_t *sig, size_t slen,
   uint8_t key_id)
@@ -285,4 +423,5 @@ out:
 
     FIH_RET(fih_rc);
 }
+#endif /* MCUBOOT_RSA_PREPARSED_KEYS */
 #endif /* MCUBOOT_SIGN_RSA */
@@ -56,6 +56,46 @@
 
 #include "bootutil_priv.h"
 
+#ifndef MCUBOOT_RAM_LOAD
+#if defined(MCUBOOT_FLASH_AREA_ASYNC_READ) || defined(MCUBOOT_CRYPTO_OFFLOAD)
+#define BOOT_HASH_NUM_BUFS 2
+#else
+#define BOOT_HASH_NUM_BUFS 1
+#endif
+
+/*
+ * Returns the size of the block of at most `buf_sz` bytes to hash at `off`.
+ */
+static uint32_t
+bootutil_img_hash_blk_sz(struct image_header *hdr, uint32_t off,
+                         uint32_t size, uint32_t buf_sz)
+{
+    uint32_t blk_sz;
+
+    blk_sz = size - off;
+    if (blk_sz > buf_sz) {
+        blk_sz = buf_sz;
+    }
+#ifdef MCUBOOT_ENC_IMAGES
+    /* The only data that is encrypted in an image is the payload;
+     * both header and TLVs (when protected) are not.
+     */
+    if ((off < hdr->ih_hdr_size) && ((off + blk_sz) > hdr->ih_hdr_size)) {
+        /* read only the header */
+        blk_sz = hdr->ih_hdr_size - off;
+    }
+    if ((off < BOOT_TLV_OFF(hdr)) && ((off + blk_sz) > BOOT_TLV_OFF(hdr))) {
+        /* read only up to the end of the image payload */
+        blk_sz = BOOT_TLV_OFF(hdr) - off;
+    }
+#else
+    (void)hdr;
+#endif
+
+    return blk_sz;
+}
+#endif /* !MCUBOOT_RAM_LOAD */
+
 /*
  * Compute SHA hash over the image.
  * (SHA384 if ECDSA-P384 is being used,
@@ -75,6 +115,17 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
     int rc;
     uint32_t blk_off;
     uint32_t tlv_off;
+    const uint8_t *data;
+#ifndef MCUBOOT_RAM_LOAD
+    struct boot_read_req req;
+    struct boot_crypto_req creq[BOOT_HASH_NUM_BUFS];
+    uint32_t buf_sz;
+    uint32_t next_off;
+    uint32_t next_sz;
+    uint8_t *blk;
+    int blk_buf;
+    int cur;
+#endif
 
 #if (BOOT_IMAGE_NUMBER == 1) || !defined(MCUBOOT_ENC_IMAGES) || \
     defined(MCUBOOT_RAM_LOAD)
@@ -90,6 +141,7 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
     (void)fap;
     (void)tmp_buf;
     (void)tmp_buf_sz;
+    (void)data;
 #endif
 #endif
 
@@ -122,40 +174,77 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
                         (void*)(IMAGE_RAM_BASE + hdr->ih_load_addr),
                         size);
 #else
-    for (off = 0; off < size; off += blk_sz) {
-        blk_sz = size - off;
-        if (blk_sz > tmp_buf_sz) {
-            blk_sz = tmp_buf_sz;
-        }
+    data = NULL;
 #ifdef MCUBOOT_ENC_IMAGES
-        /* The only data that is encrypted in an image is the payload;
-         * both header and TLVs (when protected) are not.
+    if (!MUST_DECRYPT(fap, image_index, hdr))
+#endif
+    {
+        /* Feed the hash straight from flash when the area is mapped. */
+        data = IMAGE_DATA_PTR(hdr, fap, 0, size);
+    }
+
+    if (data != NULL) {
+        bootutil_sha_update(&sha_ctx, data, size);
+    } else if (size > 0) {
+        /* Hash each block while the next one is read into the other half
+         * of the buffer. Without asynchronous reads or crypto offload a
+         * single buffer is used and every read completes before its block
+         * is hashed.
          */
-        if ((off < hdr_size) && ((off + blk_sz) > hdr_size)) {
-            /* read only the header */
-            blk_sz = hdr_size - off;
-        }
-        if ((off < tlv_off) && ((off + blk_sz) > tlv_off)) {
-            /* read only up to the end of the image payload */
-            blk_sz = tlv_off - off;
+        buf_sz = tmp_buf_sz / BOOT_HASH_NUM_BUFS;
+        for (cur = 0; cur < BOOT_HASH_NUM_BUFS; cur++) {
+            boot_crypto_req_init(&creq[cur]);
         }
+        cur = 0;
+        blk_sz = bootutil_img_hash_blk_sz(hdr, 0, size, buf_sz);
+        rc = boot_read_start(&req, fap, boot_img_hdr_off(fap), tmp_buf,
+                             blk_sz);
+        for (off = 0; rc == 0 && off < size; off = next_off) {
+            rc = boot_read_wait(&req);
+            if (rc) {
+                break;
+            }
+
+            blk_buf = cur;
+            blk = tmp_buf + blk_buf * buf_sz;
+            next_off = off + blk_sz;
+            next_sz = 0;
+            if (next_off < size) {
+                cur = (cur + 1) % BOOT_HASH_NUM_BUFS;
+                /* The other half is free once its block has been hashed. */
+                rc = boot_crypto_req_wait(&creq[cur]);
+                if (rc) {
+                    break;
+                }
+                next_sz = bootutil_img_hash_blk_sz(hdr, next_off, size, buf_sz);
+                rc = boot_read_start(&req, fap,
+                                     boot_img_hdr_off(fap) + next_off,
+                                     tmp_buf + cur * buf_sz, next_sz);
+            }
+#ifdef MCUBOOT_ENC_IMAGES
+            if (MUST_DECRYPT(fap, image_index, hdr)) {
+                /* Only payload is encrypted (area between header and TLVs) */
+                if (off >= hdr_size && off < tlv_off) {
+                    blk_off = (off - hdr_size) & 0xf;
+                    (void)boot_encrypt_start(&creq[blk_buf], enc_state,
+                            image_index, fap, off - hdr_size, blk_sz, blk_off,
+                            blk);
+                }
+            }
 #endif
-        rc = flash_area_read(fap, off, tmp_buf, blk_sz);
+            (void)boot_sha_update_start(&creq[blk_buf], &sha_ctx, blk,
+                                        blk_sz);
+            blk_sz = next_sz;
+        }
+        for (cur = 0; cur < BOOT_HASH_NUM_BUFS; cur++) {
+            if (boot_crypto_req_wait(&creq[cur]) && rc == 0) {
+                rc = -1;
+            }
+        }
         if (rc) {
             bootutil_sha_drop(&sha_ctx);
             return rc;
         }
-#ifdef MCUBOOT_ENC_IMAGES
-        if (MUST_DECRYPT(fap, image_index, hdr)) {
-            /* Only payload is encrypted (area between header and TLVs) */
-            if (off >= hdr_size && off < tlv_off) {
-                blk_off = (off - hdr_size) & 0xf;
-                boot_encrypt(enc_state, image_index, fap, off - hdr_size,
-                        blk_sz, blk_off, tmp_buf);
-            }
-        }
-#endif
-        bootutil_sha_update(&sha_ctx, tmp_buf, blk_sz);
     }
 #endif /* MCUBOOT_RAM_LOAD */
     bootutil_sha_finish(&sha_ctx, hash_result);
@@ -203,8 +292,30 @@ bootutil_img_hash(struct enc_key_data *enc_state, int image_index,
 
 #ifdef EXPECTED_SIG_TLV
 #if !defined(MCUBOOT_HW_KEY)
+#ifdef MCUBOOT_KEY_HASH_TABLE
+static int
+bootutil_find_key(const uint8_t *keyhash, uint8_t keyhash_len)
+{
+    int i;
+    const struct bootutil_key *key;
+
+    if (keyhash_len > IMAGE_HASH_SIZE) {
+        return -1;
+    }
+
+    /* The digests were computed when the keys were generated. */
+    for (i = 0; i < bootutil_key_cnt; i++) {
+        key = &bootutil_keys[i];
+        if (*key->hash_len == IMAGE_HASH_SIZE &&
+            !memcmp(key->hash, keyhash, keyhash_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+#else
 static int
-bootutil_find_key(uint8_t *keyhash, uint8_t keyhash_len)
+bootutil_find_key(const uint8_t *keyhash, uint8_t keyhash_len)
 {
     bootutil_sha_context sha_ctx;
     int i;
@@ -228,6 +339,7 @@ bootutil_find_key(uint8_t *keyhash, uint8_t keyhash_len)
     bootutil_sha_drop(&sha_ctx);
     return -1;
 }
+#endif /* MCUBOOT_KEY_HASH_TABLE */
 #else
 extern unsigned int pub_key_len;
 static int
@@ -268,6 +380,29 @@ bootutil_find_key(uint8_t image_index, uint8_t *key, uint16_t key_len)
 #endif /* !MCUBOOT_HW_KEY */
 #endif
 
+/*
+ * Returns a pointer to image data, read in place when the flash area can be
+ * accessed directly and loaded into `buf` otherwise. Returns NULL on read
+ * errors.
+ */
+static const uint8_t *
+bootutil_img_data(struct image_header *hdr, const struct flash_area *fap,
+                  uint32_t off, uint8_t *buf, uint32_t len)
+{
+    const uint8_t *data;
+
+    /* Each is only used by some of the ways to reach the image data. */
+    (void)hdr;
+    (void)fap;
+
+    data = IMAGE_DATA_PTR(hdr, fap, off, len);
+    if (data == NULL && LOAD_IMAGE_DATA(hdr, fap, off, buf, len) == 0) {
+        data = buf;
+    }
+
+    return data;
+}
+
 /**
  * Reads the value of an image's security counter.
  *
@@ -283,7 +418,6 @@ bootutil_get_img_security_cnt(struct image_header *hdr,
                               const struct flash_area *fap,
                               uint32_t *img_security_cnt)
 {
-    struct image_tlv_iter it;
     uint32_t off;
     uint16_t len;
     int32_t rc;
@@ -300,16 +434,7 @@ bootutil_get_img_security_cnt(struct image_header *hdr,
         return BOOT_EBADIMAGE;
     }
 
-    rc = bootutil_tlv_iter_begin(&it, hdr, fap, IMAGE_TLV_SEC_CNT, true);
-    if (rc) {
-        return rc;
-    }
-
-    /* Traverse through the protected TLV area to find
-     * the security counter TLV.
-     */
-
-    rc = bootutil_tlv_iter_next(&it, &off, &len, NULL);
+    rc = bootutil_tlv_find(hdr, fap, IMAGE_TLV_SEC_CNT, true, &off, &len);
     if (rc != 0) {
         /* Security counter TLV has not been found. */
         return -1;
@@ -329,14 +454,13 @@ bootutil_get_img_security_cnt(struct image_header *hdr,
 }
 
 /*
- * Verify the integrity of the image.
+ * Verify the integrity of the image, given the hash of its header, payload
+ * and protected TLVs.
  * Return non-zero if image could not be validated/does not validate.
  */
-fih_ret
-bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
-                      struct image_header *hdr, const struct flash_area *fap,
-                      uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint8_t *seed,
-                      int seed_len, uint8_t *out_hash)
+static fih_ret
+bootutil_img_validate_tlvs(int image_index, struct image_header *hdr,
+                           const struct flash_area *fap, uint8_t *hash)
 {
     uint32_t off;
     uint16_t len;
@@ -352,7 +476,7 @@ bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
 #endif /* EXPECTED_SIG_TLV */
     struct image_tlv_iter it;
     uint8_t buf[SIG_BUF_SIZE];
-    uint8_t hash[IMAGE_HASH_SIZE];
+    const uint8_t *data;
     int rc = 0;
     FIH_DECLARE(fih_rc, FIH_FAILURE);
 #ifdef MCUBOOT_HW_ROLLBACK_PROT
@@ -361,15 +485,7 @@ bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
     FIH_DECLARE(security_counter_valid, FIH_FAILURE);
 #endif
 
-    rc = bootutil_img_hash(enc_state, image_index, hdr, fap, tmp_buf,
-            tmp_buf_sz, hash, seed, seed_len);
-    if (rc) {
-        goto out;
-    }
-
-    if (out_hash) {
-        memcpy(out_hash, hash, IMAGE_HASH_SIZE);
-    }
+    (void)image_index;
 
     rc = bootutil_tlv_iter_begin(&it, hdr, fap, IMAGE_TLV_ANY, false);
     if (rc) {
@@ -395,16 +511,17 @@ bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
 
         if (type == EXPECTED_HASH_TLV) {
             /* Verify the image hash. This must always be present. */
-            if (len != sizeof(hash)) {
+            if (len != IMAGE_HASH_SIZE) {
                 rc = -1;
                 goto out;
             }
-            rc = LOAD_IMAGE_DATA(hdr, fap, off, buf, sizeof(hash));
-            if (rc) {
+            data = bootutil_img_data(hdr, fap, off, buf, IMAGE_HASH_SIZE);
+            if (data == NULL) {
+                rc = -1;
                 goto out;
             }
 
-            FIH_CALL(boot_fih_memequal, fih_rc, hash, buf, sizeof(hash));
+            FIH_CALL(boot_fih_memequal, fih_rc, hash, data, IMAGE_HASH_SIZE);
             if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
                 FIH_SET(fih_rc, FIH_FAILURE);
                 goto out;
@@ -421,11 +538,12 @@ bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
                 rc = -1;
                 goto out;
             }
-            rc = LOAD_IMAGE_DATA(hdr, fap, off, buf, len);
-            if (rc) {
+            data = bootutil_img_data(hdr, fap, off, buf, len);
+            if (data == NULL) {
+                rc = -1;
                 goto out;
             }
-            key_id = bootutil_find_key(buf, len);
+            key_id = bootutil_find_key(data, len);
             /*
              * The key may not be found, which is acceptable.  There
              * can be multiple signatures, each preceded by a key.
@@ -463,8 +581,10 @@ bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
             if (rc) {
                 goto out;
             }
-            FIH_CALL(bootutil_verify_sig, valid_signature, hash, sizeof(hash),
+            BOOT_PHASE_BEGIN(BOOT_PHASE_SIG_VERIFY);
+            FIH_CALL(bootutil_verify_sig, valid_signature, hash, IMAGE_HASH_SIZE,
                                                            buf, len, key_id);
+            BOOT_PHASE_END(BOOT_PHASE_SIG_VERIFY, len);
             key_id = -1;
 #endif /* EXPECTED_SIG_TLV */
 #ifdef MCUBOOT_HW_ROLLBACK_PROT
@@ -528,3 +648,56 @@ out:
 
     FIH_RET(fih_rc);
 }
+
+/*
+ * Verify the integrity of the image.
+ * Return non-zero if image could not be validated/does not validate.
+ */
+fih_ret
+bootutil_img_validate(struct enc_key_data *enc_state, int image_index,
+                      struct image_header *hdr, const struct flash_area *fap,
+                      uint8_t *tmp_buf, uint32_t tmp_buf_sz, uint8_t *seed,
+                      int seed_len, uint8_t *out_hash)
+{
+    uint8_t hash[IMAGE_HASH_SIZE];
+    int rc;
+    FIH_DECLARE(fih_rc, FIH_FAILURE);
+
+    BOOT_PHASE_BEGIN(BOOT_PHASE_IMAGE_HASH);
+    rc = bootutil_img_hash(enc_state, image_index, hdr, fap, tmp_buf,
+            tmp_buf_sz, hash, seed, seed_len);
+    BOOT_PHASE_END(BOOT_PHASE_IMAGE_HASH,
+                   BOOT_TLV_OFF(hdr) + hdr->ih_protect_tlv_size);
+    if (rc) {
+        FIH_RET(fih_rc);
+    }
+
+    if (out_hash) {
+        memcpy(out_hash, hash, IMAGE_HASH_SIZE);
+    }
+
+    FIH_CALL(bootutil_img_validate_tlvs, fih_rc, image_index, hdr, fap, hash);
+    FIH_RET(fih_rc);
+}
+
+#ifdef MCUBOOT_HASH_ON_COPY
+/*
+ * Verify the integrity of the image, reusing the hash computed over the
+ * image while it was copied into the slot instead of reading it again.
+ * Return non-zero if image could not be validated/does not validate.
+ */
+fih_ret
+bootutil_img_validate_hashed(int image_index, struct image_header *hdr,
+                             const struct flash_area *fap,
+                             const uint8_t *hash)
+{
+    uint8_t img_hash[IMAGE_HASH_SIZE];
+    FIH_DECLARE(fih_rc, FIH_FAILURE);
+
+    memcpy(img_hash, hash, IMAGE_HASH_SIZE);
+
+    FIH_CALL(bootutil_img_validate_tlvs, fih_rc, image_index, hdr, fap,
+             img_hash);
+    FIH_RET(fih_rc);
+}
+#endif /* MCUBOOT_HASH_ON_COPY */
@@ -91,9 +91,11 @@ static int
 boot_read_image_headers(struct boot_loader_state *state, bool require_all,
         struct boot_status *bs)
 {
-    int rc;
+    int rc = 0;
     int i;
 
+    BOOT_PHASE_BEGIN(BOOT_PHASE_READ_HEADERS);
+
     for (i = 0; i < BOOT_NUM_SLOTS; i++) {
         rc = BOOT_HOOK_CALL(boot_read_image_header_hook, BOOT_HOOK_REGULAR,
                             BOOT_CURR_IMG(state), i, boot_img_hdr(state, i));
@@ -109,14 +111,16 @@ boot_read_image_headers(struct boot_loader_state *state, bool require_all,
              * Failure to read any headers is a fatal error.
              */
             if (i > 0 && !require_all) {
-                return 0;
-            } else {
-                return rc;
+                rc = 0;
             }
+            break;
         }
     }
 
-    return 0;
+    BOOT_PHASE_END(BOOT_PHASE_READ_HEADERS,
+                   (uint32_t)i * sizeof(struct image_header));
+
+    return rc;
 }
 
 /**
@@ -169,6 +173,24 @@ boot_add_shared_data(struct boot_loader_state *state,
 #endif
 }
 
+#ifdef MCUBOOT_BOOT_TIMELINE
+/**
+ * Passes the timeline of this boot to the application and logs it.  The
+ * timeline is informative only, failing to share it does not fail the boot.
+ */
+static void
+boot_export_timeline(void)
+{
+#ifdef MCUBOOT_DATA_SHARING
+    if (boot_save_boot_timeline() != 0) {
+        BOOT_LOG_WRN("Boot timeline not added to the shared data area");
+    }
+#endif
+
+    boot_timeline_dump();
+}
+#endif /* MCUBOOT_BOOT_TIMELINE */
+
 /**
  * Fills rsp to indicate how booting should occur.
  *
@@ -259,7 +281,8 @@ boot_read_image_size(struct boot_loader_state *state, int slot, uint32_t *size)
 
     off = BOOT_TLV_OFF(boot_img_hdr(state, slot));
 
-    if (flash_area_read(fap, off, &info, sizeof(info))) {
+    if (flash_area_read(fap, boot_img_hdr_off(fap) + off, &info,
+                        sizeof(info))) {
         rc = BOOT_EFLASH;
         goto done;
     }
@@ -271,7 +294,8 @@ boot_read_image_size(struct boot_loader_state *state, int slot, uint32_t *size)
             goto done;
         }
 
-        if (flash_area_read(fap, off + info.it_tlv_tot, &info, sizeof(info))) {
+        if (flash_area_read(fap, boot_img_hdr_off(fap) + off + info.it_tlv_tot,
+                            &info, sizeof(info))) {
             rc = BOOT_EFLASH;
             goto done;
         }
@@ -521,6 +545,20 @@ boot_image_check(struct boot_loader_state *state, struct image_header *hdr,
     }
 #endif
 
+#ifdef MCUBOOT_HASH_ON_COPY
+    if (BOOT_COPY_HASH(state).valid &&
+        flash_area_get_id(fap) == FLASH_AREA_IMAGE_PRIMARY(image_index)) {
+        /* The image was just copied here, its hash was computed on the way. */
+        BOOT_COPY_HASH(state).valid = false;
+        if (BOOT_COPY_HASH(state).size ==
+                BOOT_TLV_OFF(hdr) + hdr->ih_protect_tlv_size) {
+            FIH_CALL(bootutil_img_validate_hashed, fih_rc, image_index, hdr,
+                     fap, BOOT_COPY_HASH(state).hash);
+            FIH_RET(fih_rc);
+        }
+    }
+#endif
+
     FIH_CALL(bootutil_img_validate, fih_rc, BOOT_CURR_ENC(state), image_index,
              hdr, fap, tmpbuf, BOOT_TMPBUF_SZ, NULL, 0, NULL);
 
@@ -578,6 +616,10 @@ boot_is_header_valid(const struct image_header *hdr, const struct flash_area *fa
         return false;
     }
 
+    if (!boot_u32_safe_add(&size, size, boot_img_hdr_off(fap))) {
+        return false;
+    }
+
     if (size >= flash_area_get_size(fap)) {
         return false;
     }
@@ -585,6 +627,41 @@ boot_is_header_valid(const struct image_header *hdr, const struct flash_area *fa
     return true;
 }
 
+/*
+ * Check that a delta or a compressed image, if that is what the slot holds,
+ * can be installed. Only the secondary slot may hold one, and only with
+ * MCUBOOT_DELTA_UPGRADE or MCUBOOT_DECOMPRESS_IMAGES respectively.
+ */
+static bool
+boot_is_payload_valid(struct boot_loader_state *state, int slot)
+{
+    uint32_t flags = boot_img_hdr(state, slot)->ih_flags;
+
+    if ((flags & IMAGE_F_DELTA) && (flags & IMAGE_F_COMPRESSED_LZ4)) {
+        return false;
+    }
+
+    if (flags & IMAGE_F_DELTA) {
+#ifdef MCUBOOT_DELTA_UPGRADE
+        if (slot != BOOT_PRIMARY_SLOT) {
+            return boot_delta_check(state) == 0;
+        }
+#endif
+        return false;
+    }
+
+    if (flags & IMAGE_F_COMPRESSED_LZ4) {
+#ifdef MCUBOOT_DECOMPRESS_IMAGES
+        if (slot != BOOT_PRIMARY_SLOT) {
+            return boot_decomp_check(state) == 0;
+        }
+#endif
+        return false;
+    }
+
+    return true;
+}
+
 /*
  * Check that a memory area consists of a given value.
  */
@@ -737,6 +814,9 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
     int area_id;
     FIH_DECLARE(fih_rc, FIH_FAILURE);
     int rc;
+#ifdef MCUBOOT_VALIDATION_CACHE
+    bool cache_hit = false;
+#endif
 
     area_id = flash_area_id_from_multi_image_slot(BOOT_CURR_IMG(state), slot);
     rc = flash_area_open(area_id, &fap);
@@ -744,11 +824,14 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
         FIH_RET(fih_rc);
     }
 
+    BOOT_PHASE_BEGIN(BOOT_PHASE_VALIDATE_SLOT);
+
     hdr = boot_img_hdr(state, slot);
     if (boot_check_header_erased(state, slot) == 0 ||
         (hdr->ih_flags & IMAGE_F_NON_BOOTABLE)) {
 
-#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE)
+#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
+    defined(MCUBOOT_SWAP_USING_OFFSET)
         /*
          * This fixes an issue where an image might be erased, but a trailer
          * be left behind. It can happen if the image is in the secondary slot
@@ -790,9 +873,23 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
                        fih_rc, BOOT_CURR_IMG(state), slot);
     if (FIH_EQ(fih_rc, FIH_BOOT_HOOK_REGULAR))
     {
-        FIH_CALL(boot_image_check, fih_rc, state, hdr, fap, bs);
+#ifdef MCUBOOT_VALIDATION_CACHE
+        /* An unchanged primary image validated on a previous boot only needs
+         * its cache entry checked.
+         */
+        if (slot == BOOT_PRIMARY_SLOT) {
+            FIH_CALL(boot_validation_cache_check, fih_rc, BOOT_CURR_IMG(state),
+                     hdr, fap);
+            cache_hit = FIH_EQ(fih_rc, FIH_SUCCESS);
+        }
+        if (!cache_hit)
+#endif
+        {
+            FIH_CALL(boot_image_check, fih_rc, state, hdr, fap, bs);
+        }
     }
-    if (!boot_is_header_valid(hdr, fap) || FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
+    if (!boot_is_header_valid(hdr, fap) || FIH_NOT_EQ(fih_rc, FIH_SUCCESS) ||
+        !boot_is_payload_valid(state, slot)) {
         if ((slot != BOOT_PRIMARY_SLOT) || ARE_SLOTS_EQUIVALENT()) {
             flash_area_erase(fap, 0, flash_area_get_size(fap));
             /* Image is invalid, erase it to prevent further unnecessary
@@ -807,19 +904,28 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
         goto out;
     }
 
+#ifdef MCUBOOT_VALIDATION_CACHE
+    if (slot == BOOT_PRIMARY_SLOT && !cache_hit) {
+        boot_validation_cache_update(BOOT_CURR_IMG(state), hdr, fap);
+    }
+#endif
+
 #if MCUBOOT_IMAGE_NUMBER > 1 && !defined(MCUBOOT_ENC_IMAGES) && defined(MCUBOOT_VERIFY_IMG_ADDRESS)
     /* Verify that the image in the secondary slot has a reset address
      * located in the primary slot. This is done to avoid users incorrectly
      * overwriting an application written to the incorrect slot.
-     * This feature is only supported by ARM platforms.
+     * This feature is only supported by ARM platforms. A delta image holds
+     * no vector table.
      */
-    if (area_id == FLASH_AREA_IMAGE_SECONDARY(BOOT_CURR_IMG(state))) {
+    if (area_id == FLASH_AREA_IMAGE_SECONDARY(BOOT_CURR_IMG(state)) &&
+        !(hdr->ih_flags & IMAGE_F_DELTA)) {
         const struct flash_area *pri_fa = BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT);
         struct image_header *secondary_hdr = boot_img_hdr(state, slot);
         uint32_t reset_value = 0;
         uint32_t reset_addr = secondary_hdr->ih_hdr_size + sizeof(reset_value);
 
-        rc = flash_area_read(fap, reset_addr, &reset_value, sizeof(reset_value));
+        rc = flash_area_read(fap, boot_img_hdr_off(fap) + reset_addr,
+                             &reset_value, sizeof(reset_value));
         if (rc != 0) {
             fih_rc = FIH_NO_BOOTABLE_IMAGE;
             goto out;
@@ -843,6 +949,8 @@ boot_validate_slot(struct boot_loader_state *state, int slot,
 #endif
 
 out:
+    BOOT_PHASE_END(BOOT_PHASE_VALIDATE_SLOT, 0);
+
     flash_area_close(fap);
 
     FIH_RET(fih_rc);
@@ -900,194 +1008,913 @@ done:
  * for validity.  If the image in the secondary slot is invalid, it is erased,
  * and a swap type of "none" is indicated.
  *
- * @return                      The type of swap to perform (BOOT_SWAP_TYPE...)
+ * @return                      The type of swap to perform (BOOT_SWAP_TYPE...)
+ */
+static int
+boot_validated_swap_type(struct boot_loader_state *state,
+                         struct boot_status *bs)
+{
+    int swap_type;
+    FIH_DECLARE(fih_rc, FIH_FAILURE);
+
+    swap_type = boot_swap_type_multi(BOOT_CURR_IMG(state));
+    if (BOOT_IS_UPGRADE(swap_type)) {
+        /* Boot loader wants to switch to the secondary slot.
+         * Ensure image is valid.
+         */
+        FIH_CALL(boot_validate_slot, fih_rc, state, BOOT_SECONDARY_SLOT, bs);
+        if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
+            if (FIH_EQ(fih_rc, FIH_NO_BOOTABLE_IMAGE)) {
+                swap_type = BOOT_SWAP_TYPE_NONE;
+            } else {
+                swap_type = BOOT_SWAP_TYPE_FAIL;
+            }
+        }
+    }
+
+    return swap_type;
+}
+#endif
+
+/**
+ * Erases a region of flash.
+ *
+ * @param flash_area           The flash_area containing the region to erase.
+ * @param off                   The offset within the flash area to start the
+ *                                  erase.
+ * @param sz                    The number of bytes to erase.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_erase_region(const struct flash_area *fap, uint32_t off, uint32_t sz)
+{
+    bootutil_tlv_index_invalidate(fap);
+    return flash_area_erase(fap, off, sz);
+}
+
+/**
+ * Erases a region of flash that is about to be entirely rewritten by
+ * boot_copy_region(). Nothing is done on devices that can be written without
+ * being erased first, since every byte of the region is overwritten anyway.
+ *
+ * @param flash_area           The flash_area containing the region to erase.
+ * @param off                   The offset within the flash area to start the
+ *                                  erase.
+ * @param sz                    The number of bytes to erase.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_erase_region_if_required(const struct flash_area *fap, uint32_t off,
+                              uint32_t sz)
+{
+    if (!boot_device_requires_erase(fap)) {
+        return 0;
+    }
+
+    return boot_erase_region(fap, off, sz);
+}
+
+#if !defined(MCUBOOT_DIRECT_XIP) && !defined(MCUBOOT_RAM_LOAD)
+
+#if defined(MCUBOOT_ENC_IMAGES) || defined(MCUBOOT_SWAP_SAVE_ENCTLV)
+/* Replacement for memset(p, 0, sizeof(*p) that does not get
+ * optimized out.
+ */
+static void like_mbedtls_zeroize(void *p, size_t n)
+{
+    volatile unsigned char *v = (unsigned char *)p;
+
+    for (size_t i = 0; i < n; i++) {
+        v[i] = 0;
+    }
+}
+#endif
+
+#ifdef MCUBOOT_HASH_ON_COPY
+/**
+ * Starts hashing the image about to be copied into the primary slot, so that
+ * validating the primary slot afterwards does not have to read it again.
+ *
+ * @param hdr                   Header of the image being copied.
+ * @param copy_sz               The number of bytes that will be copied.
+ */
+static void
+boot_copy_hash_start(struct boot_loader_state *state,
+                     const struct image_header *hdr, uint32_t copy_sz)
+{
+    struct boot_copy_hash *ch = &BOOT_COPY_HASH(state);
+
+    ch->valid = false;
+    ch->off = 0;
+    ch->size = BOOT_TLV_OFF(hdr) + hdr->ih_protect_tlv_size;
+    ch->active = (ch->size <= copy_sz);
+    if (ch->active) {
+        bootutil_sha_init(&ch->sha);
+    }
+}
+
+/**
+ * Feeds data just written to a slot to the copy hash. The hash is abandoned
+ * if the data is not the next part of the image in the primary slot.
+ *
+ * @param fap_dst               The flash area the data was written to.
+ * @param off                   The offset the data was written at.
+ * @param buf                   The data, as written.
+ * @param len                   The number of bytes written.
+ */
+static void
+boot_copy_hash_update(struct boot_loader_state *state,
+                      const struct flash_area *fap_dst, uint32_t off,
+                      const uint8_t *buf, uint32_t len)
+{
+    struct boot_copy_hash *ch = &BOOT_COPY_HASH(state);
+
+    if (!ch->active) {
+        return;
+    }
+
+    if (flash_area_get_id(fap_dst) !=
+            FLASH_AREA_IMAGE_PRIMARY(BOOT_CURR_IMG(state)) || off != ch->off) {
+        bootutil_sha_drop(&ch->sha);
+        ch->active = false;
+        return;
+    }
+
+    ch->off += len;
+    if (off < ch->size) {
+        if (len > ch->size - off) {
+            len = ch->size - off;
+        }
+        bootutil_sha_update(&ch->sha, buf, len);
+    }
+}
+
+/**
+ * Completes the copy hash, making it available for validating the primary
+ * slot if the whole image went through it.
+ *
+ * @param copied                Whether the copy succeeded.
+ */
+static void
+boot_copy_hash_finish(struct boot_loader_state *state, bool copied)
+{
+    struct boot_copy_hash *ch = &BOOT_COPY_HASH(state);
+
+    if (!ch->active) {
+        return;
+    }
+
+    if (copied && ch->off >= ch->size) {
+        bootutil_sha_finish(&ch->sha, ch->hash);
+        ch->valid = true;
+    }
+    bootutil_sha_drop(&ch->sha);
+    ch->active = false;
+}
+
+/**
+ * Makes the hash of an image written to the primary slot by other means than
+ * a copy, such as a delta, available for validating the primary slot.
+ *
+ * @param hash                  The hash of the image.
+ * @param size                  Size of the hashed header, payload and TLVs.
+ */
+void
+boot_copy_hash_set(struct boot_loader_state *state, const uint8_t *hash,
+                   uint32_t size)
+{
+    struct boot_copy_hash *ch = &BOOT_COPY_HASH(state);
+
+    memcpy(ch->hash, hash, IMAGE_HASH_SIZE);
+    ch->size = size;
+    ch->valid = true;
+}
+#endif /* MCUBOOT_HASH_ON_COPY */
+
+#if defined(MCUBOOT_ENC_IMAGES) && defined(MCUBOOT_CRYPTO_OFFLOAD)
+#define BOOT_COPY_NUM_BUFS 2
+#else
+#define BOOT_COPY_NUM_BUFS 1
+#endif
+
+/*
+ * Writes a chunk read by `boot_copy_region()`, once its decryption, if any,
+ * has completed.
+ */
+static int
+boot_copy_chunk_write(struct boot_loader_state *state,
+                      const struct flash_area *fap_dst, uint32_t off,
+                      const uint8_t *buf, uint32_t len,
+                      struct boot_crypto_req *creq)
+{
+    int rc;
+
+#if !defined(MCUBOOT_HASH_ON_COPY)
+    (void)state;
+#endif
+
+    rc = boot_crypto_req_wait(creq);
+    if (rc != 0) {
+        return BOOT_EBADIMAGE;
+    }
+
+    rc = flash_area_write(fap_dst, off, buf, len);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+#ifdef MCUBOOT_HASH_ON_COPY
+    /* Hash exactly what was written, i.e. the plaintext of encrypted
+     * images. */
+    boot_copy_hash_update(state, fap_dst, off, buf, len);
+#endif
+
+    MCUBOOT_WATCHDOG_FEED();
+
+    return 0;
+}
+
+/**
+ * Copies the contents of one flash region to another.  You must erase the
+ * destination region prior to calling this function.
+ *
+ * With MCUBOOT_CRYPTO_OFFLOAD, the chunks of encrypted images are read into
+ * two buffers alternately, so that each chunk is decrypted while the next
+ * one is read and the previous one written.
+ *
+ * @param flash_area_id_src     The ID of the source flash area.
+ * @param flash_area_id_dst     The ID of the destination flash area.
+ * @param off_src               The offset within the source flash area to
+ *                                  copy from.
+ * @param off_dst               The offset within the destination flash area to
+ *                                  copy to.
+ * @param sz                    The number of bytes to copy.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_copy_region(struct boot_loader_state *state,
+                 const struct flash_area *fap_src,
+                 const struct flash_area *fap_dst,
+                 uint32_t off_src, uint32_t off_dst, uint32_t sz)
+{
+    uint32_t bytes_copied;
+    uint32_t chunk_off[BOOT_COPY_NUM_BUFS];
+    uint32_t chunk_len[BOOT_COPY_NUM_BUFS];
+    struct boot_crypto_req creq[BOOT_COPY_NUM_BUFS];
+    int chunk_sz;
+    int cur;
+    int rc;
+#if BOOT_COPY_NUM_BUFS > 1
+    bool pending;
+#endif
+#ifdef MCUBOOT_ENC_IMAGES
+    uint32_t off;
+    uint32_t tlv_off;
+    size_t blk_off;
+    struct image_header *hdr;
+    uint16_t idx;
+    uint32_t blk_sz;
+    uint8_t image_index;
+#endif
+
+    TARGET_STATIC uint8_t buf[BOOT_COPY_NUM_BUFS][BUF_SZ]
+        __attribute__((aligned(4)));
+
+#if !defined(MCUBOOT_ENC_IMAGES)
+    (void)state;
+#endif
+
+    bootutil_tlv_index_invalidate(fap_dst);
+
+    BOOT_PHASE_BEGIN(BOOT_PHASE_COPY_REGION);
+
+    for (cur = 0; cur < BOOT_COPY_NUM_BUFS; cur++) {
+        boot_crypto_req_init(&creq[cur]);
+    }
+
+    rc = 0;
+    cur = 0;
+#if BOOT_COPY_NUM_BUFS > 1
+    pending = false;
+#endif
+    bytes_copied = 0;
+    while (bytes_copied < sz) {
+        if (sz - bytes_copied > sizeof buf[cur]) {
+            chunk_sz = sizeof buf[cur];
+        } else {
+            chunk_sz = sz - bytes_copied;
+        }
+
+        rc = flash_area_read(fap_src, off_src + bytes_copied, buf[cur],
+                             chunk_sz);
+        if (rc != 0) {
+            rc = BOOT_EFLASH;
+            break;
+        }
+
+#ifdef MCUBOOT_ENC_IMAGES
+        image_index = BOOT_CURR_IMG(state);
+        if ((flash_area_get_id(fap_src) == FLASH_AREA_IMAGE_SECONDARY(image_index) ||
+             flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) &&
+            !(flash_area_get_id(fap_src) == FLASH_AREA_IMAGE_SECONDARY(image_index) &&
+              flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index))) {
+            /* assume the secondary slot as src, needs decryption */
+            hdr = boot_img_hdr(state, BOOT_SECONDARY_SLOT);
+#if defined(MCUBOOT_SWAP_USING_OFFSET)
+            /* The image in the secondary slot is stored one sector higher,
+             * so use the offset within the primary slot. */
+            off = off_dst;
+            if (flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
+                hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+                off = off_src;
+            }
+#elif !defined(MCUBOOT_SWAP_USING_MOVE)
+            off = off_src;
+            if (flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
+                /* might need encryption (metadata from the primary slot) */
+                hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+                off = off_dst;
+            }
+#else
+            off = off_dst;
+            if (flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
+                hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
+            }
+#endif
+            if (IS_ENCRYPTED(hdr)) {
+                uint32_t abs_off = off + bytes_copied;
+                if (abs_off < hdr->ih_hdr_size) {
+                    /* do not decrypt header */
+                    if (abs_off + chunk_sz > hdr->ih_hdr_size) {
+                        /* The lower part of the chunk contains header data */
+                        blk_off = 0;
+                        blk_sz = chunk_sz - (hdr->ih_hdr_size - abs_off);
+                        idx = hdr->ih_hdr_size  - abs_off;
+                    } else {
+                        /* The chunk contains exclusively header data */
+                        blk_sz = 0; /* nothing to decrypt */
+                    }
+                } else {
+                    idx = 0;
+                    blk_sz = chunk_sz;
+                    blk_off = (abs_off - hdr->ih_hdr_size) & 0xf;
+                }
+
+                if (blk_sz > 0)
+                {
+                    tlv_off = BOOT_TLV_OFF(hdr);
+                    if (abs_off + chunk_sz > tlv_off) {
+                        /* do not decrypt TLVs */
+                        if (abs_off >= tlv_off) {
+                            blk_sz = 0;
+                        } else {
+                            blk_sz = tlv_off - abs_off;
+                        }
+                    }
+                    (void)boot_encrypt_start(&creq[cur], BOOT_CURR_ENC(state),
+                            image_index, fap_src,
+                            (abs_off + idx) - hdr->ih_hdr_size, blk_sz,
+                            blk_off, &buf[cur][idx]);
+                }
+            }
+        }
+#endif
+
+        chunk_off[cur] = off_dst + bytes_copied;
+        chunk_len[cur] = chunk_sz;
+        bytes_copied += chunk_sz;
+
+#if BOOT_COPY_NUM_BUFS > 1
+        /* Write the previous chunk while this one is being decrypted. */
+        cur ^= 1;
+        if (pending) {
+            rc = boot_copy_chunk_write(state, fap_dst, chunk_off[cur],
+                                       buf[cur], chunk_len[cur], &creq[cur]);
+            if (rc != 0) {
+                break;
+            }
+        }
+        pending = true;
+#else
+        rc = boot_copy_chunk_write(state, fap_dst, chunk_off[cur], buf[cur],
+                                   chunk_len[cur], &creq[cur]);
+        if (rc != 0) {
+            break;
+        }
+#endif
+    }
+
+#if BOOT_COPY_NUM_BUFS > 1
+    if (rc == 0 && pending) {
+        cur ^= 1;
+        rc = boot_copy_chunk_write(state, fap_dst, chunk_off[cur], buf[cur],
+                                   chunk_len[cur], &creq[cur]);
+    }
+#endif
+
+    /* Nothing may still be working on the buffers on return. */
+    for (cur = 0; cur < BOOT_COPY_NUM_BUFS; cur++) {
+        (void)boot_crypto_req_wait(&creq[cur]);
+    }
+
+    BOOT_PHASE_END(BOOT_PHASE_COPY_REGION, bytes_copied);
+
+    return rc;
+}
+
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || defined(MCUBOOT_DELTA_UPGRADE)
+/*
+ * Progress journal of overwrite upgrades.
+ *
+ * The status area of the primary slot's trailer, which overwrite-only mode
+ * does not otherwise use, gets one entry per sector of the primary slot once
+ * that sector has been copied, and the swap_size field the number of bytes
+ * being copied. The image must end before the sector holding the trailer, so
+ * that the trailer can be erased on its own.
+ *
+ * The last entries of the status area hold instead the hash TLV of the image
+ * being copied. A copy interrupted by a reset restarts at the first sector
+ * without an entry, provided the copy size and that hash match the image in
+ * the secondary slot. The journal is dropped
+ * once the secondary slot has been erased, or on the next boot without a
+ * pending upgrade if a reset came in between.
+ *
+ * Delta upgrades keep their own entries in the same journal, see delta.c.
+ */
+
+/**
+ * Finds the first sector of the primary slot's trailer.
+ *
+ * @param fap                   The primary slot.
+ * @param trailer_off           On success, the offset of the sector holding
+ *                                  the start of the trailer.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_copy_journal_trailer_off(const struct flash_area *fap,
+                              uint32_t *trailer_off)
+{
+    struct flash_sector sector;
+    int rc;
+
+    rc = flash_area_get_sector(fap, boot_status_off(fap), &sector);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    *trailer_off = flash_sector_get_off(&sector);
+    return 0;
+}
+
+/* Room taken by the hash TLV at the end of the status area. */
+#define BOOT_COPY_JOURNAL_HASH_SZ   ALIGN_UP(IMAGE_HASH_SIZE, BOOT_MAX_ALIGN)
+
+static uint32_t
+boot_copy_journal_hash_off(const struct flash_area *fap)
+{
+    return boot_status_off(fap) + boot_status_sz(flash_area_align(fap)) -
+           BOOT_COPY_JOURNAL_HASH_SZ;
+}
+
+/**
+ * Finds how many entries the journal has room for.
+ *
+ * @param fap                   The primary slot.
+ *
+ * @return                      The number of entries.
+ */
+uint32_t
+boot_copy_journal_entries(struct boot_loader_state *state,
+                          const struct flash_area *fap)
+{
+    return (boot_copy_journal_hash_off(fap) - boot_status_off(fap)) /
+           BOOT_WRITE_SZ(state);
+}
+
+/**
+ * Reads the hash TLV of the image in the secondary slot, which the journal
+ * belongs to.
+ *
+ * @param hash                  Receives the hash, BOOT_COPY_JOURNAL_HASH_SZ
+ *                                  bytes padded with the erased value of fap.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_copy_journal_image_hash(struct boot_loader_state *state,
+                             const struct flash_area *fap, uint8_t *hash)
+{
+    uint16_t len;
+    int rc;
+
+    memset(hash, flash_area_erased_val(fap), BOOT_COPY_JOURNAL_HASH_SZ);
+    len = IMAGE_HASH_SIZE;
+    rc = bootutil_tlv_read(boot_img_hdr(state, BOOT_SECONDARY_SLOT),
+                           BOOT_IMG_AREA(state, BOOT_SECONDARY_SLOT),
+                           EXPECTED_HASH_TLV, false, hash, &len);
+    if (rc != 0 || len != IMAGE_HASH_SIZE) {
+        return BOOT_EBADIMAGE;
+    }
+
+    return 0;
+}
+
+/**
+ * Starts the journal of a new copy of the image in the secondary slot,
+ * replacing any previous one.
+ *
+ * @param fap                   The primary slot.
+ * @param size                  The number of bytes about to be copied.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_copy_journal_start(struct boot_loader_state *state,
+                        const struct flash_area *fap, uint32_t size)
+{
+    uint8_t hash[BOOT_COPY_JOURNAL_HASH_SZ];
+    uint32_t trailer_off;
+    int rc;
+
+    rc = boot_copy_journal_image_hash(state, fap, hash);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = boot_copy_journal_trailer_off(fap, &trailer_off);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = boot_erase_region(fap, trailer_off,
+                           flash_area_get_size(fap) - trailer_off);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    rc = flash_area_write(fap, boot_copy_journal_hash_off(fap), hash,
+                          sizeof(hash));
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    return boot_write_swap_size(fap, size);
+}
+
+/**
+ * Checks whether the journal belongs to a copy of the image in the secondary
+ * slot.
+ *
+ * @param fap                   The primary slot.
+ * @param size                  The number of bytes about to be copied.
+ *
+ * @return                      true if the journal belongs to that copy.
+ */
+bool
+boot_copy_journal_matches(struct boot_loader_state *state,
+                          const struct flash_area *fap, uint32_t size)
+{
+    uint8_t recorded[BOOT_COPY_JOURNAL_HASH_SZ];
+    uint8_t hash[BOOT_COPY_JOURNAL_HASH_SZ];
+    uint32_t swap_size;
+    int rc;
+
+    rc = boot_read_swap_size(fap, &swap_size);
+    if (rc != 0 || swap_size != size) {
+        return false;
+    }
+
+    rc = flash_area_read(fap, boot_copy_journal_hash_off(fap), recorded,
+                         sizeof(recorded));
+    if (rc != 0) {
+        return false;
+    }
+
+    rc = boot_copy_journal_image_hash(state, fap, hash);
+    if (rc != 0) {
+        return false;
+    }
+
+    return memcmp(recorded, hash, IMAGE_HASH_SIZE) == 0;
+}
+
+/**
+ * Reads an entry of the journal.
+ *
+ * @param fap                   The primary slot.
+ * @param entry                 The index of the entry.
+ *
+ * @return                      1 if the entry is set, 0 if it is not;
+ *                                  negative on failure.
+ */
+int
+boot_copy_journal_read_entry(struct boot_loader_state *state,
+                             const struct flash_area *fap, size_t entry)
+{
+    uint32_t off;
+    uint8_t val;
+    int rc;
+
+    off = boot_status_off(fap) + entry * BOOT_WRITE_SZ(state);
+    rc = flash_area_read(fap, off, &val, sizeof(val));
+    if (rc != 0) {
+        return -1;
+    }
+
+    return !bootutil_buffer_is_erased(fap, &val, sizeof(val));
+}
+
+#ifdef MCUBOOT_OVERWRITE_ONLY_RESUME
+/**
+ * Reads the journal of an interrupted copy.
+ *
+ * @param fap                   The primary slot.
+ * @param size                  The number of bytes about to be copied.
+ *
+ * @return                      The number of sectors already copied, or 0 if
+ *                                  the journal is empty or belongs to another
+ *                                  copy.
+ */
+static size_t
+boot_copy_journal_read(struct boot_loader_state *state,
+                       const struct flash_area *fap, uint32_t size)
+{
+    size_t sect_count;
+    size_t done;
+
+    if (!boot_copy_journal_matches(state, fap, size)) {
+        return 0;
+    }
+
+    sect_count = boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
+    for (done = 0; done < sect_count; done++) {
+        if (boot_copy_journal_read_entry(state, fap, done) != 1) {
+            break;
+        }
+    }
+
+    return done;
+}
+#endif
+
+/**
+ * Sets an entry of the journal. Overwrite upgrades set entry k once sector k
+ * of the primary slot has been copied.
+ *
+ * @param fap                   The primary slot.
+ * @param entry                 The index of the entry.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_copy_journal_write(struct boot_loader_state *state,
+                        const struct flash_area *fap, size_t entry)
+{
+    uint32_t off;
+
+    off = boot_status_off(fap) + entry * BOOT_WRITE_SZ(state);
+    return boot_write_trailer_flag(fap, off, BOOT_FLAG_SET);
+}
+
+/**
+ * Drops the journal of a completed copy, leaving the trailer of the primary
+ * slot with only its magic, as a plain overwrite would.
+ *
+ * @param fap                   The primary slot.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int
+boot_copy_journal_drop(const struct flash_area *fap)
+{
+    uint32_t trailer_off;
+    int rc;
+
+    rc = boot_copy_journal_trailer_off(fap, &trailer_off);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = boot_erase_region(fap, trailer_off,
+                           flash_area_get_size(fap) - trailer_off);
+    if (rc != 0) {
+        return BOOT_EFLASH;
+    }
+
+    return boot_write_magic(fap);
+}
+
+/**
+ * Drops the journal left in the primary slot of the current image when no
+ * upgrade is pending, i.e. by a reset between the erase of the secondary slot
+ * and the end of the copy, or by a copy whose source has since been found
+ * invalid.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+static int
+boot_copy_journal_drop_stale(struct boot_loader_state *state)
+{
+    const struct flash_area *fap;
+    size_t entry;
+    int rc;
+
+    /* A delta upgrade may have stashed its first window without having
+     * written it yet.
+     */
+    fap = BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT);
+    for (entry = 0; entry < 2; entry++) {
+        rc = boot_copy_journal_read_entry(state, fap, entry);
+        if (rc < 0) {
+            return BOOT_EFLASH;
+        }
+        if (rc == 1) {
+            break;
+        }
+    }
+
+    if (rc == 0) {
+        return 0;
+    }
+
+    BOOT_LOG_INF("Image %d dropping the journal of an earlier copy",
+                 BOOT_CURR_IMG(state));
+    return boot_copy_journal_drop(fap);
+}
+#endif /* MCUBOOT_OVERWRITE_ONLY_RESUME || MCUBOOT_DELTA_UPGRADE */
+
+#ifdef MCUBOOT_OVERWRITE_ONLY_DIFF
+/**
+ * Compares a region of the secondary slot with the region of the primary
+ * slot it is about to be copied to.
+ *
+ * @param fap_src               The flash area to copy from.
+ * @param fap_dst               The flash area to copy to.
+ * @param off_src               The offset of the region in fap_src.
+ * @param off_dst               The offset of the region in fap_dst.
+ * @param sz                    The number of bytes to compare.
+ *
+ * @return                      1 if both regions hold the same data, 0 if
+ *                                  they differ; negative on failure.
  */
 static int
-boot_validated_swap_type(struct boot_loader_state *state,
-                         struct boot_status *bs)
+boot_copy_region_equal(const struct flash_area *fap_src,
+                       const struct flash_area *fap_dst,
+                       uint32_t off_src, uint32_t off_dst, uint32_t sz)
 {
-    int swap_type;
-    FIH_DECLARE(fih_rc, FIH_FAILURE);
+    uint32_t bytes_cmp;
+    uint32_t chunk_sz;
+    int rc;
 
-    swap_type = boot_swap_type_multi(BOOT_CURR_IMG(state));
-    if (BOOT_IS_UPGRADE(swap_type)) {
-        /* Boot loader wants to switch to the secondary slot.
-         * Ensure image is valid.
-         */
-        FIH_CALL(boot_validate_slot, fih_rc, state, BOOT_SECONDARY_SLOT, bs);
-        if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
-            if (FIH_EQ(fih_rc, FIH_NO_BOOTABLE_IMAGE)) {
-                swap_type = BOOT_SWAP_TYPE_NONE;
-            } else {
-                swap_type = BOOT_SWAP_TYPE_FAIL;
-            }
+    TARGET_STATIC uint8_t buf_src[BUF_SZ] __attribute__((aligned(4)));
+    TARGET_STATIC uint8_t buf_dst[BUF_SZ] __attribute__((aligned(4)));
+
+    for (bytes_cmp = 0; bytes_cmp < sz; bytes_cmp += chunk_sz) {
+        chunk_sz = sz - bytes_cmp;
+        if (chunk_sz > BUF_SZ) {
+            chunk_sz = BUF_SZ;
+        }
+
+        rc = flash_area_read(fap_src, off_src + bytes_cmp, buf_src, chunk_sz);
+        if (rc != 0) {
+            return -1;
+        }
+
+        rc = flash_area_read(fap_dst, off_dst + bytes_cmp, buf_dst, chunk_sz);
+        if (rc != 0) {
+            return -1;
+        }
+
+        if (memcmp(buf_src, buf_dst, chunk_sz) != 0) {
+            return 0;
         }
     }
 
-    return swap_type;
+    return 1;
 }
-#endif
 
+#ifdef MCUBOOT_HASH_ON_COPY
 /**
- * Erases a region of flash.
+ * Feeds a region of the primary slot that already held the data to be
+ * copied to the copy hash, as if it had just been written.
  *
- * @param flash_area           The flash_area containing the region to erase.
- * @param off                   The offset within the flash area to start the
- *                                  erase.
- * @param sz                    The number of bytes to erase.
+ * @param fap_dst               The flash area of the primary slot.
+ * @param off                   The offset of the region.
+ * @param sz                    The size of the region.
  *
  * @return                      0 on success; nonzero on failure.
  */
-int
-boot_erase_region(const struct flash_area *fap, uint32_t off, uint32_t sz)
+static int
+boot_copy_hash_region(struct boot_loader_state *state,
+                      const struct flash_area *fap_dst, uint32_t off,
+                      uint32_t sz)
 {
-    return flash_area_erase(fap, off, sz);
-}
+    struct boot_copy_hash *ch = &BOOT_COPY_HASH(state);
+    uint32_t bytes_hashed;
+    uint32_t chunk_sz;
+    uint32_t len;
+    int rc;
 
-#if !defined(MCUBOOT_DIRECT_XIP) && !defined(MCUBOOT_RAM_LOAD)
+    TARGET_STATIC uint8_t buf[BUF_SZ] __attribute__((aligned(4)));
 
-#if defined(MCUBOOT_ENC_IMAGES) || defined(MCUBOOT_SWAP_SAVE_ENCTLV)
-/* Replacement for memset(p, 0, sizeof(*p) that does not get
- * optimized out.
- */
-static void like_mbedtls_zeroize(void *p, size_t n)
-{
-    volatile unsigned char *v = (unsigned char *)p;
+    if (!ch->active) {
+        return 0;
+    }
 
-    for (size_t i = 0; i < n; i++) {
-        v[i] = 0;
+    /* Only the part of the region holding the image has to be read back. */
+    len = 0;
+    if (off < ch->size) {
+        len = (sz < ch->size - off) ? sz : ch->size - off;
+    }
+
+    for (bytes_hashed = 0; bytes_hashed < len; bytes_hashed += chunk_sz) {
+        chunk_sz = len - bytes_hashed;
+        if (chunk_sz > BUF_SZ) {
+            chunk_sz = BUF_SZ;
+        }
+
+        rc = flash_area_read(fap_dst, off + bytes_hashed, buf, chunk_sz);
+        if (rc != 0) {
+            return BOOT_EFLASH;
+        }
+
+        boot_copy_hash_update(state, fap_dst, off + bytes_hashed, buf,
+                              chunk_sz);
+    }
+
+    if (len < sz) {
+        boot_copy_hash_update(state, fap_dst, off + len, NULL, sz - len);
     }
+
+    return 0;
 }
-#endif
+#endif /* MCUBOOT_HASH_ON_COPY */
+#endif /* MCUBOOT_OVERWRITE_ONLY_DIFF */
 
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || \
+    defined(MCUBOOT_OVERWRITE_ONLY_DIFF)
 /**
- * Copies the contents of one flash region to another.  You must erase the
- * destination region prior to calling this function.
+ * Copies one sector of the image in the secondary slot to the primary slot,
+ * erasing it first if the device requires it. With
+ * MCUBOOT_OVERWRITE_ONLY_DIFF, a sector that already holds the data is left
+ * alone.
  *
- * @param flash_area_id_src     The ID of the source flash area.
- * @param flash_area_id_dst     The ID of the destination flash area.
- * @param off_src               The offset within the source flash area to
- *                                  copy from.
- * @param off_dst               The offset within the destination flash area to
- *                                  copy to.
- * @param sz                    The number of bytes to copy.
+ * @param fap_src               The flash area of the secondary slot.
+ * @param fap_dst               The flash area of the primary slot.
+ * @param off                   The offset of the sector in the primary slot.
+ * @param sector_sz             The size of the sector.
+ * @param sz                    The number of bytes of the sector to copy.
  *
  * @return                      0 on success; nonzero on failure.
  */
-int
-boot_copy_region(struct boot_loader_state *state,
+static int
+boot_copy_sector(struct boot_loader_state *state,
                  const struct flash_area *fap_src,
                  const struct flash_area *fap_dst,
-                 uint32_t off_src, uint32_t off_dst, uint32_t sz)
+                 uint32_t off, uint32_t sector_sz, uint32_t sz)
 {
-    uint32_t bytes_copied;
-    int chunk_sz;
+    uint32_t off_src = boot_img_hdr_off(fap_src) + off;
     int rc;
-#ifdef MCUBOOT_ENC_IMAGES
-    uint32_t off;
-    uint32_t tlv_off;
-    size_t blk_off;
-    struct image_header *hdr;
-    uint16_t idx;
-    uint32_t blk_sz;
-    uint8_t image_index;
-#endif
 
-    TARGET_STATIC uint8_t buf[BUF_SZ] __attribute__((aligned(4)));
-
-#if !defined(MCUBOOT_ENC_IMAGES)
-    (void)state;
-#endif
-
-    bytes_copied = 0;
-    while (bytes_copied < sz) {
-        if (sz - bytes_copied > sizeof buf) {
-            chunk_sz = sizeof buf;
-        } else {
-            chunk_sz = sz - bytes_copied;
-        }
-
-        rc = flash_area_read(fap_src, off_src + bytes_copied, buf, chunk_sz);
-        if (rc != 0) {
+#ifdef MCUBOOT_OVERWRITE_ONLY_DIFF
+    /* Encrypted images are decrypted as they are copied, so the secondary
+     * slot cannot be compared with the primary slot as is.
+     */
+    if (!IS_ENCRYPTED(boot_img_hdr(state, BOOT_SECONDARY_SLOT))) {
+        rc = boot_copy_region_equal(fap_src, fap_dst, off_src, off, sz);
+        if (rc < 0) {
             return BOOT_EFLASH;
         }
-
-#ifdef MCUBOOT_ENC_IMAGES
-        image_index = BOOT_CURR_IMG(state);
-        if ((flash_area_get_id(fap_src) == FLASH_AREA_IMAGE_SECONDARY(image_index) ||
-             flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) &&
-            !(flash_area_get_id(fap_src) == FLASH_AREA_IMAGE_SECONDARY(image_index) &&
-              flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index))) {
-            /* assume the secondary slot as src, needs decryption */
-            hdr = boot_img_hdr(state, BOOT_SECONDARY_SLOT);
-#if !defined(MCUBOOT_SWAP_USING_MOVE)
-            off = off_src;
-            if (flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
-                /* might need encryption (metadata from the primary slot) */
-                hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
-                off = off_dst;
-            }
+        if (rc == 1) {
+            BOOT_LOG_DBG("Sector at 0x%lx unchanged", (unsigned long)off);
+#ifdef MCUBOOT_HASH_ON_COPY
+            return boot_copy_hash_region(state, fap_dst, off, sz);
 #else
-            off = off_dst;
-            if (flash_area_get_id(fap_dst) == FLASH_AREA_IMAGE_SECONDARY(image_index)) {
-                hdr = boot_img_hdr(state, BOOT_PRIMARY_SLOT);
-            }
+            return 0;
 #endif
-            if (IS_ENCRYPTED(hdr)) {
-                uint32_t abs_off = off + bytes_copied;
-                if (abs_off < hdr->ih_hdr_size) {
-                    /* do not decrypt header */
-                    if (abs_off + chunk_sz > hdr->ih_hdr_size) {
-                        /* The lower part of the chunk contains header data */
-                        blk_off = 0;
-                        blk_sz = chunk_sz - (hdr->ih_hdr_size - abs_off);
-                        idx = hdr->ih_hdr_size  - abs_off;
-                    } else {
-                        /* The chunk contains exclusively header data */
-                        blk_sz = 0; /* nothing to decrypt */
-                    }
-                } else {
-                    idx = 0;
-                    blk_sz = chunk_sz;
-                    blk_off = (abs_off - hdr->ih_hdr_size) & 0xf;
-                }
-
-                if (blk_sz > 0)
-                {
-                    tlv_off = BOOT_TLV_OFF(hdr);
-                    if (abs_off + chunk_sz > tlv_off) {
-                        /* do not decrypt TLVs */
-                        if (abs_off >= tlv_off) {
-                            blk_sz = 0;
-                        } else {
-                            blk_sz = tlv_off - abs_off;
-                        }
-                    }
-                    boot_encrypt(BOOT_CURR_ENC(state), image_index, fap_src,
-                            (abs_off + idx) - hdr->ih_hdr_size, blk_sz,
-                            blk_off, &buf[idx]);
-                }
-            }
         }
+    }
 #endif
 
-        rc = flash_area_write(fap_dst, off_dst + bytes_copied, buf, chunk_sz);
-        if (rc != 0) {
-            return BOOT_EFLASH;
-        }
-
-        bytes_copied += chunk_sz;
-
-        MCUBOOT_WATCHDOG_FEED();
+    rc = boot_erase_region_if_required(fap_dst, off, sector_sz);
+    if (rc != 0) {
+        return BOOT_EFLASH;
     }
 
-    return 0;
+    return boot_copy_region(state, fap_src, fap_dst, off_src, off, sz);
 }
+#endif /* MCUBOOT_OVERWRITE_ONLY_RESUME || MCUBOOT_OVERWRITE_ONLY_DIFF */
 
 /**
  * Overwrite primary slot with the image contained in the secondary slot.
  * If a prior copy operation was interrupted by a system reset, this function
- * redos the copy.
+ * redos the copy, or with MCUBOOT_OVERWRITE_ONLY_RESUME resumes it. A delta
+ * image is applied to the primary slot instead, see delta.c, and a compressed
+ * image decompressed to it, see decompress.c.
  *
  * @param bs                    The current boot status.  This function reads
  *                                  this struct to determine if it is resuming
@@ -1110,12 +1937,21 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
     const struct flash_area *fap_primary_slot;
     const struct flash_area *fap_secondary_slot;
     uint8_t image_index;
+    uint32_t off;
+    uint32_t sz;
 
-#if defined(MCUBOOT_OVERWRITE_ONLY_FAST)
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || \
+    defined(MCUBOOT_OVERWRITE_ONLY_DIFF)
+    size_t sect_done = 0;
+#endif
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME)
+    uint32_t trailer_off;
+#elif defined(MCUBOOT_OVERWRITE_ONLY_FAST)
     uint32_t sector;
     uint32_t trailer_sz;
-    uint32_t off;
-    uint32_t sz;
+#endif
+#if defined(MCUBOOT_DELTA_UPGRADE)
+    bool delta;
 #endif
 
     (void)bs;
@@ -1129,7 +1965,6 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
     image_index = BOOT_CURR_IMG(state);
 
     BOOT_LOG_INF("Image %d upgrade secondary slot -> primary slot", image_index);
-    BOOT_LOG_INF("Erasing the primary slot");
 
     rc = flash_area_open(FLASH_AREA_IMAGE_PRIMARY(image_index),
             &fap_primary_slot);
@@ -1139,11 +1974,78 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
             &fap_secondary_slot);
     assert (rc == 0);
 
+#ifdef MCUBOOT_VALIDATION_CACHE
+    /* Before the first write to the primary slot, whichever way it is
+     * rewritten below.
+     */
+    boot_validation_cache_invalidate(image_index);
+#endif
+
+#if defined(MCUBOOT_DELTA_UPGRADE)
+    /* A delta image is applied to the primary slot instead of copied. */
+    delta = boot_img_hdr(state, BOOT_SECONDARY_SLOT)->ih_flags & IMAGE_F_DELTA;
+    if (delta) {
+        rc = boot_delta_apply(state, &sz);
+        if (rc != 0) {
+            return rc;
+        }
+        size = sz;
+        goto copied;
+    }
+#endif
+#if defined(MCUBOOT_DECOMPRESS_IMAGES)
+    if (boot_img_hdr(state, BOOT_SECONDARY_SLOT)->ih_flags &
+        IMAGE_F_COMPRESSED_LZ4) {
+        rc = boot_decomp_apply(state, &sz);
+        if (rc != 0) {
+            return rc;
+        }
+        size = sz;
+        goto copied;
+    }
+#endif
+
     sect_count = boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME)
+    /* Everything before the trailer is copied, or only the image with
+     * MCUBOOT_OVERWRITE_ONLY_FAST. The sectors are erased as they are
+     * copied.
+     */
+    rc = boot_copy_journal_trailer_off(fap_primary_slot, &trailer_off);
+    if (rc != 0) {
+        return rc;
+    }
+#if defined(MCUBOOT_OVERWRITE_ONLY_FAST)
+    size = ALIGN_UP(src_size, BOOT_WRITE_SZ(state));
+    assert(size <= trailer_off);
+#else
+    size = trailer_off;
+#endif
+
+    sect_done = boot_copy_journal_read(state, fap_primary_slot, size);
+    if (sect_done == 0) {
+        rc = boot_copy_journal_start(state, fap_primary_slot, size);
+        if (rc != 0) {
+            return rc;
+        }
+    } else {
+        BOOT_LOG_INF("Image %d resuming the copy after %u sectors",
+                     image_index, (unsigned)sect_done);
+    }
+#else
+#if defined(MCUBOOT_OVERWRITE_ONLY_DIFF)
+    /* The sectors are only erased once found to differ, as they are
+     * copied.
+     */
+#else
+    BOOT_LOG_INF("Erasing the primary slot");
+#endif
     for (sect = 0, size = 0; sect < sect_count; sect++) {
         this_size = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, sect);
-        rc = boot_erase_region(fap_primary_slot, size, this_size);
+#if !defined(MCUBOOT_OVERWRITE_ONLY_DIFF)
+        rc = boot_erase_region_if_required(fap_primary_slot, size, this_size);
         assert(rc == 0);
+#endif
 
 #if defined(MCUBOOT_OVERWRITE_ONLY_FAST)
         if ((size + this_size) >= src_size) {
@@ -1169,6 +2071,7 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
     rc = boot_erase_region(fap_primary_slot, off, sz);
     assert(rc == 0);
 #endif
+#endif /* !MCUBOOT_OVERWRITE_ONLY_RESUME */
 
 #ifdef MCUBOOT_ENC_IMAGES
     if (IS_ENCRYPTED(boot_img_hdr(state, BOOT_SECONDARY_SLOT))) {
@@ -1187,18 +2090,51 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
 
     BOOT_LOG_INF("Image %d copying the secondary slot to the primary slot: 0x%zx bytes",
                  image_index, size);
-    rc = boot_copy_region(state, fap_secondary_slot, fap_primary_slot, 0, 0, size);
+#ifdef MCUBOOT_HASH_ON_COPY
+    /* A resumed copy does not start at the beginning of the image, so the
+     * hash is abandoned and the primary slot is validated from flash.
+     */
+    boot_copy_hash_start(state, boot_img_hdr(state, BOOT_SECONDARY_SLOT), size);
+#endif
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || \
+    defined(MCUBOOT_OVERWRITE_ONLY_DIFF)
+    rc = 0;
+    for (sect = 0, off = 0; sect < sect_count && off < size && rc == 0;
+         sect++) {
+        sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, sect);
+        if (sect >= sect_done) {
+            this_size = (sz < size - off) ? sz : size - off;
+            rc = boot_copy_sector(state, fap_secondary_slot, fap_primary_slot,
+                                  off, sz, this_size);
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME)
+            if (rc == 0) {
+                rc = boot_copy_journal_write(state, fap_primary_slot, sect);
+            }
+#endif
+        }
+        off += sz;
+    }
+#else
+    rc = boot_copy_region(state, fap_secondary_slot, fap_primary_slot,
+                          boot_img_hdr_off(fap_secondary_slot), 0, size);
+#endif
+#ifdef MCUBOOT_HASH_ON_COPY
+    boot_copy_hash_finish(state, rc == 0);
+#endif
     if (rc != 0) {
         return rc;
     }
 
-#if defined(MCUBOOT_OVERWRITE_ONLY_FAST)
+#if defined(MCUBOOT_OVERWRITE_ONLY_FAST) && !defined(MCUBOOT_OVERWRITE_ONLY_RESUME)
     rc = boot_write_magic(fap_primary_slot);
     if (rc != 0) {
         return rc;
     }
 #endif
 
+#if defined(MCUBOOT_DELTA_UPGRADE) || defined(MCUBOOT_DECOMPRESS_IMAGES)
+copied:
+#endif
     rc = BOOT_HOOK_CALL(boot_copy_region_post_hook, 0, BOOT_CURR_IMG(state),
                         BOOT_IMG_AREA(state, BOOT_PRIMARY_SLOT), size);
     if (rc != 0) {
@@ -1225,23 +2161,50 @@ boot_copy_image(struct boot_loader_state *state, struct boot_status *bs)
      * trailer that was left might trigger a new upgrade.
      */
     BOOT_LOG_DBG("erasing secondary header");
-    rc = boot_erase_region(fap_secondary_slot,
-                           boot_img_sector_off(state, BOOT_SECONDARY_SLOT, 0),
-                           boot_img_sector_size(state, BOOT_SECONDARY_SLOT, 0));
+    if (boot_device_requires_erase(fap_secondary_slot)) {
+        off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, 0);
+        sz = boot_img_sector_size(state, BOOT_SECONDARY_SLOT, 0);
+    } else {
+        /* Only the image magic has to read back as erased. */
+        off = 0;
+        sz = ALIGN_UP(sizeof(boot_img_hdr(state, BOOT_SECONDARY_SLOT)->ih_magic),
+                      BOOT_WRITE_SZ(state));
+    }
+    rc = boot_erase_region(fap_secondary_slot, off, sz);
     assert(rc == 0);
-    last_sector = boot_img_num_sectors(state, BOOT_SECONDARY_SLOT) - 1;
     BOOT_LOG_DBG("erasing secondary trailer");
-    rc = boot_erase_region(fap_secondary_slot,
-                           boot_img_sector_off(state, BOOT_SECONDARY_SLOT,
-                               last_sector),
-                           boot_img_sector_size(state, BOOT_SECONDARY_SLOT,
-                               last_sector));
+    if (boot_device_requires_erase(fap_secondary_slot)) {
+        last_sector = boot_img_num_sectors(state, BOOT_SECONDARY_SLOT) - 1;
+        off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, last_sector);
+        sz = boot_img_sector_size(state, BOOT_SECONDARY_SLOT, last_sector);
+    } else {
+        sz = boot_trailer_sz(BOOT_WRITE_SZ(state));
+        off = flash_area_get_size(fap_secondary_slot) - sz;
+    }
+    rc = boot_erase_region(fap_secondary_slot, off, sz);
     assert(rc == 0);
 
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME)
+    /* The upgrade is no longer pending, the journal can go. */
+    rc = boot_copy_journal_drop(fap_primary_slot);
+    if (rc != 0) {
+        return rc;
+    }
+#elif defined(MCUBOOT_DELTA_UPGRADE)
+    if (delta) {
+        /* The upgrade is no longer pending, the journal can go. */
+        rc = boot_copy_journal_drop(fap_primary_slot);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+#endif
+
     flash_area_close(fap_primary_slot);
     flash_area_close(fap_secondary_slot);
 
-    /* TODO: Perhaps verify the primary slot's signature again? */
+    /* With MCUBOOT_HASH_ON_COPY, validating the primary slot reuses the hash
+     * of the data written to it instead of reading it back. */
 
     return 0;
 }
@@ -1279,6 +2242,11 @@ boot_swap_image(struct boot_loader_state *state, struct boot_status *bs)
     size = copy_size = 0;
     image_index = BOOT_CURR_IMG(state);
 
+#ifdef MCUBOOT_VALIDATION_CACHE
+    /* Both new and resumed swaps rewrite the primary slot. */
+    boot_validation_cache_invalidate(image_index);
+#endif
+
     if (boot_status_is_reset(bs)) {
         /*
          * No swap ever happened, so need to find the largest image which
@@ -1371,7 +2339,6 @@ boot_swap_image(struct boot_loader_state *state, struct boot_status *bs)
     swap_run(state, bs, copy_size);
 
 #ifdef MCUBOOT_VALIDATE_PRIMARY_SLOT
-    extern int boot_status_fails;
     if (boot_status_fails > 0) {
         BOOT_LOG_WRN("%d status write fails performing the swap",
                      boot_status_fails);
@@ -1482,7 +2449,7 @@ boot_verify_slot_dependencies(struct boot_loader_state *state, uint32_t slot)
             goto done;
         }
 
-        rc = flash_area_read(fap, off, &dep, len);
+        rc = flash_area_read(fap, boot_img_hdr_off(fap) + off, &dep, len);
         if (rc != 0) {
             rc = BOOT_EFLASH;
             goto done;
@@ -1801,7 +2768,7 @@ boot_prepare_image_for_update(struct boot_loader_state *state,
         }
 #endif
 
-#ifdef MCUBOOT_SWAP_USING_MOVE
+#if defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_OFFSET)
         /*
          * Must re-read image headers because the boot status might
          * have been updated in the previous function call.
@@ -1964,7 +2931,8 @@ static int
 check_downgrade_prevention(struct boot_loader_state *state)
 {
 #if defined(MCUBOOT_DOWNGRADE_PREVENTION) && \
-    (defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_SCRATCH))
+    (defined(MCUBOOT_SWAP_USING_MOVE) || defined(MCUBOOT_SWAP_USING_SCRATCH) || \
+     defined(MCUBOOT_SWAP_USING_OFFSET))
     uint32_t security_counter[2];
     int rc;
 
@@ -2033,6 +3001,12 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
     (void)has_upgrade;
 #endif
 
+    boot_timeline_reset();
+    boot_flash_stats_reset();
+
+    /* The slots may have been written since the last boot. */
+    bootutil_tlv_index_reset();
+
     /* Iterate over all the images. By the end of the loop the swap type has
      * to be determined for each image and all aborted swaps have to be
      * completed.
@@ -2142,6 +3116,10 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 
         switch (BOOT_SWAP_TYPE(state)) {
         case BOOT_SWAP_TYPE_NONE:
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || defined(MCUBOOT_DELTA_UPGRADE)
+            rc = boot_copy_journal_drop_stale(state);
+            assert(rc == 0);
+#endif
             break;
 
         case BOOT_SWAP_TYPE_TEST:
@@ -2176,6 +3154,10 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
                 BOOT_SWAP_TYPE(state) = BOOT_SWAP_TYPE_PANIC;
             }
 #endif /* !MCUBOOT_OVERWRITE_ONLY */
+#if defined(MCUBOOT_OVERWRITE_ONLY_RESUME) || defined(MCUBOOT_DELTA_UPGRADE)
+            rc = boot_copy_journal_drop_stale(state);
+            assert(rc == 0);
+#endif
             break;
 
         default:
@@ -2288,6 +3270,12 @@ out:
 #endif
 
     close_all_flash_areas(state);
+
+#ifdef MCUBOOT_BOOT_TIMELINE
+    boot_export_timeline();
+#endif
+    boot_flash_stats_dump();
+
     FIH_RET(fih_rc);
 }
 
@@ -3260,6 +4248,12 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
     int rc;
     FIH_DECLARE(fih_rc, FIH_FAILURE);
 
+    boot_timeline_reset();
+    boot_flash_stats_reset();
+
+    /* The slots may have been written since the last boot. */
+    bootutil_tlv_index_reset();
+
     rc = boot_get_slot_usage(state);
     if (rc != 0) {
         goto out;
@@ -3317,6 +4311,11 @@ context_boot_go(struct boot_loader_state *state, struct boot_rsp *rsp)
 out:
     close_all_flash_areas(state);
 
+#ifdef MCUBOOT_BOOT_TIMELINE
+    boot_export_timeline();
+#endif
+    boot_flash_stats_dump();
+
     if (rc != 0) {
         FIH_SET(fih_rc, FIH_FAILURE);
     }
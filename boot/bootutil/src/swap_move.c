@@ -32,21 +32,6 @@ BOOT_LOG_MODULE_DECLARE(mcuboot);
 
 #ifdef MCUBOOT_SWAP_USING_MOVE
 
-#if defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
-/*
- * FIXME: this might have to be updated for threaded sim
- */
-int boot_status_fails = 0;
-#define BOOT_STATUS_ASSERT(x)                \
-    do {                                     \
-        if (!(x)) {                          \
-            boot_status_fails++;             \
-        }                                    \
-    } while (0)
-#else
-#define BOOT_STATUS_ASSERT(x) ASSERT(x)
-#endif
-
 uint32_t
 find_last_idx(struct boot_loader_state *state, uint32_t swap_size)
 {
@@ -394,7 +379,7 @@ boot_move_sector_up(int idx, uint32_t sz, struct boot_loader_state *state,
         assert(rc == 0);
     }
 
-    rc = boot_erase_region(fap_pri, new_off, sz);
+    rc = boot_erase_region_if_required(fap_pri, new_off, sz);
     assert(rc == 0);
 
     rc = boot_copy_region(state, fap_pri, fap_pri, old_off, new_off, sz);
@@ -421,7 +406,7 @@ boot_swap_sectors(int idx, uint32_t sz, struct boot_loader_state *state,
     sec_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx - 1);
 
     if (bs->state == BOOT_STATUS_STATE_0) {
-        rc = boot_erase_region(fap_pri, pri_off, sz);
+        rc = boot_erase_region_if_required(fap_pri, pri_off, sz);
         assert(rc == 0);
 
         rc = boot_copy_region(state, fap_sec, fap_pri, sec_off, pri_off, sz);
@@ -433,7 +418,7 @@ boot_swap_sectors(int idx, uint32_t sz, struct boot_loader_state *state,
     }
 
     if (bs->state == BOOT_STATUS_STATE_1) {
-        rc = boot_erase_region(fap_sec, sec_off, sz);
+        rc = boot_erase_region_if_required(fap_sec, sec_off, sz);
         assert(rc == 0);
 
         rc = boot_copy_region(state, fap_pri, fap_sec, pri_up_off, sec_off, sz);
@@ -554,7 +539,9 @@ swap_run(struct boot_loader_state *state, struct boot_status *bs,
         idx = last_idx;
         while (idx > 0) {
             if (idx <= (last_idx - bs->idx + 1)) {
+                BOOT_PHASE_BEGIN(BOOT_PHASE_SWAP_STEP);
                 boot_move_sector_up(idx, sector_sz, state, bs, fap_pri, fap_sec);
+                BOOT_PHASE_END(BOOT_PHASE_SWAP_STEP, sector_sz);
             }
             idx--;
         }
@@ -566,7 +553,9 @@ swap_run(struct boot_loader_state *state, struct boot_status *bs,
     idx = 1;
     while (idx <= last_idx) {
         if (idx >= bs->idx) {
+            BOOT_PHASE_BEGIN(BOOT_PHASE_SWAP_STEP);
             boot_swap_sectors(idx, sector_sz, state, bs, fap_pri, fap_sec);
+            BOOT_PHASE_END(BOOT_PHASE_SWAP_STEP, sector_sz);
         }
         idx++;
     }
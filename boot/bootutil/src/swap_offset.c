@@ -0,0 +1,712 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2019 JUUL Labs
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Swap using offset.
+ *
+ * An upgrade image is written to the secondary slot starting at its second
+ * sector, so the first sector of the secondary slot is free. The swap then
+ * takes one pass over the image, sector k being handled as:
+ *
+ *   state 0: primary[k]       -> secondary[k]
+ *   state 1: secondary[k + 1] -> primary[k]
+ *
+ * which leaves the new image in the primary slot and the old one in the
+ * secondary slot, starting at offset 0. A revert runs the same steps the
+ * other way around, from the last sector down to the first one:
+ *
+ *   state 0: primary[k]       -> secondary[k + 1]
+ *   state 1: secondary[k]     -> primary[k]
+ *
+ * and leaves the old image in the secondary slot at the first sector offset
+ * again. Every step only overwrites a sector whose content was already
+ * copied elsewhere, and the status is only kept in the primary slot trailer,
+ * so an interrupted swap is resumed from the last step written.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bootutil/bootutil.h"
+#include "bootutil_priv.h"
+#include "swap_priv.h"
+#include "bootutil/bootutil_log.h"
+
+#include "mcuboot_config/mcuboot_config.h"
+
+BOOT_LOG_MODULE_DECLARE(mcuboot);
+
+#ifdef MCUBOOT_SWAP_USING_OFFSET
+
+/* Offset of the image in the secondary slot of each image, updated whenever
+ * its header is read. */
+#ifdef __BOOTSIM__
+/* The simulator runs its tests in parallel threads. */
+static __thread uint32_t secondary_hdr_off[BOOT_IMAGE_NUMBER];
+#else
+static uint32_t secondary_hdr_off[BOOT_IMAGE_NUMBER];
+#endif
+
+uint32_t
+boot_img_hdr_off(const struct flash_area *fap)
+{
+    int i;
+
+    for (i = 0; i < BOOT_IMAGE_NUMBER; i++) {
+        if (flash_area_get_id(fap) == FLASH_AREA_IMAGE_SECONDARY(i)) {
+            return secondary_hdr_off[i];
+        }
+    }
+
+    return 0;
+}
+
+uint32_t
+find_last_idx(struct boot_loader_state *state, uint32_t swap_size)
+{
+    uint32_t sector_sz;
+    uint32_t sz;
+    uint32_t last_idx;
+
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+    sz = 0;
+    last_idx = 0;
+    while (1) {
+        sz += sector_sz;
+        last_idx++;
+        if (sz >= swap_size) {
+            break;
+        }
+    }
+
+    return last_idx;
+}
+
+/*
+ * Returns the index of the first sector of the given slot which holds part
+ * of the trailer.
+ */
+static uint32_t
+first_trailer_idx(struct boot_loader_state *state, int slot)
+{
+    uint32_t sz;
+    uint32_t trailer_sz;
+    uint32_t idx;
+
+    sz = 0;
+    trailer_sz = boot_trailer_sz(BOOT_WRITE_SZ(state));
+    idx = boot_img_num_sectors(state, slot) - 1;
+
+    while (1) {
+        sz += boot_img_sector_size(state, slot, idx);
+        if (sz >= trailer_sz) {
+            break;
+        }
+        idx--;
+    }
+
+    return idx;
+}
+
+/*
+ * Finds where the image in the secondary slot starts when no swap is in
+ * progress, from the trailers:
+ *
+ * - an upgrade was requested: the new image is at the first sector offset,
+ *   unless the secondary slot trailer was written by fixup_revert();
+ * - the last swap completed: the previous image was moved to offset 0 by
+ *   an upgrade, or to the first sector offset by a revert;
+ * - the primary slot status was initialized but no swap step was done yet:
+ *   the image is still where the pending swap expects it.
+ */
+static uint32_t
+secondary_hdr_off_idle(struct boot_loader_state *state)
+{
+    struct boot_swap_state state_primary_slot;
+    struct boot_swap_state state_secondary_slot;
+    uint32_t sz;
+    uint8_t image_index;
+    int rc;
+
+    image_index = BOOT_CURR_IMG(state);
+    sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(image_index),
+            &state_secondary_slot);
+    if (rc == 0 && state_secondary_slot.magic == BOOT_MAGIC_GOOD) {
+        return (state_secondary_slot.swap_type == BOOT_SWAP_TYPE_REVERT) ?
+               0 : sz;
+    }
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_PRIMARY(image_index),
+            &state_primary_slot);
+    if (rc == 0 && state_primary_slot.magic == BOOT_MAGIC_GOOD) {
+        if (state_primary_slot.copy_done == BOOT_FLAG_SET) {
+            return (state_primary_slot.swap_type == BOOT_SWAP_TYPE_REVERT) ?
+                   sz : 0;
+        }
+        return (state_primary_slot.swap_type == BOOT_SWAP_TYPE_REVERT) ?
+               0 : sz;
+    }
+
+    return sz;
+}
+
+int
+boot_read_image_header(struct boot_loader_state *state, int slot,
+                       struct image_header *out_hdr, struct boot_status *bs)
+{
+    const struct flash_area *fap;
+    uint32_t off;
+    uint32_t sz;
+    uint32_t last_idx;
+    uint32_t swap_size;
+    int area_id;
+    int rc;
+
+    sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+
+    if (bs && !boot_status_is_reset(bs)) {
+        boot_find_status(BOOT_CURR_IMG(state), &fap);
+        if (fap == NULL || boot_read_swap_size(fap, &swap_size)) {
+            rc = BOOT_EFLASH;
+            goto done;
+        }
+        flash_area_close(fap);
+
+        last_idx = find_last_idx(state, swap_size);
+
+        /*
+         * Find the slot and offset where the image header is expected to be
+         * found for the step the swap was interrupted at. Once the swap is
+         * done the headers are read from their final location.
+         */
+        if (bs->swap_type != BOOT_SWAP_TYPE_REVERT) {
+            if (slot == 0) {
+                off = 0;
+                if (bs->idx <= last_idx &&
+                    !(bs->idx == 1 && bs->state == BOOT_STATUS_STATE_0)) {
+                    slot = 1;
+                }
+            } else {
+                off = 0;
+                if (bs->idx == 1) {
+                    off = sz;
+                } else if (bs->idx <= last_idx) {
+                    slot = 0;
+                }
+            }
+        } else {
+            if (slot == 0) {
+                off = 0;
+                if (bs->idx == last_idx && bs->state == BOOT_STATUS_STATE_1) {
+                    slot = 1;
+                    off = sz;
+                }
+            } else {
+                off = (bs->idx > last_idx) ? sz : 0;
+            }
+        }
+    } else {
+        off = (slot == 0) ? 0 : secondary_hdr_off_idle(state);
+    }
+
+    area_id = flash_area_id_from_multi_image_slot(BOOT_CURR_IMG(state), slot);
+    rc = flash_area_open(area_id, &fap);
+    if (rc != 0) {
+        rc = BOOT_EFLASH;
+        goto done;
+    }
+
+    if (slot == 1) {
+        secondary_hdr_off[BOOT_CURR_IMG(state)] = off;
+    }
+
+    rc = flash_area_read(fap, off, out_hdr, sizeof *out_hdr);
+    if (rc != 0) {
+        rc = BOOT_EFLASH;
+        goto done;
+    }
+
+    /* We only know where the headers are located when bs is valid */
+    if (bs != NULL && out_hdr->ih_magic != IMAGE_MAGIC) {
+        rc = -1;
+        goto done;
+    }
+
+    rc = 0;
+
+done:
+    flash_area_close(fap);
+    return rc;
+}
+
+int
+swap_read_status_bytes(const struct flash_area *fap,
+        struct boot_loader_state *state, struct boot_status *bs)
+{
+    uint32_t off;
+    uint8_t status;
+    int max_entries;
+    int found_idx;
+    uint8_t write_sz;
+    int rc;
+    int last_rc;
+    int erased_sections;
+    int i;
+
+    max_entries = boot_status_entries(BOOT_CURR_IMG(state), fap);
+    if (max_entries < 0) {
+        return BOOT_EBADARGS;
+    }
+
+    erased_sections = 0;
+    found_idx = -1;
+    /* skip erased sectors at the end */
+    last_rc = 1;
+    write_sz = BOOT_WRITE_SZ(state);
+    off = boot_status_off(fap);
+    for (i = max_entries; i > 0; i--) {
+        rc = flash_area_read(fap, off + (i - 1) * write_sz, &status, 1);
+        if (rc < 0) {
+            return BOOT_EFLASH;
+        }
+
+        if (bootutil_buffer_is_erased(fap, &status, 1)) {
+            if (rc != last_rc) {
+                erased_sections++;
+            }
+        } else {
+            if (found_idx == -1) {
+                found_idx = i;
+            }
+        }
+        last_rc = rc;
+    }
+
+    if (erased_sections > 1) {
+        /* This means there was an error writing status on the last
+         * swap. Tell user and move on to validation!
+         */
+#if !defined(__BOOTSIM__)
+        BOOT_LOG_ERR("Detected inconsistent status!");
+#endif
+
+#if !defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
+        /* With validation of the primary slot disabled, there is no way
+         * to be sure the swapped primary slot is OK, so abort!
+         */
+        assert(0);
+#endif
+    }
+
+    if (found_idx == -1) {
+        /* no swap status found; nothing to do */
+    } else {
+        bs->op = BOOT_STATUS_OP_SWAP;
+        bs->idx = (found_idx / BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_IDX_0;
+        bs->state = (found_idx % BOOT_STATUS_SWAP_STATE_COUNT) + BOOT_STATUS_STATE_0;
+    }
+
+    return 0;
+}
+
+uint32_t
+boot_status_internal_off(const struct boot_status *bs, int elem_sz)
+{
+    uint32_t off;
+    int idx_sz;
+
+    idx_sz = elem_sz * BOOT_STATUS_SWAP_STATE_COUNT;
+
+    off = (bs->idx - BOOT_STATUS_IDX_0) * idx_sz +
+          (bs->state - BOOT_STATUS_STATE_0) * elem_sz;
+
+    return off;
+}
+
+/*
+ * Returns the number of sectors available to an image. The image must leave
+ * the trailer sectors of the primary slot untouched and, once stored one
+ * sector into the secondary slot, those of the secondary slot.
+ */
+static uint32_t
+app_max_sectors(struct boot_loader_state *state)
+{
+    uint32_t pri_sectors;
+    uint32_t sec_sectors;
+
+    pri_sectors = first_trailer_idx(state, BOOT_PRIMARY_SLOT);
+    sec_sectors = first_trailer_idx(state, BOOT_SECONDARY_SLOT) - 1;
+
+    return (pri_sectors < sec_sectors) ? pri_sectors : sec_sectors;
+}
+
+int
+boot_slots_compatible(struct boot_loader_state *state)
+{
+    size_t num_sectors_pri;
+    size_t num_sectors_sec;
+    size_t sector_sz;
+    size_t i;
+
+    num_sectors_pri = boot_img_num_sectors(state, BOOT_PRIMARY_SLOT);
+    num_sectors_sec = boot_img_num_sectors(state, BOOT_SECONDARY_SLOT);
+
+    if ((num_sectors_sec != num_sectors_pri) &&
+            (num_sectors_sec != (num_sectors_pri + 1))) {
+        BOOT_LOG_WRN("Cannot upgrade: not a compatible amount of sectors");
+        BOOT_LOG_DBG("slot0 sectors: %d, slot1 sectors: %d",
+                     (int)num_sectors_pri, (int)num_sectors_sec);
+        return 0;
+    } else if (num_sectors_sec > BOOT_MAX_IMG_SECTORS) {
+        BOOT_LOG_WRN("Cannot upgrade: more sectors than allowed");
+        return 0;
+    }
+
+    if (num_sectors_sec == num_sectors_pri) {
+        BOOT_LOG_DBG("Non-optimal sector distribution, slot1 has %d sectors "
+                     "but should have one more than slot0", (int)num_sectors_sec);
+    }
+
+    /* Sectors are shifted by one between the slots, so all of them must
+     * have the same size. */
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+    for (i = 0; i < num_sectors_sec; i++) {
+        if ((i < num_sectors_pri &&
+             boot_img_sector_size(state, BOOT_PRIMARY_SLOT, i) != sector_sz) ||
+            boot_img_sector_size(state, BOOT_SECONDARY_SLOT, i) != sector_sz) {
+            BOOT_LOG_WRN("Cannot upgrade: not same sector layout");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#define BOOT_LOG_SWAP_STATE(area, state)                            \
+    BOOT_LOG_INF("%s: magic=%s, swap_type=0x%x, copy_done=0x%x, "   \
+                 "image_ok=0x%x",                                   \
+                 (area),                                            \
+                 ((state)->magic == BOOT_MAGIC_GOOD ? "good" :      \
+                  (state)->magic == BOOT_MAGIC_UNSET ? "unset" :    \
+                  "bad"),                                           \
+                 (state)->swap_type,                                \
+                 (state)->copy_done,                                \
+                 (state)->image_ok)
+
+int
+swap_status_source(struct boot_loader_state *state)
+{
+    struct boot_swap_state state_primary_slot;
+    struct boot_swap_state state_secondary_slot;
+    int rc;
+    uint8_t source;
+    uint8_t image_index;
+
+#if (BOOT_IMAGE_NUMBER == 1)
+    (void)state;
+#endif
+
+    image_index = BOOT_CURR_IMG(state);
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_PRIMARY(image_index),
+            &state_primary_slot);
+    assert(rc == 0);
+
+    BOOT_LOG_SWAP_STATE("Primary image", &state_primary_slot);
+
+    rc = boot_read_swap_state_by_id(FLASH_AREA_IMAGE_SECONDARY(image_index),
+            &state_secondary_slot);
+    assert(rc == 0);
+
+    BOOT_LOG_SWAP_STATE("Secondary image", &state_secondary_slot);
+
+    if (state_primary_slot.magic == BOOT_MAGIC_GOOD &&
+            state_primary_slot.copy_done == BOOT_FLAG_UNSET &&
+            state_secondary_slot.magic != BOOT_MAGIC_GOOD) {
+
+        source = BOOT_STATUS_SOURCE_PRIMARY_SLOT;
+
+        BOOT_LOG_INF("Boot source: primary slot");
+        return source;
+    }
+
+    BOOT_LOG_INF("Boot source: none");
+    return BOOT_STATUS_SOURCE_NONE;
+}
+
+/*
+ * Initializes the trailers before the first step of a swap.
+ */
+static void
+boot_swap_start(struct boot_loader_state *state, struct boot_status *bs,
+        const struct flash_area *fap_pri, const struct flash_area *fap_sec)
+{
+    int rc;
+
+    if (bs->source != BOOT_STATUS_SOURCE_PRIMARY_SLOT) {
+        rc = swap_erase_trailer_sectors(state, fap_pri);
+        assert(rc == 0);
+
+        rc = swap_status_init(state, fap_pri, bs);
+        assert(rc == 0);
+    }
+
+    rc = swap_erase_trailer_sectors(state, fap_sec);
+    assert(rc == 0);
+}
+
+/*
+ * Moves the image in the primary slot to the secondary slot at offset 0 and
+ * the image in the secondary slot, stored one sector higher, to the primary
+ * slot. Sector idx - 1 is handled.
+ */
+static void
+boot_swap_sectors(int idx, uint32_t sz, struct boot_loader_state *state,
+        struct boot_status *bs, const struct flash_area *fap_pri,
+        const struct flash_area *fap_sec)
+{
+    uint32_t pri_off;
+    uint32_t sec_off;
+    uint32_t sec_up_off;
+    int rc;
+
+    pri_off = boot_img_sector_off(state, BOOT_PRIMARY_SLOT, idx - 1);
+    sec_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx - 1);
+    sec_up_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, idx);
+
+    if (bs->state == BOOT_STATUS_STATE_0) {
+        if (bs->idx == BOOT_STATUS_IDX_0) {
+            boot_swap_start(state, bs, fap_pri, fap_sec);
+        }
+
+        rc = boot_erase_region_if_required(fap_sec, sec_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_pri, fap_sec, pri_off, sec_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->state = BOOT_STATUS_STATE_1;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+
+    if (bs->state == BOOT_STATUS_STATE_1) {
+        rc = boot_erase_region_if_required(fap_pri, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_sec, fap_pri, sec_up_off, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->idx++;
+        bs->state = BOOT_STATUS_STATE_0;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+}
+
+/*
+ * Reverse of boot_swap_sectors(): moves the image in the primary slot to the
+ * secondary slot one sector higher and the image in the secondary slot, at
+ * offset 0, to the primary slot. Sector last_idx - idx is handled, so that
+ * the sectors are processed from the last one down.
+ */
+static void
+boot_swap_sectors_revert(int idx, uint32_t last_idx, uint32_t sz,
+        struct boot_loader_state *state, struct boot_status *bs,
+        const struct flash_area *fap_pri, const struct flash_area *fap_sec)
+{
+    uint32_t pri_off;
+    uint32_t sec_off;
+    uint32_t sec_up_off;
+    int rc;
+
+    pri_off = boot_img_sector_off(state, BOOT_PRIMARY_SLOT, last_idx - idx);
+    sec_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT, last_idx - idx);
+    sec_up_off = boot_img_sector_off(state, BOOT_SECONDARY_SLOT,
+                                     last_idx - idx + 1);
+
+    if (bs->state == BOOT_STATUS_STATE_0) {
+        if (bs->idx == BOOT_STATUS_IDX_0) {
+            boot_swap_start(state, bs, fap_pri, fap_sec);
+        }
+
+        rc = boot_erase_region_if_required(fap_sec, sec_up_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_pri, fap_sec, pri_off, sec_up_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->state = BOOT_STATUS_STATE_1;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+
+    if (bs->state == BOOT_STATUS_STATE_1) {
+        rc = boot_erase_region_if_required(fap_pri, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_copy_region(state, fap_sec, fap_pri, sec_off, pri_off, sz);
+        assert(rc == 0);
+
+        rc = boot_write_status(state, bs);
+        bs->idx++;
+        bs->state = BOOT_STATUS_STATE_0;
+        BOOT_STATUS_ASSERT(rc == 0);
+    }
+}
+
+/*
+ * When starting a revert the swap status exists in the primary slot, and
+ * the status in the secondary slot is erased. To start the swap, the status
+ * area in the primary slot must be re-initialized; if during the small
+ * window of time between re-initializing it and writing the first metadata
+ * a reset happens, the swap process is broken and cannot be resumed.
+ *
+ * This function handles the issue by making the revert look like a permanent
+ * upgrade (by initializing the secondary slot). The swap type is recorded as
+ * a revert as well, so the image in the secondary slot is still looked up at
+ * offset 0 after such a reset.
+ */
+void
+fixup_revert(const struct boot_loader_state *state, struct boot_status *bs,
+        const struct flash_area *fap_sec)
+{
+    struct boot_swap_state swap_state;
+    int rc;
+
+#if (BOOT_IMAGE_NUMBER == 1)
+    (void)state;
+#endif
+
+    /* No fixup required */
+    if (bs->swap_type != BOOT_SWAP_TYPE_REVERT ||
+        bs->idx != BOOT_STATUS_IDX_0 ||
+        bs->state != BOOT_STATUS_STATE_0) {
+        return;
+    }
+
+    rc = boot_read_swap_state(fap_sec, &swap_state);
+    assert(rc == 0);
+
+    BOOT_LOG_SWAP_STATE("Secondary image", &swap_state);
+
+    if (swap_state.magic == BOOT_MAGIC_UNSET) {
+        rc = swap_erase_trailer_sectors(state, fap_sec);
+        assert(rc == 0);
+
+        rc = boot_write_image_ok(fap_sec);
+        assert(rc == 0);
+
+        rc = boot_write_swap_info(fap_sec, BOOT_SWAP_TYPE_REVERT,
+                                  BOOT_CURR_IMG(state));
+        assert(rc == 0);
+
+        rc = boot_write_swap_size(fap_sec, bs->swap_size);
+        assert(rc == 0);
+
+        rc = boot_write_magic(fap_sec);
+        assert(rc == 0);
+    }
+}
+
+void
+swap_run(struct boot_loader_state *state, struct boot_status *bs,
+         uint32_t copy_size)
+{
+    uint32_t sector_sz;
+    uint32_t idx;
+    uint32_t last_idx;
+    uint32_t max_sectors;
+    uint8_t image_index;
+    const struct flash_area *fap_pri;
+    const struct flash_area *fap_sec;
+    int rc;
+
+    BOOT_LOG_INF("Starting swap using offset algorithm.");
+
+    last_idx = find_last_idx(state, copy_size);
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+
+    image_index = BOOT_CURR_IMG(state);
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_PRIMARY(image_index), &fap_pri);
+    assert (rc == 0);
+
+    rc = flash_area_open(FLASH_AREA_IMAGE_SECONDARY(image_index), &fap_sec);
+    assert (rc == 0);
+
+    /*
+     * When starting a new swap upgrade, check that there is enough space,
+     * and find out in which direction the images have to be moved.
+     */
+    if (boot_status_is_reset(bs)) {
+        max_sectors = app_max_sectors(state);
+        if (last_idx > max_sectors) {
+            BOOT_LOG_WRN("Not enough free space to run swap upgrade");
+            BOOT_LOG_WRN("required %d bytes but only %d are available",
+                         last_idx * sector_sz, max_sectors * sector_sz);
+            bs->swap_type = BOOT_SWAP_TYPE_NONE;
+            goto out;
+        }
+
+        /* Also covers a revert interrupted right after fixup_revert(),
+         * which then looks like a permanent upgrade. */
+        if (boot_img_hdr_off(fap_sec) == 0) {
+            bs->swap_type = BOOT_SWAP_TYPE_REVERT;
+        }
+    }
+
+    fixup_revert(state, bs, fap_sec);
+
+    bs->op = BOOT_STATUS_OP_SWAP;
+
+    idx = 1;
+    while (idx <= last_idx) {
+        if (idx >= bs->idx) {
+            BOOT_PHASE_BEGIN(BOOT_PHASE_SWAP_STEP);
+            if (bs->swap_type == BOOT_SWAP_TYPE_REVERT) {
+                boot_swap_sectors_revert(idx, last_idx, sector_sz, state, bs,
+                                         fap_pri, fap_sec);
+            } else {
+                boot_swap_sectors(idx, sector_sz, state, bs, fap_pri, fap_sec);
+            }
+            BOOT_PHASE_END(BOOT_PHASE_SWAP_STEP, sector_sz);
+        }
+        idx++;
+    }
+
+out:
+    flash_area_close(fap_pri);
+    flash_area_close(fap_sec);
+}
+
+int app_max_size(struct boot_loader_state *state)
+{
+    uint32_t sector_sz;
+
+    sector_sz = boot_img_sector_size(state, BOOT_PRIMARY_SLOT, 0);
+
+    return (app_max_sectors(state) * sector_sz);
+}
+
+#endif
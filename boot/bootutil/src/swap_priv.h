@@ -21,7 +21,24 @@
 
 #include "mcuboot_config/mcuboot_config.h"
 
-#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE)
+#if defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
+    defined(MCUBOOT_SWAP_USING_OFFSET)
+
+#if defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
+/*
+ * Number of status writes that failed during the swap, counted instead of
+ * asserting so that the simulator can check them.
+ */
+extern int boot_status_fails;
+#define BOOT_STATUS_ASSERT(x)                \
+    do {                                     \
+        if (!(x)) {                          \
+            boot_status_fails++;             \
+        }                                    \
+    } while (0)
+#else
+#define BOOT_STATUS_ASSERT(x) ASSERT(x)
+#endif
 
 /**
  * Calculates the amount of space required to store the trailer, and erases
@@ -99,7 +116,8 @@ static inline size_t boot_scratch_area_size(const struct boot_loader_state *stat
 }
 #endif
 
-#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) */
+#endif /* defined(MCUBOOT_SWAP_USING_SCRATCH) || defined(MCUBOOT_SWAP_USING_MOVE) || \
+          defined(MCUBOOT_SWAP_USING_OFFSET) */
 
 /**
  * Returns the maximum size of an application that can be loaded to a slot.
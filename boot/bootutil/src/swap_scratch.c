@@ -30,22 +30,7 @@
 
 BOOT_LOG_MODULE_DECLARE(mcuboot);
 
-#if !defined(MCUBOOT_SWAP_USING_MOVE)
-
-#if defined(MCUBOOT_VALIDATE_PRIMARY_SLOT)
-/*
- * FIXME: this might have to be updated for threaded sim
- */
-int boot_status_fails = 0;
-#define BOOT_STATUS_ASSERT(x)                \
-    do {                                     \
-        if (!(x)) {                          \
-            boot_status_fails++;             \
-        }                                    \
-    } while (0)
-#else
-#define BOOT_STATUS_ASSERT(x) ASSERT(x)
-#endif
+#if !defined(MCUBOOT_SWAP_USING_MOVE) && !defined(MCUBOOT_SWAP_USING_OFFSET)
 
 int
 boot_read_image_header(struct boot_loader_state *state, int slot,
@@ -591,7 +576,14 @@ boot_swap_sectors(int idx, uint32_t sz, struct boot_loader_state *state,
     }
 
     if (bs->state == BOOT_STATUS_STATE_1) {
-        rc = boot_erase_region(fap_secondary_slot, img_off, sz);
+        /* The erase can only be skipped when the whole region is rewritten;
+         * a truncated copy leaves trailer space which must read as erased.
+         */
+        if (copy_sz == sz) {
+            rc = boot_erase_region_if_required(fap_secondary_slot, img_off, sz);
+        } else {
+            rc = boot_erase_region(fap_secondary_slot, img_off, sz);
+        }
         assert(rc == 0);
 
         rc = boot_copy_region(state, fap_primary_slot, fap_secondary_slot,
@@ -612,7 +604,11 @@ boot_swap_sectors(int idx, uint32_t sz, struct boot_loader_state *state,
     }
 
     if (bs->state == BOOT_STATUS_STATE_2) {
-        rc = boot_erase_region(fap_primary_slot, img_off, sz);
+        if (copy_sz == sz) {
+            rc = boot_erase_region_if_required(fap_primary_slot, img_off, sz);
+        } else {
+            rc = boot_erase_region(fap_primary_slot, img_off, sz);
+        }
         assert(rc == 0);
 
         /* NOTE: If this is the final sector, we exclude the image trailer from
@@ -733,7 +729,9 @@ swap_run(struct boot_loader_state *state, struct boot_status *bs,
     while (last_sector_idx >= 0) {
         sz = boot_copy_sz(state, last_sector_idx, &first_sector_idx);
         if (swap_idx >= (bs->idx - BOOT_STATUS_IDX_0)) {
+            BOOT_PHASE_BEGIN(BOOT_PHASE_SWAP_STEP);
             boot_swap_sectors(first_sector_idx, sz, state, bs);
+            BOOT_PHASE_END(BOOT_PHASE_SWAP_STEP, sz);
         }
 
         last_sector_idx = first_sector_idx - 1;
@@ -857,4 +855,4 @@ int app_max_size(struct boot_loader_state *state)
 
 #endif /* !MCUBOOT_DIRECT_XIP && !MCUBOOT_RAM_LOAD */
 
-#endif /* !MCUBOOT_SWAP_USING_MOVE */
+#endif /* !MCUBOOT_SWAP_USING_MOVE && !MCUBOOT_SWAP_USING_OFFSET */
@@ -18,25 +18,15 @@
  */
 
 #include <stddef.h>
+#include <string.h>
 
 #include "bootutil/bootutil.h"
 #include "bootutil/image.h"
 #include "bootutil_priv.h"
 
-/*
- * Initialize a TLV iterator.
- *
- * @param it An iterator struct
- * @param hdr image_header of the slot's image
- * @param fap flash_area of the slot which is storing the image
- * @param type Type of TLV to look for
- * @param prot true if TLV has to be stored in the protected area, false otherwise
- *
- * @returns 0 if the TLV iterator was successfully started
- *          -1 on errors
- */
-int
-bootutil_tlv_iter_begin(struct image_tlv_iter *it, const struct image_header *hdr,
+static int
+bootutil_tlv_walk_begin(struct image_tlv_iter *it,
+                        const struct image_header *hdr,
                         const struct flash_area *fap, uint16_t type, bool prot)
 {
     uint32_t off_;
@@ -76,9 +66,243 @@ bootutil_tlv_iter_begin(struct image_tlv_iter *it, const struct image_header *hd
     it->tlv_end = off_ + it->hdr->ih_protect_tlv_size + info.it_tlv_tot;
     // position on first TLV
     it->tlv_off = off_ + sizeof(info);
+    it->tlv_data = IMAGE_DATA_PTR(hdr, fap, off_, it->tlv_end - off_);
+    it->idx = NULL;
+    it->idx_pos = 0;
     return 0;
 }
 
+#ifdef MCUBOOT_TLV_INDEX
+
+#ifndef MCUBOOT_TLV_INDEX_MAX_TLVS
+#define MCUBOOT_TLV_INDEX_MAX_TLVS  12
+#endif
+
+/* Number of slots whose TLV index is kept. */
+#define BOOT_TLV_INDEX_CNT          (BOOT_IMAGE_NUMBER * BOOT_NUM_SLOTS)
+
+/*
+ * Type, offset and length of every TLV of an image, recorded in a single pass
+ * over its TLV area. The protected TLVs come first.
+ */
+struct image_tlv_index {
+    bool valid;
+    uint8_t fa_id;
+    uint8_t cnt;
+    uint8_t prot_cnt;
+    uint32_t prot_end;
+    uint32_t tlv_end;
+    struct image_header hdr;
+    struct {
+        uint16_t type;
+        uint16_t len;
+        uint32_t off;
+    } tlvs[MCUBOOT_TLV_INDEX_MAX_TLVS];
+};
+
+#ifdef __BOOTSIM__
+/* The simulator runs its tests in parallel threads. */
+static __thread struct image_tlv_index tlv_index[BOOT_TLV_INDEX_CNT];
+static __thread uint8_t tlv_index_next;
+#else
+static struct image_tlv_index tlv_index[BOOT_TLV_INDEX_CNT];
+static uint8_t tlv_index_next;
+#endif
+
+/*
+ * Walks the TLV area of an image once and records every TLV in `idx`.
+ *
+ * @returns 0 on success
+ *          1 if the image has more TLVs than the index can hold
+ *          -1 on errors, including TLVs running past the end of the area
+ */
+static int
+bootutil_tlv_index_build(struct image_tlv_index *idx,
+                         const struct image_header *hdr,
+                         const struct flash_area *fap)
+{
+    struct image_tlv_iter it;
+    uint32_t off;
+    uint16_t len;
+    uint16_t type;
+    int rc;
+
+    idx->valid = false;
+
+    rc = bootutil_tlv_walk_begin(&it, hdr, fap, IMAGE_TLV_ANY, false);
+    if (rc != 0) {
+        return -1;
+    }
+
+    idx->cnt = 0;
+    idx->prot_cnt = 0;
+    idx->prot_end = it.prot_end;
+    idx->tlv_end = it.tlv_end;
+
+    while ((rc = bootutil_tlv_iter_next(&it, &off, &len, &type)) == 0) {
+        if (off > it.tlv_end || len > it.tlv_end - off) {
+            return -1;
+        }
+
+        if (idx->cnt == MCUBOOT_TLV_INDEX_MAX_TLVS) {
+            return 1;
+        }
+
+        idx->tlvs[idx->cnt].type = type;
+        idx->tlvs[idx->cnt].len = len;
+        idx->tlvs[idx->cnt].off = off;
+        idx->cnt++;
+        if (off < it.prot_end) {
+            idx->prot_cnt = idx->cnt;
+        }
+    }
+    if (rc < 0) {
+        return -1;
+    }
+
+    idx->fa_id = flash_area_get_id(fap);
+    memcpy(&idx->hdr, hdr, sizeof(idx->hdr));
+    idx->valid = true;
+    return 0;
+}
+
+/*
+ * Returns the TLV index of the image in a slot, building it on first use.
+ *
+ * @returns 0 and the index in `idxp` on success
+ *          1 if the image has too many TLVs to be indexed
+ *          -1 on errors
+ */
+static int
+bootutil_tlv_index_get(const struct image_header *hdr,
+                       const struct flash_area *fap,
+                       const struct image_tlv_index **idxp)
+{
+    struct image_tlv_index *idx;
+    uint8_t fa_id;
+    int rc;
+    int i;
+
+    fa_id = flash_area_get_id(fap);
+    for (i = 0; i < BOOT_TLV_INDEX_CNT; i++) {
+        idx = &tlv_index[i];
+        if (idx->valid && idx->fa_id == fa_id &&
+            memcmp(&idx->hdr, hdr, sizeof(*hdr)) == 0) {
+            *idxp = idx;
+            return 0;
+        }
+    }
+
+    for (i = 0; i < BOOT_TLV_INDEX_CNT; i++) {
+        if (!tlv_index[i].valid) {
+            break;
+        }
+    }
+    if (i == BOOT_TLV_INDEX_CNT) {
+        i = tlv_index_next;
+        tlv_index_next = (tlv_index_next + 1) % BOOT_TLV_INDEX_CNT;
+    }
+
+    idx = &tlv_index[i];
+    rc = bootutil_tlv_index_build(idx, hdr, fap);
+    if (rc == 0) {
+        *idxp = idx;
+    }
+
+    return rc;
+}
+
+/*
+ * Drops the TLV index of a slot. Must be called before the slot is written.
+ *
+ * @param fap flash_area of the slot
+ */
+void
+bootutil_tlv_index_invalidate(const struct flash_area *fap)
+{
+    uint8_t fa_id;
+    int i;
+
+    fa_id = flash_area_get_id(fap);
+    for (i = 0; i < BOOT_TLV_INDEX_CNT; i++) {
+        if (tlv_index[i].fa_id == fa_id) {
+            tlv_index[i].valid = false;
+        }
+    }
+}
+
+/*
+ * Drops the TLV index of every slot.
+ */
+void
+bootutil_tlv_index_reset(void)
+{
+    memset(tlv_index, 0, sizeof(tlv_index));
+    tlv_index_next = 0;
+}
+
+#else
+
+void
+bootutil_tlv_index_invalidate(const struct flash_area *fap)
+{
+    (void)fap;
+}
+
+void
+bootutil_tlv_index_reset(void)
+{
+}
+
+#endif /* MCUBOOT_TLV_INDEX */
+
+/*
+ * Initialize a TLV iterator.
+ *
+ * @param it An iterator struct
+ * @param hdr image_header of the slot's image
+ * @param fap flash_area of the slot which is storing the image
+ * @param type Type of TLV to look for
+ * @param prot true if TLV has to be stored in the protected area, false otherwise
+ *
+ * @returns 0 if the TLV iterator was successfully started
+ *          -1 on errors
+ */
+int
+bootutil_tlv_iter_begin(struct image_tlv_iter *it, const struct image_header *hdr,
+                        const struct flash_area *fap, uint16_t type, bool prot)
+{
+#ifdef MCUBOOT_TLV_INDEX
+    const struct image_tlv_index *idx;
+    int rc;
+
+    if (it == NULL || hdr == NULL || fap == NULL) {
+        return -1;
+    }
+
+    rc = bootutil_tlv_index_get(hdr, fap, &idx);
+    if (rc < 0) {
+        return -1;
+    } else if (rc == 0) {
+        it->hdr = hdr;
+        it->fap = fap;
+        it->type = type;
+        it->prot = prot;
+        it->prot_end = idx->prot_end;
+        it->tlv_end = idx->tlv_end;
+        it->tlv_off = idx->tlv_end;
+        it->tlv_data = NULL;
+        it->idx = idx;
+        it->idx_pos = 0;
+        return 0;
+    }
+
+    /* Too many TLVs to be indexed, walk the area. */
+#endif
+
+    return bootutil_tlv_walk_begin(it, hdr, fap, type, prot);
+}
+
 /*
  * Find next TLV
  *
@@ -102,14 +326,50 @@ bootutil_tlv_iter_next(struct image_tlv_iter *it, uint32_t *off, uint16_t *len,
         return -1;
     }
 
+#ifdef MCUBOOT_TLV_INDEX
+    if (it->idx != NULL) {
+        while (it->idx_pos < it->idx->cnt) {
+            /* No more TLVs in the protected area */
+            if (it->prot && it->idx_pos >= it->idx->prot_cnt) {
+                return 1;
+            }
+
+            if (it->type == IMAGE_TLV_ANY ||
+                it->idx->tlvs[it->idx_pos].type == it->type) {
+                if (type != NULL) {
+                    *type = it->idx->tlvs[it->idx_pos].type;
+                }
+                *off = it->idx->tlvs[it->idx_pos].off;
+                *len = it->idx->tlvs[it->idx_pos].len;
+                it->idx_pos++;
+                return 0;
+            }
+
+            it->idx_pos++;
+        }
+
+        return 1;
+    }
+#endif
+
     while (it->tlv_off < it->tlv_end) {
         if (it->hdr->ih_protect_tlv_size > 0 && it->tlv_off == it->prot_end) {
             it->tlv_off += sizeof(struct image_tlv_info);
         }
 
-        rc = LOAD_IMAGE_DATA(it->hdr, it->fap, it->tlv_off, &tlv, sizeof tlv);
-        if (rc) {
-            return -1;
+        if (it->tlv_data != NULL) {
+            /* Unlike flash_area_read(), nothing bounds reads in place past
+             * the TLV area. */
+            if (it->tlv_off + sizeof(tlv) > it->tlv_end) {
+                return -1;
+            }
+            memcpy(&tlv, it->tlv_data + (it->tlv_off - BOOT_TLV_OFF(it->hdr)),
+                   sizeof tlv);
+        } else {
+            rc = LOAD_IMAGE_DATA(it->hdr, it->fap, it->tlv_off, &tlv, sizeof tlv);
+            if (rc) {
+                return -1;
+            }
         }
 
         /* No more TLVs in the protected area */
@@ -132,3 +392,71 @@ bootutil_tlv_iter_next(struct image_tlv_iter *it, uint32_t *off, uint16_t *len,
 
     return 1;
 }
+
+/*
+ * Find the first TLV of a given type.
+ *
+ * @param hdr image_header of the slot's image
+ * @param fap flash_area of the slot which is storing the image
+ * @param type Type of TLV to look for
+ * @param prot true if TLV has to be stored in the protected area, false otherwise
+ * @param off The offset of the TLV's payload in flash
+ * @param len The length of the TLV's payload
+ *
+ * @returns 0 if a TLV with matching type was found
+ *          1 if there is no TLV with matching type
+ *          -1 on errors
+ */
+int
+bootutil_tlv_find(const struct image_header *hdr, const struct flash_area *fap,
+                  uint16_t type, bool prot, uint32_t *off, uint16_t *len)
+{
+    struct image_tlv_iter it;
+    int rc;
+
+    rc = bootutil_tlv_iter_begin(&it, hdr, fap, type, prot);
+    if (rc != 0) {
+        return -1;
+    }
+
+    return bootutil_tlv_iter_next(&it, off, len, NULL);
+}
+
+/*
+ * Read the payload of the first TLV of a given type.
+ *
+ * @param hdr image_header of the slot's image
+ * @param fap flash_area of the slot which is storing the image
+ * @param type Type of TLV to look for
+ * @param prot true if TLV has to be stored in the protected area, false otherwise
+ * @param buf Buffer to read the payload into
+ * @param len Size of `buf`; the length of the payload on return
+ *
+ * @returns 0 if a TLV with matching type was found and read
+ *          1 if there is no TLV with matching type
+ *          -1 on errors, including a payload that does not fit in `buf`
+ */
+int
+bootutil_tlv_read(const struct image_header *hdr, const struct flash_area *fap,
+                  uint16_t type, bool prot, void *buf, uint16_t *len)
+{
+    uint32_t off;
+    uint16_t tlv_len;
+    int rc;
+
+    rc = bootutil_tlv_find(hdr, fap, type, prot, &off, &tlv_len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (tlv_len > *len) {
+        return -1;
+    }
+
+    if (LOAD_IMAGE_DATA(hdr, fap, off, buf, tlv_len)) {
+        return -1;
+    }
+
+    *len = tlv_len;
+    return 0;
+}
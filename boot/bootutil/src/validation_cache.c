@@ -0,0 +1,255 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+
+#include "mcuboot_config/mcuboot_config.h"
+
+#ifdef MCUBOOT_VALIDATION_CACHE
+
+#include <flash_map_backend/flash_map_backend.h>
+
+#include "bootutil/bootutil_log.h"
+#include "bootutil/image.h"
+#include "bootutil/crypto/sha.h"
+#include "bootutil/crypto/hmac_sha256.h"
+#include "bootutil/security_cnt.h"
+#include "bootutil/validation_cache.h"
+#include "bootutil/fault_injection_hardening.h"
+#include "bootutil_priv.h"
+
+#if defined(MCUBOOT_DIRECT_XIP) || defined(MCUBOOT_RAM_LOAD)
+#error "MCUBOOT_VALIDATION_CACHE requires an upgrade strategy with a fixed primary slot"
+#endif
+
+BOOT_LOG_MODULE_DECLARE(mcuboot);
+
+/*
+ * Computes the MAC binding a cache entry to the image currently in the slot:
+ * the image header, the size of the image including its TLVs, its security
+ * counter and the value of its hash TLV, which the signature covers. Only a
+ * handful of bytes are read from the slot, independent of the image size.
+ *
+ * @return 0 on success; nonzero on failure.
+ */
+static int
+boot_validation_cache_mac(struct image_header *hdr,
+                          const struct flash_area *fap,
+                          const struct boot_validation_cache *entry,
+                          uint8_t *mac)
+{
+    bootutil_hmac_sha256_context hmac;
+    uint8_t hash[IMAGE_HASH_SIZE];
+    const uint8_t *key;
+    uint32_t key_len;
+    uint32_t area_off;
+    uint16_t len;
+    int rc;
+
+    len = sizeof(hash);
+    rc = bootutil_tlv_read(hdr, fap, EXPECTED_HASH_TLV, false, hash, &len);
+    if (rc != 0 || len != sizeof(hash)) {
+        return -1;
+    }
+
+    rc = boot_validation_cache_get_key(&key, &key_len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    area_off = flash_area_get_off(fap);
+
+    bootutil_hmac_sha256_init(&hmac);
+    rc = bootutil_hmac_sha256_set_key(&hmac, key, key_len);
+    if (rc != 0) {
+        goto out;
+    }
+
+    rc = bootutil_hmac_sha256_update(&hmac, &entry->magic, sizeof(entry->magic));
+    rc |= bootutil_hmac_sha256_update(&hmac, &area_off, sizeof(area_off));
+    rc |= bootutil_hmac_sha256_update(&hmac, hdr, sizeof(*hdr));
+    rc |= bootutil_hmac_sha256_update(&hmac, &entry->img_size,
+                                      sizeof(entry->img_size));
+    rc |= bootutil_hmac_sha256_update(&hmac, &entry->security_cnt,
+                                      sizeof(entry->security_cnt));
+    rc |= bootutil_hmac_sha256_update(&hmac, hash, sizeof(hash));
+    if (rc != 0) {
+        goto out;
+    }
+
+    rc = bootutil_hmac_sha256_finish(&hmac, mac, BOOT_VALIDATION_CACHE_MAC_SIZE);
+
+out:
+    bootutil_hmac_sha256_drop(&hmac);
+    return rc;
+}
+
+/*
+ * Fills in the size and security counter of the image in the slot.
+ *
+ * @return 0 on success; nonzero on failure.
+ */
+static int
+boot_validation_cache_describe(struct image_header *hdr,
+                               const struct flash_area *fap,
+                               struct boot_validation_cache *entry)
+{
+    struct image_tlv_iter it;
+    int rc;
+
+    rc = bootutil_tlv_iter_begin(&it, hdr, fap, IMAGE_TLV_ANY, false);
+    if (rc != 0) {
+        return rc;
+    }
+
+    entry->magic = BOOT_VALIDATION_CACHE_MAGIC;
+    entry->img_size = it.tlv_end;
+    entry->security_cnt = 0;
+    entry->pad = 0;
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    rc = bootutil_get_img_security_cnt(hdr, fap, &entry->security_cnt);
+    if (rc != 0) {
+        return rc;
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * Checks whether the image in the primary slot was validated on a previous
+ * boot and has not changed since.
+ *
+ * @param image_index   Index of the image.
+ * @param hdr           Header of the image in the primary slot.
+ * @param fap           Flash area of the primary slot.
+ *
+ * @return FIH_SUCCESS on a cache hit; FIH_FAILURE otherwise.
+ */
+fih_ret
+boot_validation_cache_check(int image_index, struct image_header *hdr,
+                            const struct flash_area *fap)
+{
+    struct boot_validation_cache stored;
+    struct boot_validation_cache entry;
+    uint8_t mac[BOOT_VALIDATION_CACHE_MAC_SIZE];
+    int rc;
+    FIH_DECLARE(fih_rc, FIH_FAILURE);
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    fih_int security_cnt = fih_int_encode(INT_MAX);
+#endif
+
+    rc = boot_validation_cache_load(image_index, &stored);
+    if (rc != 0 || stored.magic != BOOT_VALIDATION_CACHE_MAGIC) {
+        FIH_RET(fih_rc);
+    }
+
+    rc = boot_validation_cache_describe(hdr, fap, &entry);
+    if (rc != 0 || entry.img_size != stored.img_size ||
+        entry.img_size > bootutil_max_image_size(fap) ||
+        entry.security_cnt != stored.security_cnt) {
+        FIH_RET(fih_rc);
+    }
+
+#ifdef MCUBOOT_HW_ROLLBACK_PROT
+    /* The counter may have been raised by another image since. */
+    FIH_CALL(boot_nv_security_counter_get, fih_rc, image_index, &security_cnt);
+    if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
+        FIH_SET(fih_rc, FIH_FAILURE);
+        FIH_RET(fih_rc);
+    }
+
+    fih_rc = fih_ret_encode_zero_equality(entry.security_cnt <
+                                          (uint32_t)fih_int_decode(security_cnt));
+    if (FIH_NOT_EQ(fih_rc, FIH_SUCCESS)) {
+        FIH_SET(fih_rc, FIH_FAILURE);
+        FIH_RET(fih_rc);
+    }
+    FIH_SET(fih_rc, FIH_FAILURE);
+#endif
+
+    rc = boot_validation_cache_mac(hdr, fap, &entry, mac);
+    if (rc != 0) {
+        FIH_RET(fih_rc);
+    }
+
+    FIH_CALL(boot_fih_memequal, fih_rc, mac, stored.mac, sizeof(mac));
+    if (FIH_EQ(fih_rc, FIH_SUCCESS)) {
+        BOOT_LOG_DBG("Image %d: validation cache hit", image_index);
+    }
+
+    FIH_RET(fih_rc);
+}
+
+/**
+ * Records a successful validation of the image in the primary slot.
+ *
+ * @param image_index   Index of the image.
+ * @param hdr           Header of the image in the primary slot.
+ * @param fap           Flash area of the primary slot.
+ */
+void
+boot_validation_cache_update(int image_index, struct image_header *hdr,
+                             const struct flash_area *fap)
+{
+    struct boot_validation_cache entry;
+    int rc;
+
+    rc = boot_validation_cache_describe(hdr, fap, &entry);
+    if (rc == 0) {
+        rc = boot_validation_cache_mac(hdr, fap, &entry, entry.mac);
+    }
+    if (rc == 0) {
+        rc = boot_validation_cache_store(image_index, &entry);
+    }
+    if (rc != 0) {
+        BOOT_LOG_WRN("Image %d: failed to update the validation cache",
+                     image_index);
+    }
+}
+
+/**
+ * Drops the validation cache entry of an image, before its primary slot is
+ * written.
+ *
+ * @param image_index   Index of the image.
+ */
+void
+boot_validation_cache_invalidate(int image_index)
+{
+    struct boot_validation_cache entry;
+    struct boot_validation_cache empty;
+
+    if (boot_validation_cache_load(image_index, &entry) == 0 &&
+        entry.magic != BOOT_VALIDATION_CACHE_MAGIC) {
+        /* Nothing cached, spare the write. */
+        return;
+    }
+
+    memset(&empty, 0, sizeof(empty));
+    if (boot_validation_cache_store(image_index, &empty) != 0) {
+        BOOT_LOG_WRN("Image %d: failed to invalidate the validation cache",
+                     image_index);
+    }
+}
+
+#endif /* MCUBOOT_VALIDATION_CACHE */
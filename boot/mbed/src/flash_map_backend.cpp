@@ -16,6 +16,10 @@
  * limitations under the License
  */
 
+/* This file implements the flash_area_*() functions counted by
+ * MCUBOOT_FLASH_STATS. */
+#define BOOT_FLASH_STATS_NO_WRAP
+
 #include <assert.h>
 #include <cstring>
 #include "flash_map_backend/flash_map_backend.h"
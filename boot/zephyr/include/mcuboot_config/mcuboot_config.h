@@ -65,6 +65,22 @@
 #define MCUBOOT_OVERWRITE_ONLY_FAST
 #endif
 
+#ifdef CONFIG_BOOT_UPGRADE_ONLY_RESUME
+#define MCUBOOT_OVERWRITE_ONLY_RESUME
+#endif
+
+#ifdef CONFIG_BOOT_UPGRADE_ONLY_DIFF
+#define MCUBOOT_OVERWRITE_ONLY_DIFF
+#endif
+
+#ifdef CONFIG_BOOT_DELTA_UPGRADE
+#define MCUBOOT_DELTA_UPGRADE
+#endif
+
+#ifdef CONFIG_BOOT_DECOMPRESSION
+#define MCUBOOT_DECOMPRESS_IMAGES
+#endif
+
 #ifdef CONFIG_SINGLE_APPLICATION_SLOT
 #define MCUBOOT_SINGLE_APPLICATION_SLOT 1
 #define MCUBOOT_IMAGE_NUMBER    1
@@ -74,6 +90,10 @@
 #define MCUBOOT_SWAP_USING_MOVE 1
 #endif
 
+#ifdef CONFIG_BOOT_SWAP_USING_OFFSET
+#define MCUBOOT_SWAP_USING_OFFSET 1
+#endif
+
 #ifdef CONFIG_BOOT_DIRECT_XIP
 #define MCUBOOT_DIRECT_XIP
 #endif
@@ -135,6 +155,15 @@
 #define MCUBOOT_USE_BENCH 1
 #endif
 
+#ifdef CONFIG_BOOT_TIMELINE
+#define MCUBOOT_BOOT_TIMELINE
+#define MCUBOOT_BOOT_TIMELINE_SIZE CONFIG_BOOT_TIMELINE_SIZE
+#endif
+
+#ifdef CONFIG_BOOT_FLASH_STATS
+#define MCUBOOT_FLASH_STATS
+#endif
+
 #ifdef CONFIG_MCUBOOT_DOWNGRADE_PREVENTION
 #define MCUBOOT_DOWNGRADE_PREVENTION 1
 /* MCUBOOT_DOWNGRADE_PREVENTION_SECURITY_COUNTER is used later as bool value so it is
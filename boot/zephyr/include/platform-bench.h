@@ -27,6 +27,9 @@ BOOT_LOG_MODULE_DECLARE(mcuboot);
 
 typedef uint32_t bench_state_t;
 
+/* Timestamps of the boot timeline, see bootutil/bench.h. */
+#define plat_bench_cycles() k_cycle_get_32()
+
 #define plat_bench_start(_s) do { \
     BOOT_LOG_ERR("start benchmark"); \
     *(_s) = k_cycle_get_32(); \
@@ -47,6 +47,27 @@
 #endif
 
 #include "curve25519.h"
+
+// Number of odd multiples of the base point kept in flash for
+// ED25519_verify(): 8 (960 bytes), 16, 32 or 64 (7.5 KiB). A larger table
+// allows a wider sliding window for the base point scalar, so fewer point
+// additions per verify.
+#ifndef CURVE25519_BASE_TABLE_SIZE
+#define CURVE25519_BASE_TABLE_SIZE 8
+#endif
+
+#if CURVE25519_BASE_TABLE_SIZE == 8
+#define CURVE25519_BASE_SLIDE_SHIFT 6
+#elif CURVE25519_BASE_TABLE_SIZE == 16
+#define CURVE25519_BASE_SLIDE_SHIFT 7
+#elif CURVE25519_BASE_TABLE_SIZE == 32
+#define CURVE25519_BASE_SLIDE_SHIFT 8
+#elif CURVE25519_BASE_TABLE_SIZE == 64
+#define CURVE25519_BASE_SLIDE_SHIFT 9
+#else
+#error "CURVE25519_BASE_TABLE_SIZE must be 8, 16, 32 or 64"
+#endif
+
 // Various pre-computed constants.
 #include "curve25519_tables.h"
 
@@ -594,7 +615,10 @@ void x25519_ge_sub(ge_p1p1 *r, const ge_p3 *p, const ge_cached *q) {
   fe_add(&r->T, &trZ, &trT);
 }
 
-static void slide(signed char *r, const uint8_t *a) {
+// Recodes a into signed odd digits of magnitude up to max_digit, looking at
+// most max_shift bits ahead to merge a digit.
+static void slide(signed char *r, const uint8_t *a, int max_digit,
+                  int max_shift) {
   int i;
   int b;
   int k;
@@ -605,12 +629,12 @@ static void slide(signed char *r, const uint8_t *a) {
 
   for (i = 0; i < 256; ++i) {
     if (r[i]) {
-      for (b = 1; b <= 6 && i + b < 256; ++b) {
+      for (b = 1; b <= max_shift && i + b < 256; ++b) {
         if (r[i + b]) {
-          if (r[i] + (r[i + b] << b) <= 15) {
+          if (r[i] + (r[i + b] << b) <= max_digit) {
             r[i] += r[i + b] << b;
             r[i + b] = 0;
-          } else if (r[i] - (r[i + b] << b) >= -15) {
+          } else if (r[i] - (r[i + b] << b) >= -max_digit) {
             r[i] -= r[i + b] << b;
             for (k = i + b; k < 256; ++k) {
               if (!r[k]) {
@@ -632,6 +656,9 @@ static void slide(signed char *r, const uint8_t *a) {
 // where a = a[0]+256*a[1]+...+256^31 a[31].
 // and b = b[0]+256*b[1]+...+256^31 b[31].
 // B is the Ed25519 base point (x,4/5) with x positive.
+//
+// The digits of a are at most 15, for the eight multiples of A computed
+// here. The digits of b are at most 2 * CURVE25519_BASE_TABLE_SIZE - 1.
 static void ge_double_scalarmult_vartime(ge_p2 *r, const uint8_t *a,
                                          const ge_p3 *A, const uint8_t *b) {
   signed char aslide[256];
@@ -642,8 +669,9 @@ static void ge_double_scalarmult_vartime(ge_p2 *r, const uint8_t *a,
   ge_p3 A2;
   int i;
 
-  slide(aslide, a);
-  slide(bslide, b);
+  slide(aslide, a, 15, 6);
+  slide(bslide, b, 2 * CURVE25519_BASE_TABLE_SIZE - 1,
+        CURVE25519_BASE_SLIDE_SHIFT);
 
   x25519_ge_p3_to_cached(&Ai[0], A);
   ge_p3_dbl(&t, A);
@@ -0,0 +1,15 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ */
+
+/*
+ * Host build of curve25519.c for the tests: SHA-512 comes from
+ * tinycrypt-sha512, so MCUBOOT_USE_MBED_TLS is left undefined.
+ */
+
+#ifndef __MCUBOOT_CONFIG_H__
+#define __MCUBOOT_CONFIG_H__
+
+#endif /* __MCUBOOT_CONFIG_H__ */
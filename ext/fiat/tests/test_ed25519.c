@@ -0,0 +1,206 @@
+// test_ed25519.c - Host tests of ED25519_verify()
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2024 Alif Semiconductor
+//
+// The first three vectors are tests 1 to 3 of RFC 8032, section 7.1. The
+// last one signs a 1023 byte message, so that both scalars are full size.
+// Every signature must verify, and must be rejected once the message, R or
+// S is modified or S is not reduced. Build with each
+// CURVE25519_BASE_TABLE_SIZE (`make`) to cover every base point table.
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// Declared the same way by boot/bootutil/src/image_ed25519.c.
+extern int ED25519_verify(const uint8_t *message, size_t message_len,
+                          const uint8_t signature[64],
+                          const uint8_t public_key[32]);
+
+// Only used for the report, curve25519.c has the same default.
+#ifdef CURVE25519_BASE_TABLE_SIZE
+#define BASE_TABLE_SIZE CURVE25519_BASE_TABLE_SIZE
+#else
+#define BASE_TABLE_SIZE 8
+#endif
+
+static const uint8_t rfc8032_1_pk[32] = {
+    0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7,
+    0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+    0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25,
+    0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a,
+};
+
+static const uint8_t rfc8032_1_sig[64] = {
+    0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72,
+    0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+    0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74,
+    0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+    0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac,
+    0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+    0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24,
+    0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b,
+};
+
+static const uint8_t rfc8032_2_pk[32] = {
+    0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a,
+    0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+    0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+    0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c,
+};
+
+static const uint8_t rfc8032_2_sig[64] = {
+    0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8,
+    0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+    0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+    0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+    0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e,
+    0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+    0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee,
+    0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00,
+};
+
+static const uint8_t rfc8032_2_msg[1] = {
+    0x72,
+};
+
+static const uint8_t rfc8032_3_pk[32] = {
+    0xfc, 0x51, 0xcd, 0x8e, 0x62, 0x18, 0xa1, 0xa3,
+    0x8d, 0xa4, 0x7e, 0xd0, 0x02, 0x30, 0xf0, 0x58,
+    0x08, 0x16, 0xed, 0x13, 0xba, 0x33, 0x03, 0xac,
+    0x5d, 0xeb, 0x91, 0x15, 0x48, 0x90, 0x80, 0x25,
+};
+
+static const uint8_t rfc8032_3_sig[64] = {
+    0x62, 0x91, 0xd6, 0x57, 0xde, 0xec, 0x24, 0x02,
+    0x48, 0x27, 0xe6, 0x9c, 0x3a, 0xbe, 0x01, 0xa3,
+    0x0c, 0xe5, 0x48, 0xa2, 0x84, 0x74, 0x3a, 0x44,
+    0x5e, 0x36, 0x80, 0xd7, 0xdb, 0x5a, 0xc3, 0xac,
+    0x18, 0xff, 0x9b, 0x53, 0x8d, 0x16, 0xf2, 0x90,
+    0xae, 0x67, 0xf7, 0x60, 0x98, 0x4d, 0xc6, 0x59,
+    0x4a, 0x7c, 0x15, 0xe9, 0x71, 0x6e, 0xd2, 0x8d,
+    0xc0, 0x27, 0xbe, 0xce, 0xea, 0x1e, 0xc4, 0x0a,
+};
+
+static const uint8_t rfc8032_3_msg[2] = {
+    0xaf, 0x82,
+};
+
+static const uint8_t long_pk[32] = {
+    0x0c, 0x02, 0x7f, 0xd6, 0x4d, 0x5c, 0xaf, 0xa8,
+    0xf3, 0xc9, 0x91, 0x71, 0x4c, 0x72, 0x9f, 0x62,
+    0x89, 0x12, 0xe2, 0x0c, 0x61, 0xb5, 0x34, 0x33,
+    0x43, 0xe2, 0x0c, 0x4b, 0x91, 0xc7, 0x18, 0xcb,
+};
+
+static const uint8_t long_sig[64] = {
+    0x6d, 0x4f, 0xbc, 0xf2, 0x68, 0x19, 0x00, 0x55,
+    0x72, 0xc9, 0x04, 0xa8, 0x08, 0x0d, 0xf4, 0x04,
+    0xda, 0xf3, 0xb8, 0xf7, 0xbf, 0x22, 0x3c, 0xec,
+    0x53, 0xbe, 0x24, 0x3d, 0xf9, 0x75, 0x2d, 0xf9,
+    0xff, 0x76, 0x40, 0x6c, 0x4e, 0xbb, 0x39, 0xc1,
+    0x76, 0xa6, 0x34, 0xc9, 0x0d, 0x41, 0xde, 0x90,
+    0xe2, 0x77, 0x19, 0xcc, 0x5b, 0xcf, 0xfd, 0xca,
+    0x92, 0x48, 0x85, 0x82, 0x78, 0x21, 0xf4, 0x00,
+};
+
+static uint8_t long_msg[1023];
+
+struct vector {
+  const char *name;
+  const uint8_t *pk;
+  const uint8_t *sig;
+  const uint8_t *msg;
+  size_t msg_len;
+};
+
+static const struct vector vectors[] = {
+  { "rfc8032 1", rfc8032_1_pk, rfc8032_1_sig, NULL, 0 },
+  { "rfc8032 2", rfc8032_2_pk, rfc8032_2_sig, rfc8032_2_msg,
+    sizeof(rfc8032_2_msg) },
+  { "rfc8032 3", rfc8032_3_pk, rfc8032_3_sig, rfc8032_3_msg,
+    sizeof(rfc8032_3_msg) },
+  { "long", long_pk, long_sig, long_msg, sizeof(long_msg) },
+};
+
+// Order of the base point, little-endian.
+static const uint8_t kOrder[32] = {
+  0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+  0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+};
+
+static int check(const struct vector *v) {
+  uint8_t msg[sizeof(long_msg)];
+  uint8_t sig[64];
+  unsigned carry;
+  int i;
+
+  if (v->msg_len) {
+    memcpy(msg, v->msg, v->msg_len);
+  }
+  memcpy(sig, v->sig, sizeof(sig));
+
+  if (!ED25519_verify(msg, v->msg_len, sig, v->pk)) {
+    printf("%s: valid signature rejected\n", v->name);
+    return 1;
+  }
+
+  if (v->msg_len) {
+    msg[v->msg_len - 1] ^= 0x01;
+    if (ED25519_verify(msg, v->msg_len, sig, v->pk)) {
+      printf("%s: modified message accepted\n", v->name);
+      return 1;
+    }
+    msg[v->msg_len - 1] ^= 0x01;
+  }
+
+  sig[0] ^= 0x01;
+  if (ED25519_verify(msg, v->msg_len, sig, v->pk)) {
+    printf("%s: modified R accepted\n", v->name);
+    return 1;
+  }
+  sig[0] ^= 0x01;
+
+  sig[32] ^= 0x01;
+  if (ED25519_verify(msg, v->msg_len, sig, v->pk)) {
+    printf("%s: modified S accepted\n", v->name);
+    return 1;
+  }
+  sig[32] ^= 0x01;
+
+  // S + order is the same point multiple but must be rejected.
+  carry = 0;
+  for (i = 0; i < 32; i++) {
+    carry += sig[32 + i] + kOrder[i];
+    sig[32 + i] = (uint8_t)carry;
+    carry >>= 8;
+  }
+  if (ED25519_verify(msg, v->msg_len, sig, v->pk)) {
+    printf("%s: unreduced S accepted\n", v->name);
+    return 1;
+  }
+
+  return 0;
+}
+
+int main(void) {
+  size_t i;
+  int failed = 0;
+
+  for (i = 0; i < sizeof(long_msg); i++) {
+    long_msg[i] = (uint8_t)(i * 31 + 7);
+  }
+
+  for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    failed += check(&vectors[i]);
+  }
+
+  printf("ed25519, base table %d: %s\n", BASE_TABLE_SIZE,
+         failed ? "FAIL" : "PASS");
+  return failed ? 1 : 0;
+}
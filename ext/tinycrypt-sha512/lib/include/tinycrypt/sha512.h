@@ -67,6 +67,7 @@ extern "C" {
 #define TC_SHA512_BLOCK_SIZE (128)
 #define TC_SHA512_DIGEST_SIZE (64)
 #define TC_SHA512_STATE_BLOCKS (TC_SHA512_DIGEST_SIZE/8)
+#define TC_SHA384_DIGEST_SIZE (48)
 
 struct tc_sha512_state_struct {
 	uint64_t iv[TC_SHA512_STATE_BLOCKS];
@@ -122,6 +123,31 @@ int tc_sha512_update (TCSha512State_t s, const uint8_t *data, size_t datalen);
  */
 int tc_sha512_final(uint8_t *digest, TCSha512State_t s);
 
+/**
+ *  @brief SHA384 initialization procedure
+ *  Initializes s for SHA-384, which is SHA-512 with a different initial
+ *  state and a truncated digest. Hash the message with tc_sha512_update
+ *  and output the digest with tc_sha384_final.
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if s == NULL
+ *  @param s Sha512 state struct
+ */
+int tc_sha384_init(TCSha512State_t s);
+
+/**
+ *  @brief SHA384 final procedure
+ *  Inserts the completed hash computation into digest
+ *  @return returns TC_CRYPTO_SUCCESS (1)
+ *          returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL,
+ *                digest == NULL
+ *  @note Assumes: s has been initialized by tc_sha384_init
+ *        digest points to at least TC_SHA384_DIGEST_SIZE bytes
+ *  @param digest unsigned eight bit integer
+ *  @param Sha512 state struct
+ */
+int tc_sha384_final(uint8_t *digest, TCSha512State_t s);
+
 #ifdef __cplusplus
 }
 #endif
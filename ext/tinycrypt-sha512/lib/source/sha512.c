@@ -62,6 +62,31 @@ int tc_sha512_init(TCSha512State_t s)
 	return TC_CRYPTO_SUCCESS;
 }
 
+int tc_sha384_init(TCSha512State_t s)
+{
+	/* input sanity check: */
+	if (s == (TCSha512State_t) 0) {
+		return TC_CRYPTO_FAIL;
+	}
+
+	/*
+	 * Setting the initial state values.
+	 * These values correspond to the first 64 bits of the fractional parts
+	 * of the square roots of the 9th through 16th primes.
+	 */
+	_set((uint8_t *) s, 0x00, sizeof(*s));
+	s->iv[0] = 0xcbbb9d5dc1059ed8;
+	s->iv[1] = 0x629a292a367cd507;
+	s->iv[2] = 0x9159015a3070dd17;
+	s->iv[3] = 0x152fecd8f70e5939;
+	s->iv[4] = 0x67332667ffc00b31;
+	s->iv[5] = 0x8eb44a8768581511;
+	s->iv[6] = 0xdb0c2e0d64f98fa7;
+	s->iv[7] = 0x47b5481dbefa4fa4;
+
+	return TC_CRYPTO_SUCCESS;
+}
+
 int tc_sha512_update(TCSha512State_t s, const uint8_t *data, size_t datalen)
 {
 	/* input sanity check: */
@@ -71,6 +96,27 @@ int tc_sha512_update(TCSha512State_t s, const uint8_t *data, size_t datalen)
 		return TC_CRYPTO_SUCCESS;
 	}
 
+#if defined(TC_SHA512_UNROLLED)
+	/* complete a pending partial block first */
+	while (s->leftover_offset != 0 && datalen > 0) {
+		s->leftover[s->leftover_offset++] = *(data++);
+		datalen--;
+		if (s->leftover_offset >= TC_SHA512_BLOCK_SIZE) {
+			compress(s->iv, s->leftover);
+			s->leftover_offset = 0;
+			s->bits_hashed += (TC_SHA512_BLOCK_SIZE << 3);
+		}
+	}
+
+	/* hash whole blocks straight from the input */
+	while (datalen >= TC_SHA512_BLOCK_SIZE) {
+		compress(s->iv, data);
+		data += TC_SHA512_BLOCK_SIZE;
+		datalen -= TC_SHA512_BLOCK_SIZE;
+		s->bits_hashed += (TC_SHA512_BLOCK_SIZE << 3);
+	}
+#endif
+
 	while (datalen-- > 0) {
 		s->leftover[s->leftover_offset++] = *(data++);
 		if (s->leftover_offset >= TC_SHA512_BLOCK_SIZE) {
@@ -83,7 +129,12 @@ int tc_sha512_update(TCSha512State_t s, const uint8_t *data, size_t datalen)
 	return TC_CRYPTO_SUCCESS;
 }
 
-int tc_sha512_final(uint8_t *digest, TCSha512State_t s)
+/*
+ * Pads the message, hashes the last block(s) and outputs the first
+ * `words` 64-bit words of the state as the digest.
+ */
+static int sha512_final(uint8_t *digest, TCSha512State_t s,
+			unsigned int words)
 {
 	unsigned int i;
 
@@ -125,7 +176,7 @@ int tc_sha512_final(uint8_t *digest, TCSha512State_t s)
 	compress(s->iv, s->leftover);
 
 	/* copy the iv out to digest */
-	for (i = 0; i < TC_SHA512_STATE_BLOCKS; ++i) {
+	for (i = 0; i < words; ++i) {
 		uint64_t t = *((uint64_t *) &s->iv[i]);
 		*digest++ = (uint8_t)(t >> 56);
 		*digest++ = (uint8_t)(t >> 48);
@@ -143,6 +194,16 @@ int tc_sha512_final(uint8_t *digest, TCSha512State_t s)
 	return TC_CRYPTO_SUCCESS;
 }
 
+int tc_sha512_final(uint8_t *digest, TCSha512State_t s)
+{
+	return sha512_final(digest, s, TC_SHA512_STATE_BLOCKS);
+}
+
+int tc_sha384_final(uint8_t *digest, TCSha512State_t s)
+{
+	return sha512_final(digest, s, TC_SHA384_DIGEST_SIZE / 8);
+}
+
 /*
  * Initializing SHA-512 Hash constant words K.
  * These values correspond to the first 64 bits of the fractional parts of the
@@ -195,6 +256,87 @@ static inline uint64_t BigEndian(const uint8_t **c)
 	return n;
 }
 
+#if defined(TC_SHA512_UNROLLED)
+
+/*
+ * Loads a big-endian word. On little-endian GCC/Clang targets this is a
+ * single (possibly unaligned) load and a byte swap instead of eight byte
+ * loads and shifts.
+ */
+static inline uint64_t load_be64(const uint8_t *p)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	uint64_t n;
+
+	__builtin_memcpy(&n, p, sizeof(n));
+	return __builtin_bswap64(n);
+#else
+	return BigEndian(&p);
+#endif
+}
+
+/*
+ * One round, with the working variables renamed instead of shifted: the
+ * caller rotates the arguments, so only d and h are written. On 32-bit
+ * cores this halves the number of 64-bit moves per round, each of which is
+ * a pair of register moves or a pair of spills.
+ */
+#define ROUND(a, b, c, d, e, f, g, h, w, k) \
+	do { \
+		uint64_t t1_ = (h) + Sigma1(e) + Ch(e, f, g) + (k) + (w); \
+		(d) += t1_; \
+		(h) = t1_ + Sigma0(a) + Maj(a, b, c); \
+	} while (0)
+
+/* Next message schedule word, computed in place in the 16-word window. */
+#define SCHEDULE(w, i) \
+	((w)[(i) & 0xf] += sigma1((w)[((i) + 14) & 0xf]) + \
+			   (w)[((i) + 9) & 0xf] + \
+			   sigma0((w)[((i) + 1) & 0xf]))
+
+#define ROUNDS8(w, i, W) \
+	do { \
+		ROUND(a, b, c, d, e, f, g, h, W(w, (i) + 0), k512[(i) + 0]); \
+		ROUND(h, a, b, c, d, e, f, g, W(w, (i) + 1), k512[(i) + 1]); \
+		ROUND(g, h, a, b, c, d, e, f, W(w, (i) + 2), k512[(i) + 2]); \
+		ROUND(f, g, h, a, b, c, d, e, W(w, (i) + 3), k512[(i) + 3]); \
+		ROUND(e, f, g, h, a, b, c, d, W(w, (i) + 4), k512[(i) + 4]); \
+		ROUND(d, e, f, g, h, a, b, c, W(w, (i) + 5), k512[(i) + 5]); \
+		ROUND(c, d, e, f, g, h, a, b, W(w, (i) + 6), k512[(i) + 6]); \
+		ROUND(b, c, d, e, f, g, h, a, W(w, (i) + 7), k512[(i) + 7]); \
+	} while (0)
+
+#define W_LOAD(w, i) ((w)[(i)])
+#define W_NEXT(w, i) SCHEDULE(w, i)
+
+static void compress(uint64_t *iv, const uint8_t *data)
+{
+	uint64_t a, b, c, d, e, f, g, h;
+	uint64_t work_space[16];
+	unsigned int i;
+
+	for (i = 0; i < 16; ++i) {
+		work_space[i] = load_be64(data + 8 * i);
+	}
+
+	a = iv[0]; b = iv[1]; c = iv[2]; d = iv[3];
+	e = iv[4]; f = iv[5]; g = iv[6]; h = iv[7];
+
+	for (i = 0; i < 16; i += 8) {
+		ROUNDS8(work_space, i, W_LOAD);
+	}
+
+	for ( ; i < 80; i += 8) {
+		ROUNDS8(work_space, i, W_NEXT);
+	}
+
+	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
+	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
+}
+
+#else
+
 static void compress(uint64_t *iv, const uint8_t *data)
 {
 	uint64_t a, b, c, d, e, f, g, h;
@@ -232,3 +374,5 @@ static void compress(uint64_t *iv, const uint8_t *data)
 	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
 	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
 }
+
+#endif /* TC_SHA512_UNROLLED */
@@ -189,6 +189,529 @@ static bitcount_t smax(bitcount_t a, bitcount_t b)
 	return (a > b ? a : b);
 }
 
+#if defined(TC_ECC_VERIFY_WINDOWED)
+
+/*
+ * Windowed joint scalar multiplication for uECC_verify().
+ *
+ * u1*G + u2*Q is computed from the width-w NAF of both scalars, which has
+ * on average one non-zero digit every w + 1 bits. The odd multiples of G
+ * (1G, 3G, ...) are constants in flash, so G can use a wide window. The odd
+ * multiples of Q are computed once per verify, converted to affine with a
+ * single inversion, and kept on the stack. Points are added with the same
+ * co-Z mixed addition as the plain Shamir's trick loop. Negative digits use
+ * -P = (x, p - y).
+ *
+ * TinyCrypt only supports secp256r1, the table below is for that curve.
+ */
+
+/* Width of the NAF of u1, 4 to 7. The table holds 2^(w - 2) points. */
+#ifndef TC_ECC_VERIFY_G_WINDOW
+#define TC_ECC_VERIFY_G_WINDOW 6
+#endif
+
+#if TC_ECC_VERIFY_G_WINDOW < 4 || TC_ECC_VERIFY_G_WINDOW > 7
+#error "TC_ECC_VERIFY_G_WINDOW must be between 4 and 7"
+#endif
+
+/* Width of the NAF of u2: Q, 3Q, 5Q and 7Q are computed at run time. */
+#define ECC_VERIFY_Q_WINDOW 4
+
+#define ECC_VERIFY_G_POINTS (1 << (TC_ECC_VERIFY_G_WINDOW - 2))
+#define ECC_VERIFY_Q_POINTS (1 << (ECC_VERIFY_Q_WINDOW - 2))
+
+/* Length of the NAF of a scalar below n, one digit per bit plus a carry. */
+#define ECC_VERIFY_NAF_LEN (NUM_ECC_WORDS * uECC_WORD_SIZE * 8 + 1)
+
+/* Odd multiples of the secp256r1 generator, affine, x then y. */
+static const uECC_word_t g_odd_multiples[ECC_VERIFY_G_POINTS][NUM_ECC_WORDS * 2] = {
+	{ /* 1G */
+		BYTES_TO_WORDS_8(96, C2, 98, D8, 45, 39, A1, F4),
+		BYTES_TO_WORDS_8(A0, 33, EB, 2D, 81, 7D, 03, 77),
+		BYTES_TO_WORDS_8(F2, 40, A4, 63, E5, E6, BC, F8),
+		BYTES_TO_WORDS_8(47, 42, 2C, E1, F2, D1, 17, 6B),
+		BYTES_TO_WORDS_8(F5, 51, BF, 37, 68, 40, B6, CB),
+		BYTES_TO_WORDS_8(CE, 5E, 31, 6B, 57, 33, CE, 2B),
+		BYTES_TO_WORDS_8(16, 9E, 0F, 7C, 4A, EB, E7, 8E),
+		BYTES_TO_WORDS_8(9B, 7F, 1A, FE, E2, 42, E3, 4F)
+	},
+	{ /* 3G */
+		BYTES_TO_WORDS_8(6C, FD, E7, C6, 1B, 66, 41, FB),
+		BYTES_TO_WORDS_8(85, A9, AD, EF, 21, B7, C6, E6),
+		BYTES_TO_WORDS_8(65, F1, 4B, 1D, 95, EF, F7, C8),
+		BYTES_TO_WORDS_8(44, 0A, 33, A6, D1, E4, CB, 5E),
+		BYTES_TO_WORDS_8(32, 50, 7D, A2, 27, B1, 79, 9A),
+		BYTES_TO_WORDS_8(3D, B8, 4F, 38, 36, B0, 2A, D8),
+		BYTES_TO_WORDS_8(EC, A2, 64, 1A, CE, 06, 4B, 37),
+		BYTES_TO_WORDS_8(7E, FF, 98, 49, 0C, 64, 34, 87)
+	},
+	{ /* 5G */
+		BYTES_TO_WORDS_8(ED, 33, D0, C3, 0D, 4A, 55, 21),
+		BYTES_TO_WORDS_8(24, E5, 5B, 1F, FD, 82, 8C, EF),
+		BYTES_TO_WORDS_8(DF, 8F, 66, 08, 56, C8, 84, D7),
+		BYTES_TO_WORDS_8(D2, 40, 51, 51, 7A, 0B, 59, 51),
+		BYTES_TO_WORDS_8(A4, 6D, A1, FD, 44, BB, D0, D1),
+		BYTES_TO_WORDS_8(88, 08, D8, D4, 00, 2F, 01, 0D),
+		BYTES_TO_WORDS_8(26, 79, 8A, BF, 36, BF, E1, 8A),
+		BYTES_TO_WORDS_8(7D, 72, 4A, 90, A8, 7D, C1, E0)
+	},
+	{ /* 7G */
+		BYTES_TO_WORDS_8(A3, B2, 87, 31, 70, 28, 06, 30),
+		BYTES_TO_WORDS_8(5B, EF, 0F, A8, B8, F8, F9, 7E),
+		BYTES_TO_WORDS_8(60, FB, 01, 7C, 66, 30, BB, 25),
+		BYTES_TO_WORDS_8(46, 7B, BF, A0, 6F, 3B, 53, 8E),
+		BYTES_TO_WORDS_8(B4, 00, F4, C1, 86, 1A, 5E, C5),
+		BYTES_TO_WORDS_8(21, 1B, 04, CB, 33, 36, C7, 53),
+		BYTES_TO_WORDS_8(00, 90, F5, A6, 83, 9F, 06, 6D),
+		BYTES_TO_WORDS_8(36, 18, 33, E0, BD, 1D, EB, 73)
+	},
+#if TC_ECC_VERIFY_G_WINDOW > 4
+	{ /* 9G */
+		BYTES_TO_WORDS_8(E0, 9E, 94, 90, 4B, 8A, 9E, D7),
+		BYTES_TO_WORDS_8(B3, F8, 6D, 2C, 8C, CB, 0A, 9E),
+		BYTES_TO_WORDS_8(72, F8, 71, 1D, D5, 38, 89, 87),
+		BYTES_TO_WORDS_8(71, 0B, DF, FE, B6, D7, 68, EA),
+		BYTES_TO_WORDS_8(FA, 48, D0, 4D, 4A, 22, 5A, E8),
+		BYTES_TO_WORDS_8(3F, 82, DE, A4, EA, 4F, 71, 4D),
+		BYTES_TO_WORDS_8(C8, A0, 8E, 4A, 96, 4A, 01, 87),
+		BYTES_TO_WORDS_8(E7, FC, C9, 72, C9, 44, 27, 2A)
+	},
+	{ /* 11G */
+		BYTES_TO_WORDS_8(D1, 21, BC, 74, D3, 91, 33, 43),
+		BYTES_TO_WORDS_8(BF, 48, 50, 25, D0, 2E, 74, 16),
+		BYTES_TO_WORDS_8(DA, 1C, C2, B0, 9D, 37, 38, 06),
+		BYTES_TO_WORDS_8(59, 4C, 3B, 88, B7, 13, D1, 3E),
+		BYTES_TO_WORDS_8(40, 37, 2A, E8, FC, EE, F8, E2),
+		BYTES_TO_WORDS_8(DA, 89, 98, 5E, DA, 04, 0D, 09),
+		BYTES_TO_WORDS_8(8A, C6, F4, A4, AF, 43, C8, 24),
+		BYTES_TO_WORDS_8(A2, C8, C4, CC, 9A, 20, 99, 90)
+	},
+	{ /* 13G */
+		BYTES_TO_WORDS_8(01, 2C, 07, 46, 9D, 5D, E1, 98),
+		BYTES_TO_WORDS_8(8A, D5, EA, 65, 4B, 28, 2E, 79),
+		BYTES_TO_WORDS_8(FC, E2, 5E, D8, F2, 5D, 80, 61),
+		BYTES_TO_WORDS_8(5A, 49, AC, E0, 7A, 83, 7C, 17),
+		BYTES_TO_WORDS_8(D8, BF, C7, EF, E2, BB, 43, 9C),
+		BYTES_TO_WORDS_8(F3, 4D, FB, A1, C3, 14, EE, 26),
+		BYTES_TO_WORDS_8(72, 4E, 0F, B4, AD, 91, 40, A2),
+		BYTES_TO_WORDS_8(58, A5, BE, 4E, CD, 58, BB, 63)
+	},
+	{ /* 15G */
+		BYTES_TO_WORDS_8(5F, 9D, 9B, E5, 63, 8C, 66, 63),
+		BYTES_TO_WORDS_8(F1, 0E, 3A, DE, 92, AF, 03, AE),
+		BYTES_TO_WORDS_8(65, 82, 88, 99, 89, 37, FB, AD),
+		BYTES_TO_WORDS_8(E7, BA, 1A, 97, C6, 4D, 45, F0),
+		BYTES_TO_WORDS_8(36, 4F, 03, 0D, DE, 9C, E5, 47),
+		BYTES_TO_WORDS_8(3F, FA, B5, 75, CE, 21, 3B, 2A),
+		BYTES_TO_WORDS_8(E6, 43, 96, 1F, E5, 94, 65, 4E),
+		BYTES_TO_WORDS_8(1F, 2D, 2E, 59, E3, 3E, B9, B5)
+	},
+#if TC_ECC_VERIFY_G_WINDOW > 5
+	{ /* 17G */
+		BYTES_TO_WORDS_8(3E, A7, 38, 47, E3, BC, 1A, BA),
+		BYTES_TO_WORDS_8(F8, 4A, D6, F0, 78, 86, A6, 5F),
+		BYTES_TO_WORDS_8(1A, 30, 75, 6F, B6, 84, 09, 9C),
+		BYTES_TO_WORDS_8(3A, CC, F1, C0, 04, 69, 77, 47),
+		BYTES_TO_WORDS_8(DC, FC, F1, 71, FF, 87, F7, 32),
+		BYTES_TO_WORDS_8(3F, 73, D5, 28, 44, 80, B2, 81),
+		BYTES_TO_WORDS_8(83, 8E, 64, 77, 65, 85, 31, 62),
+		BYTES_TO_WORDS_8(28, 57, B9, B5, E6, 5E, 00, AA)
+	},
+	{ /* 19G */
+		BYTES_TO_WORDS_8(83, ED, 03, AB, 74, 7B, FC, C1),
+		BYTES_TO_WORDS_8(95, 48, 88, 57, 22, 45, 2C, 78),
+		BYTES_TO_WORDS_8(07, C5, 08, 71, C1, B7, 39, CE),
+		BYTES_TO_WORDS_8(25, 0C, 2C, 10, 61, 28, 6D, CB),
+		BYTES_TO_WORDS_8(AA, CD, CE, 2B, 75, 50, 91, E3),
+		BYTES_TO_WORDS_8(03, 3E, FA, 30, 6E, 71, 96, A4),
+		BYTES_TO_WORDS_8(E4, 6C, 6D, 0D, 10, E7, 35, 5C),
+		BYTES_TO_WORDS_8(51, EF, D9, 24, 4B, 61, D7, 58)
+	},
+	{ /* 21G */
+		BYTES_TO_WORDS_8(83, 9E, 39, 67, 4E, 36, 76, FD),
+		BYTES_TO_WORDS_8(23, 15, 2B, F4, 39, 21, 58, 3A),
+		BYTES_TO_WORDS_8(A5, BC, 73, B4, 6E, C8, 4A, 2E),
+		BYTES_TO_WORDS_8(7B, 7C, 63, 86, F6, FC, 50, 32),
+		BYTES_TO_WORDS_8(09, 8C, D4, 71, A0, 24, DE, 15),
+		BYTES_TO_WORDS_8(82, 6A, 56, 3B, C3, D3, 7C, 89),
+		BYTES_TO_WORDS_8(8C, B8, 7E, 1D, 0D, 09, B3, 97),
+		BYTES_TO_WORDS_8(93, 35, 7D, 66, 42, C3, E7, 42)
+	},
+	{ /* 23G */
+		BYTES_TO_WORDS_8(96, 78, CA, 45, 30, 57, 2E, 67),
+		BYTES_TO_WORDS_8(FE, A4, 64, DF, A5, C0, 0B, 3C),
+		BYTES_TO_WORDS_8(A6, 3F, 58, D4, 39, 3E, 8A, D2),
+		BYTES_TO_WORDS_8(D7, 40, 26, 9C, 23, C7, 91, 0E),
+		BYTES_TO_WORDS_8(55, AD, 40, 31, 54, 46, 80, 13),
+		BYTES_TO_WORDS_8(AE, A5, E7, 75, 35, 83, 68, 7E),
+		BYTES_TO_WORDS_8(6D, BD, E0, B8, 3B, 73, 22, 1A),
+		BYTES_TO_WORDS_8(22, BA, 0D, 55, 3B, 5C, F6, 5D)
+	},
+	{ /* 25G */
+		BYTES_TO_WORDS_8(87, D6, 00, F2, 45, DC, A4, 84),
+		BYTES_TO_WORDS_8(24, 1B, 6F, B7, C5, 2F, 65, 41),
+		BYTES_TO_WORDS_8(84, FA, 07, 8C, 2D, F5, F4, 85),
+		BYTES_TO_WORDS_8(B6, 0B, 0C, 4B, 55, E2, 67, 3A),
+		BYTES_TO_WORDS_8(24, 93, F7, 02, B3, 16, ED, A9),
+		BYTES_TO_WORDS_8(8A, 61, A7, 35, F7, 8A, 18, 8C),
+		BYTES_TO_WORDS_8(0D, FB, 3A, 16, 67, F2, DA, 26),
+		BYTES_TO_WORDS_8(43, CF, 1F, 2F, 87, F1, D0, 27)
+	},
+	{ /* 27G */
+		BYTES_TO_WORDS_8(D1, 83, 08, 3B, 17, 01, E2, F2),
+		BYTES_TO_WORDS_8(AB, 54, 3E, 68, BD, 55, 63, 57),
+		BYTES_TO_WORDS_8(78, F3, 11, 46, AC, 2F, BA, DE),
+		BYTES_TO_WORDS_8(51, 0D, D8, 19, 58, FA, 4F, 18),
+		BYTES_TO_WORDS_8(6F, 6E, 90, 60, C2, 42, D2, 20),
+		BYTES_TO_WORDS_8(16, 49, F0, 63, CC, EC, BD, 45),
+		BYTES_TO_WORDS_8(95, 99, CB, 26, 08, D9, C6, A4),
+		BYTES_TO_WORDS_8(59, F3, 88, 66, 27, 6E, A6, C0)
+	},
+	{ /* 29G */
+		BYTES_TO_WORDS_8(EF, 4D, 78, 1C, 3D, 69, DD, DE),
+		BYTES_TO_WORDS_8(41, 8A, B5, 88, C6, D1, 8C, FD),
+		BYTES_TO_WORDS_8(8C, 3B, 85, 90, A0, 6D, C3, A7),
+		BYTES_TO_WORDS_8(07, 5B, 19, FA, DE, 3A, D3, D6),
+		BYTES_TO_WORDS_8(A6, BC, D1, 93, 45, 12, 0C, 55),
+		BYTES_TO_WORDS_8(ED, ED, 95, 4B, AB, 66, A1, 09),
+		BYTES_TO_WORDS_8(CB, 5D, 8A, 55, 5F, 24, 78, 3F),
+		BYTES_TO_WORDS_8(7E, 5D, 19, EE, 16, BA, AA, 84)
+	},
+	{ /* 31G */
+		BYTES_TO_WORDS_8(8B, 5B, B4, A1, A0, 9A, 3F, 3E),
+		BYTES_TO_WORDS_8(3E, 5B, A9, 52, 7D, DB, C9, FA),
+		BYTES_TO_WORDS_8(A0, 9A, AE, A7, 26, A0, 5D, A8),
+		BYTES_TO_WORDS_8(5D, E0, C7, 2D, 50, 9E, 1D, 30),
+		BYTES_TO_WORDS_8(67, E2, 7E, A1, AE, B6, 8D, D5),
+		BYTES_TO_WORDS_8(61, CA, 87, 68, E4, 9A, 8D, 29),
+		BYTES_TO_WORDS_8(72, 7D, 01, 6B, 02, 3C, D2, E0),
+		BYTES_TO_WORDS_8(23, 12, 06, B3, F6, B6, 51, 65)
+	},
+#if TC_ECC_VERIFY_G_WINDOW > 6
+	{ /* 33G */
+		BYTES_TO_WORDS_8(93, D7, 2C, CB, F3, 00, C1, 65),
+		BYTES_TO_WORDS_8(FD, 72, A8, 3A, 53, 0A, 3B, A0),
+		BYTES_TO_WORDS_8(4E, D3, D9, 89, 5B, A2, 9A, FA),
+		BYTES_TO_WORDS_8(56, 13, D8, FC, 99, D6, 07, 98),
+		BYTES_TO_WORDS_8(F4, 4A, 63, 79, 24, F9, 6B, 2F),
+		BYTES_TO_WORDS_8(53, 78, 58, 6C, B9, 30, E6, FF),
+		BYTES_TO_WORDS_8(2F, 1B, 09, 1D, 4D, 1A, A0, 86),
+		BYTES_TO_WORDS_8(F2, 1B, B1, CA, DC, 9C, A5, C2)
+	},
+	{ /* 35G */
+		BYTES_TO_WORDS_8(1A, 29, BB, 33, 90, 38, 2D, A1),
+		BYTES_TO_WORDS_8(00, 97, AF, 92, FE, E1, E8, 94),
+		BYTES_TO_WORDS_8(CA, 48, 6C, 32, D7, 3A, FA, 8F),
+		BYTES_TO_WORDS_8(16, 7D, D2, 9E, 58, 4A, 8D, D5),
+		BYTES_TO_WORDS_8(D5, B9, 86, F5, C6, C9, B0, A5),
+		BYTES_TO_WORDS_8(79, 49, 03, 3B, 16, 1C, 27, 67),
+		BYTES_TO_WORDS_8(F6, FE, C7, 2D, 63, 92, EA, 76),
+		BYTES_TO_WORDS_8(85, 6B, 72, 02, D1, 14, 55, D4)
+	},
+	{ /* 37G */
+		BYTES_TO_WORDS_8(48, 33, 2B, 50, 94, 28, A9, 73),
+		BYTES_TO_WORDS_8(44, FD, 6B, 24, 79, 13, D2, E0),
+		BYTES_TO_WORDS_8(AA, 26, A8, 11, 86, 97, B0, D6),
+		BYTES_TO_WORDS_8(7D, 81, DB, 6D, 64, 6A, 9A, 41),
+		BYTES_TO_WORDS_8(B2, 14, 92, B0, 81, 6C, 1D, DB),
+		BYTES_TO_WORDS_8(E2, E1, DE, F3, 72, D0, C6, 13),
+		BYTES_TO_WORDS_8(D5, 2F, 4C, 95, B1, 9F, 5C, 54),
+		BYTES_TO_WORDS_8(84, F5, 02, 11, CF, 44, 25, 33)
+	},
+	{ /* 39G */
+		BYTES_TO_WORDS_8(C4, 76, 27, FB, DD, 99, C1, A0),
+		BYTES_TO_WORDS_8(D4, 38, D1, D2, 2D, 94, 7B, 54),
+		BYTES_TO_WORDS_8(6E, 04, 79, A1, 76, 49, 01, 42),
+		BYTES_TO_WORDS_8(4D, 6D, 99, C3, F7, 82, A6, 22),
+		BYTES_TO_WORDS_8(5D, 28, AA, CB, 49, F6, 47, 53),
+		BYTES_TO_WORDS_8(68, B0, 65, 02, 31, CC, 9D, 97),
+		BYTES_TO_WORDS_8(6C, 35, 54, 5A, 83, C9, 18, B9),
+		BYTES_TO_WORDS_8(EE, 23, 22, 10, B0, 06, 46, 4F)
+	},
+	{ /* 41G */
+		BYTES_TO_WORDS_8(A2, 2F, 5D, 99, 94, E6, 7D, 3A),
+		BYTES_TO_WORDS_8(59, 5A, 17, D4, C3, C5, 67, 60),
+		BYTES_TO_WORDS_8(AA, E8, CF, E6, D2, 58, F2, 1C),
+		BYTES_TO_WORDS_8(65, E0, DE, 40, C2, BE, A6, 67),
+		BYTES_TO_WORDS_8(D5, EE, 1F, 44, E1, 4C, C2, 49),
+		BYTES_TO_WORDS_8(6C, CA, 9A, 20, EE, C7, 42, 15),
+		BYTES_TO_WORDS_8(99, 44, 4D, 46, 49, 9B, 24, 6C),
+		BYTES_TO_WORDS_8(58, 31, D1, 22, 70, 2B, 69, DE)
+	},
+	{ /* 43G */
+		BYTES_TO_WORDS_8(8D, D2, 82, 9B, 12, DC, 44, 75),
+		BYTES_TO_WORDS_8(0F, B3, 09, D0, C6, C4, 4B, 8F),
+		BYTES_TO_WORDS_8(49, 4B, 8F, 1D, 86, 30, 42, D0),
+		BYTES_TO_WORDS_8(04, F1, 1F, 6F, 50, E2, 6A, 98),
+		BYTES_TO_WORDS_8(97, 7E, B0, 1B, 44, 0C, 11, 25),
+		BYTES_TO_WORDS_8(25, 9F, 18, 9C, 28, C6, 6F, D8),
+		BYTES_TO_WORDS_8(61, 7B, 3C, 7D, D9, A4, 28, E3),
+		BYTES_TO_WORDS_8(0A, 0E, 46, A6, C0, CC, 3C, 00)
+	},
+	{ /* 45G */
+		BYTES_TO_WORDS_8(03, BA, E0, FA, 80, 80, C7, 79),
+		BYTES_TO_WORDS_8(D9, D6, 29, DD, 9E, 60, 5F, 0F),
+		BYTES_TO_WORDS_8(2E, 67, F0, DF, 5D, 0F, CD, 3E),
+		BYTES_TO_WORDS_8(9B, E9, BD, 70, 66, D0, 91, A8),
+		BYTES_TO_WORDS_8(AE, 34, 69, 16, C8, ED, C3, EF),
+		BYTES_TO_WORDS_8(CC, F2, B0, FE, F0, 38, 6B, 1C),
+		BYTES_TO_WORDS_8(E7, 1C, 3C, 03, C4, 88, 9A, 41),
+		BYTES_TO_WORDS_8(C1, A1, BF, 2C, 92, CD, 96, B5)
+	},
+	{ /* 47G */
+		BYTES_TO_WORDS_8(7C, 0D, 1C, 7B, 22, 89, D6, 51),
+		BYTES_TO_WORDS_8(6D, 06, 19, 3E, 58, 31, 5B, DD),
+		BYTES_TO_WORDS_8(BC, 1B, 07, 83, EA, 61, 53, 59),
+		BYTES_TO_WORDS_8(08, 87, 95, 48, CC, 15, C3, 42),
+		BYTES_TO_WORDS_8(B9, B1, F9, B2, 2B, A7, C4, D6),
+		BYTES_TO_WORDS_8(64, F1, 87, EB, E1, A1, F1, 74),
+		BYTES_TO_WORDS_8(90, 79, 7A, BB, DF, D1, 14, 29),
+		BYTES_TO_WORDS_8(85, 95, 1B, 57, CE, 61, 9A, 64)
+	},
+	{ /* 49G */
+		BYTES_TO_WORDS_8(55, 44, 67, A5, E6, 8C, 22, 7D),
+		BYTES_TO_WORDS_8(FD, D4, 8F, 75, A9, 7E, FB, 28),
+		BYTES_TO_WORDS_8(05, 6C, 6E, 86, 46, B1, 22, BB),
+		BYTES_TO_WORDS_8(75, 88, 06, 98, E0, B0, 85, F7),
+		BYTES_TO_WORDS_8(08, 24, D6, 10, 0C, 49, BC, E7),
+		BYTES_TO_WORDS_8(0A, A6, 3A, 5F, FD, B6, 04, 4B),
+		BYTES_TO_WORDS_8(41, 5B, 9F, 0D, 7F, 76, 5C, E1),
+		BYTES_TO_WORDS_8(6E, DA, 80, 60, BF, B0, FD, 73)
+	},
+	{ /* 51G */
+		BYTES_TO_WORDS_8(B1, 22, 8E, 01, F0, 60, 43, 04),
+		BYTES_TO_WORDS_8(FF, 08, 10, E8, 56, EB, F7, 95),
+		BYTES_TO_WORDS_8(BC, 68, 1D, 3C, 86, E6, DE, AA),
+		BYTES_TO_WORDS_8(3E, E4, 9D, 4D, 51, 4A, 2C, 67),
+		BYTES_TO_WORDS_8(04, 71, F3, 91, 91, 39, 35, 99),
+		BYTES_TO_WORDS_8(41, D9, 04, 97, 58, 46, 62, 13),
+		BYTES_TO_WORDS_8(F7, 03, E2, AC, A4, E5, 1D, 61),
+		BYTES_TO_WORDS_8(FE, 5B, A2, 96, 91, 7E, 8C, 54)
+	},
+	{ /* 53G */
+		BYTES_TO_WORDS_8(36, D0, 49, 74, 9F, EC, 26, F1),
+		BYTES_TO_WORDS_8(83, B9, E9, 8D, A7, 1C, 2B, 98),
+		BYTES_TO_WORDS_8(39, 80, B8, 54, 22, 80, 47, 5A),
+		BYTES_TO_WORDS_8(45, 52, D9, C9, 49, BD, 01, 6F),
+		BYTES_TO_WORDS_8(DB, 17, 9E, 98, DD, 33, 02, 36),
+		BYTES_TO_WORDS_8(08, 9B, 74, C3, BF, 51, 85, A7),
+		BYTES_TO_WORDS_8(CE, 76, 87, 60, 1A, F2, A0, 11),
+		BYTES_TO_WORDS_8(AB, DE, D5, F1, 0F, 08, 62, 15)
+	},
+	{ /* 55G */
+		BYTES_TO_WORDS_8(A0, 60, 6E, DF, F7, DF, C1, DE),
+		BYTES_TO_WORDS_8(DA, EA, C1, 62, B7, 95, A5, C2),
+		BYTES_TO_WORDS_8(2C, EA, 7F, FE, 09, A1, 71, 75),
+		BYTES_TO_WORDS_8(26, C9, 68, A0, 7B, BA, 9D, 07),
+		BYTES_TO_WORDS_8(EA, 4D, 82, B4, AE, A5, 0D, FB),
+		BYTES_TO_WORDS_8(97, A3, 51, 57, F3, 2D, EB, 83),
+		BYTES_TO_WORDS_8(AB, 88, 95, 2A, 9D, 3F, 22, 1D),
+		BYTES_TO_WORDS_8(81, D1, D4, 43, B7, 19, 1E, DC)
+	},
+	{ /* 57G */
+		BYTES_TO_WORDS_8(77, 60, F5, D0, B1, 97, BD, 8A),
+		BYTES_TO_WORDS_8(D8, 6B, 6C, 2D, 6E, 40, 9D, 28),
+		BYTES_TO_WORDS_8(86, 7F, 90, EA, A8, 45, 6D, 12),
+		BYTES_TO_WORDS_8(65, 28, 4D, BB, 0E, E3, 16, C1),
+		BYTES_TO_WORDS_8(06, C2, 10, A4, FD, D7, 3F, 31),
+		BYTES_TO_WORDS_8(C5, C8, 59, 9E, E8, D5, 5B, 7D),
+		BYTES_TO_WORDS_8(65, 87, 3B, B1, 9B, 6D, B1, B8),
+		BYTES_TO_WORDS_8(C2, 30, 5B, C3, 23, 88, 47, E9)
+	},
+	{ /* 59G */
+		BYTES_TO_WORDS_8(45, 4B, AA, 0F, 0E, EA, B6, A2),
+		BYTES_TO_WORDS_8(EC, C8, 8D, 9E, 11, 41, 09, E5),
+		BYTES_TO_WORDS_8(F7, BD, A9, FC, 84, 27, 5B, 76),
+		BYTES_TO_WORDS_8(37, 64, 0C, FE, 6F, 1A, 5F, 66),
+		BYTES_TO_WORDS_8(CF, 4C, 7F, 2B, 60, A6, 25, 6E),
+		BYTES_TO_WORDS_8(BC, 15, E2, 81, BF, E5, ED, 7D),
+		BYTES_TO_WORDS_8(7F, C3, EA, F7, 29, CA, 8C, 6E),
+		BYTES_TO_WORDS_8(C2, 18, FD, 9F, A4, 2C, 0E, 49)
+	},
+	{ /* 61G */
+		BYTES_TO_WORDS_8(0E, AF, 32, 0D, 38, AC, 39, 59),
+		BYTES_TO_WORDS_8(D5, 4F, 72, 8B, A0, 10, 79, 3E),
+		BYTES_TO_WORDS_8(01, 00, 99, 8D, 3D, 6B, 3A, 2D),
+		BYTES_TO_WORDS_8(9A, DA, D3, ED, 19, CB, 9C, 05),
+		BYTES_TO_WORDS_8(D1, 91, FE, 97, 3C, 1E, 8E, 92),
+		BYTES_TO_WORDS_8(CD, CE, 56, 39, A3, F7, 21, 16),
+		BYTES_TO_WORDS_8(8E, 63, 45, 93, 1B, 28, 65, DA),
+		BYTES_TO_WORDS_8(59, 91, D4, CA, EC, D7, 6A, BB)
+	},
+	{ /* 63G */
+		BYTES_TO_WORDS_8(C1, DA, 8B, 5D, 82, 90, A2, 32),
+		BYTES_TO_WORDS_8(38, CD, A7, 01, AF, C8, 53, DF),
+		BYTES_TO_WORDS_8(8F, 7D, CC, 8A, A0, 28, 1F, 2A),
+		BYTES_TO_WORDS_8(80, DC, F5, 5B, D8, 01, 95, 6A),
+		BYTES_TO_WORDS_8(A3, F1, 1E, 5F, 3D, F5, AF, 30),
+		BYTES_TO_WORDS_8(35, 6F, 7A, 69, 5C, 1B, 46, F8),
+		BYTES_TO_WORDS_8(A3, 56, 3C, 4A, E4, C6, C6, 81),
+		BYTES_TO_WORDS_8(43, 37, 47, 93, D1, 0A, 64, CA)
+	},
+#endif
+#endif
+#endif
+};
+
+/* Computes the width-w NAF of scalar, least significant digit first. */
+static bitcount_t compute_naf(int8_t *naf, const uECC_word_t *scalar,
+			      wordcount_t num_words, unsigned int w)
+{
+	/* One spare word for the carry of negative digits. */
+	uECC_word_t k[NUM_ECC_WORDS + 1];
+	uECC_word_t mask = ((uECC_word_t)1 << w) - 1;
+	bitcount_t len = 0;
+	wordcount_t i;
+
+	uECC_vli_set(k, scalar, num_words);
+	k[num_words] = 0;
+
+	while (!uECC_vli_isZero(k, num_words + 1)) {
+		int digit = 0;
+
+		if (k[0] & 1) {
+			digit = (int)(k[0] & mask);
+			if (digit >= (1 << (w - 1))) {
+				/* k += 2^w - digit, carrying into the upper words */
+				uECC_word_t add = (uECC_word_t)((1 << w) - digit);
+
+				digit -= (1 << w);
+				for (i = 0; i < num_words + 1 && add; ++i) {
+					k[i] += add;
+					add = (k[i] < add);
+				}
+			} else {
+				/* The low w bits of k are the digit, no borrow. */
+				k[0] -= (uECC_word_t)digit;
+			}
+		}
+		naf[len++] = (int8_t)digit;
+
+		/* k >>= 1 */
+		for (i = 0; i < num_words; ++i) {
+			k[i] = (k[i] >> 1) | (k[i + 1] << (uECC_WORD_SIZE * 8 - 1));
+		}
+		k[num_words] >>= 1;
+	}
+
+	return len;
+}
+
+/*
+ * Adds the affine point (point, negated if digit < 0) to (rx, ry, z). The
+ * first call only loads the point.
+ */
+static void add_naf_point(uECC_word_t *rx, uECC_word_t *ry, uECC_word_t *z,
+			  int *started, const uECC_word_t *point, int digit,
+			  uECC_Curve curve)
+{
+	uECC_word_t tx[NUM_ECC_WORDS];
+	uECC_word_t ty[NUM_ECC_WORDS];
+	uECC_word_t tz[NUM_ECC_WORDS];
+	wordcount_t num_words = curve->num_words;
+
+	uECC_vli_set(tx, point, num_words);
+	uECC_vli_set(ty, point + num_words, num_words);
+	if (digit < 0) {
+		uECC_vli_sub(ty, curve->p, ty, num_words); /* y = p - y */
+	}
+
+	if (!*started) {
+		uECC_vli_set(rx, tx, num_words);
+		uECC_vli_set(ry, ty, num_words);
+		uECC_vli_clear(z, num_words);
+		z[0] = 1;
+		*started = 1;
+		return;
+	}
+
+	apply_z(tx, ty, z, curve);
+	uECC_vli_modSub(tz, rx, tx, curve->p, num_words); /* Z = x2 - x1 */
+	XYcZ_add(tx, ty, rx, ry, curve);
+	uECC_vli_modMult_fast(z, z, tz, curve);
+}
+
+/* Computes the affine x coordinate of u1*G + u2*Q into rx. */
+static void joint_mult_windowed(uECC_word_t *rx, const uECC_word_t *u1,
+				const uECC_word_t *u2,
+				const uECC_word_t *_public,
+				wordcount_t num_n_words, uECC_Curve curve)
+{
+	uECC_word_t q_odd[ECC_VERIFY_Q_POINTS][NUM_ECC_WORDS * 2];
+	uECC_word_t t[ECC_VERIFY_Q_POINTS][NUM_ECC_WORDS];
+	uECC_word_t dx[NUM_ECC_WORDS];
+	uECC_word_t dy[NUM_ECC_WORDS];
+	uECC_word_t ry[NUM_ECC_WORDS];
+	uECC_word_t z[NUM_ECC_WORDS];
+	int8_t naf1[ECC_VERIFY_NAF_LEN];
+	int8_t naf2[ECC_VERIFY_NAF_LEN];
+	wordcount_t num_words = curve->num_words;
+	bitcount_t len1;
+	bitcount_t len2;
+	bitcount_t i;
+	int started = 0;
+	int k;
+
+	/*
+	 * D = 2Q, and Q brought to the same Z. Then (2k + 1)Q = D + (2k - 1)Q,
+	 * each addition multiplying Z by t[k] = x((2k - 1)Q) - x(D).
+	 */
+	uECC_vli_set(q_odd[0], _public, num_words * 2);
+	uECC_vli_set(dx, _public, num_words);
+	uECC_vli_set(dy, _public + num_words, num_words);
+	uECC_vli_clear(z, num_words);
+	z[0] = 1;
+	curve->double_jacobian(dx, dy, z, curve);
+	uECC_vli_set(q_odd[1], _public, num_words * 2);
+	apply_z(q_odd[1], q_odd[1] + num_words, z, curve);
+
+	for (k = 1; k < ECC_VERIFY_Q_POINTS; ++k) {
+		if (k > 1) {
+			uECC_vli_set(q_odd[k], q_odd[k - 1], num_words * 2);
+		}
+		uECC_vli_modSub(t[k], q_odd[k], dx, curve->p, num_words);
+		XYcZ_add(dx, dy, q_odd[k], q_odd[k] + num_words, curve);
+		uECC_vli_modMult_fast(z, z, t[k], curve);
+	}
+
+	/* z is the Z of the last point: walk the inverse back down. */
+	uECC_vli_modInv(z, z, curve->p, num_words);
+	for (k = ECC_VERIFY_Q_POINTS - 1; k > 0; --k) {
+		apply_z(q_odd[k], q_odd[k] + num_words, z, curve);
+		uECC_vli_modMult_fast(z, z, t[k], curve);
+	}
+
+	len1 = compute_naf(naf1, u1, num_n_words, TC_ECC_VERIFY_G_WINDOW);
+	len2 = compute_naf(naf2, u2, num_n_words, ECC_VERIFY_Q_WINDOW);
+	for (i = len1; i < len2; ++i) {
+		naf1[i] = 0;
+	}
+	for (i = len2; i < len1; ++i) {
+		naf2[i] = 0;
+	}
+
+	for (i = smax(len1, len2) - 1; i >= 0; --i) {
+		if (started) {
+			curve->double_jacobian(rx, ry, z, curve);
+		}
+		if (naf1[i]) {
+			add_naf_point(rx, ry, z, &started,
+				      g_odd_multiples[(naf1[i] < 0 ? -naf1[i] : naf1[i]) >> 1],
+				      naf1[i], curve);
+		}
+		if (naf2[i]) {
+			add_naf_point(rx, ry, z, &started,
+				      q_odd[(naf2[i] < 0 ? -naf2[i] : naf2[i]) >> 1],
+				      naf2[i], curve);
+		}
+	}
+
+	uECC_vli_modInv(z, z, curve->p, num_words); /* Z = 1/Z */
+	apply_z(rx, ry, z, curve);
+}
+
+#endif /* TC_ECC_VERIFY_WINDOWED */
+
 int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 		unsigned hash_size, const uint8_t *signature,
 	        uECC_Curve curve)
@@ -196,8 +719,9 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 
 	uECC_word_t u1[NUM_ECC_WORDS], u2[NUM_ECC_WORDS];
 	uECC_word_t z[NUM_ECC_WORDS];
-	uECC_word_t sum[NUM_ECC_WORDS * 2];
 	uECC_word_t rx[NUM_ECC_WORDS];
+#if !defined(TC_ECC_VERIFY_WINDOWED)
+	uECC_word_t sum[NUM_ECC_WORDS * 2];
 	uECC_word_t ry[NUM_ECC_WORDS];
 	uECC_word_t tx[NUM_ECC_WORDS];
 	uECC_word_t ty[NUM_ECC_WORDS];
@@ -206,6 +730,7 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 	const uECC_word_t *point;
 	bitcount_t num_bits;
 	bitcount_t i;
+#endif
 
 	uECC_word_t _public[NUM_ECC_WORDS * 2];
 	uECC_word_t r[NUM_ECC_WORDS], s[NUM_ECC_WORDS];
@@ -240,6 +765,9 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 	uECC_vli_modMult(u1, u1, z, curve->n, num_n_words); /* u1 = e/s */
 	uECC_vli_modMult(u2, r, z, curve->n, num_n_words); /* u2 = r/s */
 
+#if defined(TC_ECC_VERIFY_WINDOWED)
+	joint_mult_windowed(rx, u1, u2, _public, num_n_words, curve);
+#else
 	/* Calculate sum = G + Q. */
 	uECC_vli_set(sum, _public, num_words);
 	uECC_vli_set(sum + num_words, _public + num_words, num_words);
@@ -283,6 +811,7 @@ int uECC_verify(const uint8_t *public_key, const uint8_t *message_hash,
 
 	uECC_vli_modInv(z, z, curve->p, num_words); /* Z = 1/Z */
 	apply_z(rx, ry, z, curve);
+#endif
 
 	/* v = x1 (mod n) */
 	if (uECC_vli_cmp_unsafe(curve->n, rx, num_n_words) != 1) {
@@ -72,6 +72,27 @@ int tc_sha256_update(TCSha256State_t s, const uint8_t *data, size_t datalen)
 		return TC_CRYPTO_SUCCESS;
 	}
 
+#if defined(TC_SHA256_UNROLLED)
+	/* complete a pending partial block first */
+	while (s->leftover_offset != 0 && datalen > 0) {
+		s->leftover[s->leftover_offset++] = *(data++);
+		datalen--;
+		if (s->leftover_offset >= TC_SHA256_BLOCK_SIZE) {
+			compress(s->iv, s->leftover);
+			s->leftover_offset = 0;
+			s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+		}
+	}
+
+	/* hash whole blocks straight from the input */
+	while (datalen >= TC_SHA256_BLOCK_SIZE) {
+		compress(s->iv, data);
+		data += TC_SHA256_BLOCK_SIZE;
+		datalen -= TC_SHA256_BLOCK_SIZE;
+		s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	}
+#endif
+
 	while (datalen-- > 0) {
 		s->leftover[s->leftover_offset++] = *(data++);
 		if (s->leftover_offset >= TC_SHA256_BLOCK_SIZE) {
@@ -178,6 +199,84 @@ static inline unsigned int BigEndian(const uint8_t **c)
 	return n;
 }
 
+#if defined(TC_SHA256_UNROLLED)
+
+/*
+ * Loads a big-endian word. On little-endian GCC/Clang targets this is a
+ * single (possibly unaligned) load and a byte swap instead of four byte loads.
+ */
+static inline unsigned int load_be32(const uint8_t *p)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	uint32_t n;
+
+	__builtin_memcpy(&n, p, sizeof(n));
+	return __builtin_bswap32(n);
+#else
+	return BigEndian(&p);
+#endif
+}
+
+/*
+ * One round, with the working variables renamed instead of shifted: the
+ * caller rotates the arguments, so only d and h are written.
+ */
+#define ROUND(a, b, c, d, e, f, g, h, w, k) \
+	do { \
+		unsigned int t1_ = (h) + Sigma1(e) + Ch(e, f, g) + (k) + (w); \
+		(d) += t1_; \
+		(h) = t1_ + Sigma0(a) + Maj(a, b, c); \
+	} while (0)
+
+/* Next message schedule word, computed in place in the 16-word window. */
+#define SCHEDULE(w, i) \
+	((w)[(i) & 0xf] += sigma1((w)[((i) + 14) & 0xf]) + \
+			   (w)[((i) + 9) & 0xf] + \
+			   sigma0((w)[((i) + 1) & 0xf]))
+
+#define ROUNDS8(w, i, W) \
+	do { \
+		ROUND(a, b, c, d, e, f, g, h, W(w, (i) + 0), k256[(i) + 0]); \
+		ROUND(h, a, b, c, d, e, f, g, W(w, (i) + 1), k256[(i) + 1]); \
+		ROUND(g, h, a, b, c, d, e, f, W(w, (i) + 2), k256[(i) + 2]); \
+		ROUND(f, g, h, a, b, c, d, e, W(w, (i) + 3), k256[(i) + 3]); \
+		ROUND(e, f, g, h, a, b, c, d, W(w, (i) + 4), k256[(i) + 4]); \
+		ROUND(d, e, f, g, h, a, b, c, W(w, (i) + 5), k256[(i) + 5]); \
+		ROUND(c, d, e, f, g, h, a, b, W(w, (i) + 6), k256[(i) + 6]); \
+		ROUND(b, c, d, e, f, g, h, a, W(w, (i) + 7), k256[(i) + 7]); \
+	} while (0)
+
+#define W_LOAD(w, i) ((w)[(i)])
+#define W_NEXT(w, i) SCHEDULE(w, i)
+
+static void compress(unsigned int *iv, const uint8_t *data)
+{
+	unsigned int a, b, c, d, e, f, g, h;
+	unsigned int work_space[16];
+	unsigned int i;
+
+	for (i = 0; i < 16; ++i) {
+		work_space[i] = load_be32(data + 4 * i);
+	}
+
+	a = iv[0]; b = iv[1]; c = iv[2]; d = iv[3];
+	e = iv[4]; f = iv[5]; g = iv[6]; h = iv[7];
+
+	for (i = 0; i < 16; i += 8) {
+		ROUNDS8(work_space, i, W_LOAD);
+	}
+
+	for ( ; i < 64; i += 8) {
+		ROUNDS8(work_space, i, W_NEXT);
+	}
+
+	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
+	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
+}
+
+#else
+
 static void compress(unsigned int *iv, const uint8_t *data)
 {
 	unsigned int a, b, c, d, e, f, g, h;
@@ -215,3 +314,5 @@ static void compress(unsigned int *iv, const uint8_t *data)
 	iv[0] += a; iv[1] += b; iv[2] += c; iv[3] += d;
 	iv[4] += e; iv[5] += f; iv[6] += g; iv[7] += h;
 }
+
+#endif /* TC_SHA256_UNROLLED */
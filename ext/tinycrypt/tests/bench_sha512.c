@@ -0,0 +1,163 @@
+/*  bench_sha512.c - Host throughput benchmark of the TinyCrypt SHA-512 */
+
+/*
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Copyright (c) 2024 Alif Semiconductor
+ */
+
+/*
+  DESCRIPTION
+  Checks the SHA-512 and SHA-384 known answers of FIPS 180-2, then measures
+  the throughput of tc_sha512_update() over a buffer the size of a typical
+  firmware image, from an aligned and from an unaligned address. Build it
+  with and without TC_SHA512_UNROLLED (`make bench`) to compare the two
+  compress() implementations.
+*/
+
+/* clock_gettime() is POSIX, the tests are otherwise built as plain C99 */
+#define _POSIX_C_SOURCE 199309L
+
+#include <tinycrypt/sha512.h>
+#include <tinycrypt/constants.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_BUF_SIZE  (512 * 1024)
+#define BENCH_ROUNDS    16
+
+static uint8_t buf[BENCH_BUF_SIZE + 1];
+
+static const char msg_1block[] = "abc";
+static const char msg_2block[] =
+	"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+	"hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+static const uint8_t sha512_1block[TC_SHA512_DIGEST_SIZE] = {
+	0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba,
+	0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+	0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+	0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+	0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8,
+	0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+	0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e,
+	0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f,
+};
+
+static const uint8_t sha512_2block[TC_SHA512_DIGEST_SIZE] = {
+	0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda,
+	0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f,
+	0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1,
+	0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18,
+	0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4,
+	0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+	0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54,
+	0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09,
+};
+
+static const uint8_t sha384_1block[TC_SHA384_DIGEST_SIZE] = {
+	0xcb, 0x00, 0x75, 0x3f, 0x45, 0xa3, 0x5e, 0x8b,
+	0xb5, 0xa0, 0x3d, 0x69, 0x9a, 0xc6, 0x50, 0x07,
+	0x27, 0x2c, 0x32, 0xab, 0x0e, 0xde, 0xd1, 0x63,
+	0x1a, 0x8b, 0x60, 0x5a, 0x43, 0xff, 0x5b, 0xed,
+	0x80, 0x86, 0x07, 0x2b, 0xa1, 0xe7, 0xcc, 0x23,
+	0x58, 0xba, 0xec, 0xa1, 0x34, 0xc8, 0x25, 0xa7,
+};
+
+static const uint8_t sha384_2block[TC_SHA384_DIGEST_SIZE] = {
+	0x09, 0x33, 0x0c, 0x33, 0xf7, 0x11, 0x47, 0xe8,
+	0x3d, 0x19, 0x2f, 0xc7, 0x82, 0xcd, 0x1b, 0x47,
+	0x53, 0x11, 0x1b, 0x17, 0x3b, 0x3b, 0x05, 0xd2,
+	0x2f, 0xa0, 0x80, 0x86, 0xe3, 0xb0, 0xf7, 0x12,
+	0xfc, 0xc7, 0xc7, 0x1a, 0x55, 0x7e, 0x2d, 0xb9,
+	0x66, 0xc3, 0xe9, 0xfa, 0x91, 0x74, 0x60, 0x39,
+};
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int check(const char *name, const char *msg, int sha384,
+		 const uint8_t *expected)
+{
+	struct tc_sha512_state_struct s;
+	uint8_t digest[TC_SHA512_DIGEST_SIZE];
+	size_t len = sha384 ? TC_SHA384_DIGEST_SIZE : TC_SHA512_DIGEST_SIZE;
+
+	if (sha384) {
+		(void)tc_sha384_init(&s);
+	} else {
+		(void)tc_sha512_init(&s);
+	}
+	(void)tc_sha512_update(&s, (const uint8_t *)msg, strlen(msg));
+	if (sha384) {
+		(void)tc_sha384_final(digest, &s);
+	} else {
+		(void)tc_sha512_final(digest, &s);
+	}
+
+	if (memcmp(digest, expected, len) != 0) {
+		printf("%s: FAILED\n", name);
+		return 1;
+	}
+	return 0;
+}
+
+static double bench(const uint8_t *data, size_t len, uint8_t *digest)
+{
+	struct tc_sha512_state_struct s;
+	double start;
+	double elapsed;
+	int i;
+
+	start = now();
+	for (i = 0; i < BENCH_ROUNDS; ++i) {
+		(void)tc_sha512_init(&s);
+		(void)tc_sha512_update(&s, data, len);
+		(void)tc_sha512_final(digest, &s);
+	}
+	elapsed = now() - start;
+
+	return (double)len * BENCH_ROUNDS / elapsed / (1024 * 1024);
+}
+
+int main(void)
+{
+	uint8_t digest[TC_SHA512_DIGEST_SIZE];
+	size_t i;
+	int failed = 0;
+
+	failed += check("sha512 1 block", msg_1block, 0, sha512_1block);
+	failed += check("sha512 2 blocks", msg_2block, 0, sha512_2block);
+	failed += check("sha384 1 block", msg_1block, 1, sha384_1block);
+	failed += check("sha384 2 blocks", msg_2block, 1, sha384_2block);
+	if (failed) {
+		return 1;
+	}
+
+	for (i = 0; i < sizeof(buf); ++i) {
+		buf[i] = (uint8_t)(i * 31 + 7);
+	}
+
+#if defined(TC_SHA512_UNROLLED)
+	printf("compress: unrolled\n");
+#else
+	printf("compress: reference\n");
+#endif
+	printf("aligned:   %8.2f MiB/s\n", bench(buf, BENCH_BUF_SIZE, digest));
+	printf("unaligned: %8.2f MiB/s\n", bench(buf + 1, BENCH_BUF_SIZE, digest));
+	printf("digest:    ");
+	for (i = 0; i < sizeof(digest); ++i) {
+		printf("%02x", digest[i]);
+	}
+	printf("\n");
+
+	return 0;
+}
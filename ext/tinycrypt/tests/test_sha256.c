@@ -407,6 +407,45 @@ unsigned int test_14(void)
         return result;
 }
 
+/*
+ * A message split in chunks of uneven sizes, starting at unaligned addresses,
+ * must give the same digest as when it is hashed in one call.
+ */
+unsigned int test_15(void)
+{
+        unsigned int result = TC_PASS;
+        TC_PRINT("SHA256 test #15:\n");
+        const uint8_t expected[32] = {
+		0x1e, 0x9b, 0xc3, 0x8c, 0xbf, 0x86, 0x0b, 0x9e, 0xc3, 0x19, 0x18, 0xb0,
+		0x65, 0xf9, 0xb5, 0x24, 0x76, 0xc5, 0x49, 0xa7, 0x82, 0xe0, 0xe7, 0x99,
+		0x0b, 0xed, 0x8c, 0xe3, 0x86, 0x8d, 0x23, 0x71
+        };
+        const size_t chunks[] = { 1, 63, 64, 65, 3, 200, 128, 7 };
+        uint8_t m[1000 + 1];
+        uint8_t digest[32];
+        struct tc_sha256_state_struct s;
+        size_t off;
+        unsigned int i;
+
+        for (i = 0; i < 1000; ++i) {
+                m[i + 1] = (uint8_t)(i * 7 + 3);
+        }
+
+        (void) tc_sha256_init(&s);
+        off = 1;
+        for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+                tc_sha256_update(&s, m + off, chunks[i]);
+                off += chunks[i];
+        }
+        tc_sha256_update(&s, m + off, sizeof(m) - off);
+        (void) tc_sha256_final(digest, &s);
+
+        result = check_result(15, expected, sizeof(expected),
+			      digest, sizeof(digest));
+        TC_END_RESULT(result);
+        return result;
+}
+
 /*
  * Main task to test AES
  */
@@ -501,6 +540,12 @@ int main(void)
                 TC_ERROR("SHA256 test #14 failed.\n");
                 goto exitTest;
         }
+        result = test_15();
+        if (result == TC_FAIL) {
+		/* terminate test */
+                TC_ERROR("SHA256 test #15 failed.\n");
+                goto exitTest;
+        }
 
         TC_PRINT("All SHA256 tests succeeded!\n");
 
@@ -0,0 +1,134 @@
+# Copyright (c) 2024 Alif Semiconductor
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Patches of delta images, see boot/bootutil/src/delta.c.
+
+A patch is a sequence of records, each made of the number of bytes to copy
+from the base, the number of bytes to insert from the patch, the move of the
+base position after the copy, and the bytes to insert. The target is written
+over the base window by window, so a copy to window k may only read the base
+from the start of window k on.
+"""
+
+# Length of the blocks indexed to find matches, and the shortest match used.
+BLOCK_SIZE = 8
+# Number of base positions remembered per block.
+MAX_CANDIDATES = 8
+
+
+def _leb128(val):
+    out = bytearray()
+    while True:
+        byte = val & 0x7f
+        val >>= 7
+        if val:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _zigzag(val):
+    return val << 1 if val >= 0 else ((-val - 1) << 1) | 1
+
+
+def _match_len(base, target, q, p, window):
+    n = 0
+    while (p + n < len(target) and q + n < len(base) and
+           base[q + n] == target[p + n] and
+           q + n >= (p + n) // window * window):
+        n += 1
+    return n
+
+
+def make_patch(base, target, window):
+    """Returns a patch turning base into target, written window by window."""
+    index = {}
+    for q in range(len(base) - BLOCK_SIZE + 1):
+        positions = index.setdefault(base[q:q + BLOCK_SIZE], [])
+        if len(positions) == MAX_CANDIDATES:
+            positions.pop(0)
+        positions.append(q)
+
+    patch = bytearray()
+    copy_off = 0    # Base position of the pending record's copy.
+    copy_len = 0
+    literal_start = 0
+    shift = 0       # Base position minus target position of the last match.
+    p = 0
+    while p < len(target):
+        best_q, best_len = 0, 0
+        candidates = index.get(bytes(target[p:p + BLOCK_SIZE]), [])
+        for q in [p + shift] + candidates:
+            if q < 0:
+                continue
+            n = _match_len(base, target, q, p, window)
+            if n > best_len:
+                best_q, best_len = q, n
+        if best_len < BLOCK_SIZE:
+            p += 1
+            continue
+
+        literal = target[literal_start:p]
+        patch += _leb128(copy_len)
+        patch += _leb128(len(literal))
+        patch += _leb128(_zigzag(best_q - (copy_off + copy_len)))
+        patch += literal
+        copy_off, copy_len = best_q, best_len
+        shift = best_q - p
+        p += best_len
+        literal_start = p
+
+    literal = target[literal_start:]
+    patch += _leb128(copy_len)
+    patch += _leb128(len(literal))
+    patch += _leb128(0)
+    patch += literal
+    return bytes(patch)
+
+
+def apply_patch(base, patch, window):
+    """Applies a patch the way the bootloader does, checking its copies."""
+    target = bytearray()
+    pos = 0
+    base_off = 0
+
+    def read_leb128():
+        nonlocal pos
+        val = 0
+        shift = 0
+        while True:
+            byte = patch[pos]
+            pos += 1
+            val |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                return val
+
+    while pos < len(patch):
+        copy = read_leb128()
+        insert = read_leb128()
+        seek = read_leb128()
+        for i in range(copy):
+            if base_off + i < len(target) // window * window:
+                raise ValueError("Patch copies from an overwritten window")
+            target.append(base[base_off + i])
+        target += patch[pos:pos + insert]
+        pos += insert
+        base_off += copy
+        base_off += -((seek >> 1) + 1) if seek & 1 else seek >> 1
+    return bytes(target)
@@ -21,8 +21,11 @@ Image signing and management.
 """
 
 from . import version as versmod
+from . import delta as deltamod
+from . import lz4 as lz4mod
 from .boot_record import create_sw_component_data
 import click
+import copy
 from enum import Enum
 from intelhex import IntelHex
 import hashlib
@@ -55,6 +58,8 @@ IMAGE_F = {
         'ENCRYPTED_AES256':      0x0000008,
         'NON_BOOTABLE':          0x0000010,
         'RAM_LOAD':              0x0000020,
+        'DELTA':                 0x0000040,
+        'COMPRESSED_LZ4':        0x0000080,
         'ROM_FIXED':             0x0000100,
 }
 
@@ -74,6 +79,11 @@ TLV_VALUES = {
         'DEPENDENCY': 0x40,
         'SEC_CNT': 0x50,
         'BOOT_RECORD': 0x60,
+        'DELTA_BASE': 0x80,
+        'DELTA_TARGET': 0x81,
+        'DELTA_INFO': 0x82,
+        'DECOMP_HASH': 0x83,
+        'DECOMP_INFO': 0x84,
 }
 
 TLV_SIZE = 4
@@ -165,6 +175,9 @@ class Image():
         self.enckey = None
         self.save_enctlv = save_enctlv
         self.enctlv_len = 0
+        # Flag and protected TLVs of a delta or compressed payload.
+        self.payload_flags = 0
+        self.payload_tlvs = {}
         self.max_align = max(DEFAULT_MAX_ALIGN, align) if max_align is None else int(max_align)
 
         if self.max_align == DEFAULT_MAX_ALIGN:
@@ -388,6 +401,13 @@ class Image():
             for value in custom_tlvs.values():
                 protected_tlv_size += TLV_SIZE + len(value)
 
+        if self.payload_tlvs:
+            if enckey is not None:
+                raise click.UsageError(
+                    "Delta and compressed images can not be encrypted")
+            for value in self.payload_tlvs.values():
+                protected_tlv_size += TLV_SIZE + len(value)
+
         if protected_tlv_size != 0:
             # Add the size of the TLV info header
             protected_tlv_size += TLV_INFO_SIZE
@@ -443,6 +463,9 @@ class Image():
                 for tag, value in custom_tlvs.items():
                     prot_tlv.add(tag, value)
 
+            for tag, value in self.payload_tlvs.items():
+                prot_tlv.add(tag, value)
+
             protected_tlv_off = len(self.payload)
             self.payload += prot_tlv.get()
 
@@ -454,6 +477,8 @@ class Image():
         sha.update(self.payload)
         digest = sha.digest()
         tlv.add(hash_tlv, digest)
+        self.hash_tlv = hash_tlv
+        self.digest = digest
 
         if vector_to_sign == 'payload':
             # Stop amending data to the image
@@ -536,6 +561,93 @@ class Image():
     def get_signature(self):
         return self.signature
 
+    def _hash_tlv_of(self, b):
+        """Returns the hash TLV of a signed image."""
+        e = STRUCT_ENDIAN_DICT[self.endian]
+        magic, _, header_size, prot_tlv_size, img_size = \
+            struct.unpack(e + 'IIHHI', b[:16])
+        if magic != IMAGE_MAGIC:
+            raise click.UsageError("Delta base is not a signed image")
+        tlv_off = header_size + img_size + prot_tlv_size
+        magic, tlv_tot = struct.unpack(e + 'HH',
+                                       b[tlv_off:tlv_off + TLV_INFO_SIZE])
+        if magic != TLV_INFO_MAGIC:
+            raise click.UsageError("Delta base has no TLV area")
+        tlv_end = tlv_off + tlv_tot
+        tlv_off += TLV_INFO_SIZE
+        while tlv_off < tlv_end:
+            tlv_type, _, tlv_len = struct.unpack(
+                e + 'BBH', b[tlv_off:tlv_off + TLV_SIZE])
+            tlv_off += TLV_SIZE
+            if tlv_type == TLV_VALUES[self.hash_tlv]:
+                return bytes(b[tlv_off:tlv_off + tlv_len]), tlv_end
+            tlv_off += tlv_len
+        raise click.UsageError("Delta base has no {} TLV".format(
+            self.hash_tlv))
+
+    def make_delta(self, base_path, window):
+        """Return a delta image whose payload is a patch turning the signed
+        image in base_path, as found in the primary slot, into this image.
+        The new image must still be created."""
+        if window < IMAGE_HEADER_SIZE or window % self.max_align != 0:
+            raise click.UsageError("Invalid delta window size: {}".format(
+                window))
+        ext = os.path.splitext(base_path)[1][1:].lower()
+        try:
+            if ext == INTEL_HEX_EXT:
+                base = bytes(IntelHex(base_path).tobinarray())
+            else:
+                with open(base_path, 'rb') as f:
+                    base = f.read()
+        except FileNotFoundError:
+            raise click.UsageError("Delta base file not found")
+        base_hash, base_end = self._hash_tlv_of(base)
+        base = base[:base_end]
+
+        target = bytes(self.payload)
+        patch = deltamod.make_patch(base, target, window)
+        assert deltamod.apply_patch(base, patch, window) == target
+        print(os.path.basename(__file__) +
+              ": delta patch of 0x{:x} bytes for an image of 0x{:x}".format(
+                  len(patch), len(target)))
+
+        e = STRUCT_ENDIAN_DICT[self.endian]
+        img = copy.copy(self)
+        img.payload = bytes(self.header_size) + patch
+        img.payload_flags = IMAGE_F['DELTA']
+        img.payload_tlvs = {
+            'DELTA_BASE': base_hash,
+            'DELTA_TARGET': self.digest,
+            'DELTA_INFO': struct.pack(e + 'II', len(target), window),
+        }
+        return img
+
+    def make_compressed(self, window):
+        """Return an image whose payload is this image, from its header to
+        its last TLV, compressed with LZ4 so that it can be decompressed
+        through a window of the given size. The new image must still be
+        created."""
+        if window < IMAGE_HEADER_SIZE or window % self.max_align != 0:
+            raise click.UsageError(
+                "Invalid decompression window size: {}".format(window))
+
+        target = bytes(self.payload)
+        block = lz4mod.compress_block(target, window)
+        assert lz4mod.decompress_block(block, window) == target
+        print(os.path.basename(__file__) +
+              ": compressed 0x{:x} bytes to 0x{:x}".format(
+                  len(target), len(block)))
+
+        e = STRUCT_ENDIAN_DICT[self.endian]
+        img = copy.copy(self)
+        img.payload = bytes(self.header_size) + block
+        img.payload_flags = IMAGE_F['COMPRESSED_LZ4']
+        img.payload_tlvs = {
+            'DECOMP_HASH': self.digest,
+            'DECOMP_INFO': struct.pack(e + 'II', len(target), window),
+        }
+        return img
+
     def add_header(self, enckey, protected_tlv_size, aes_length=128):
         """Install the image header."""
 
@@ -551,6 +663,7 @@ class Image():
             flags |= IMAGE_F['RAM_LOAD']
         if self.rom_fixed:
             flags |= IMAGE_F['ROM_FIXED']
+        flags |= self.payload_flags
 
         e = STRUCT_ENDIAN_DICT[self.endian]
         fmt = (e +
@@ -228,6 +228,9 @@ class ECDSA384P1Public(ECDSAPublicKey):
     def sig_type(self):
         return "ECDSA384_SHA384"
 
+    def image_hash_algorithm(self):
+        return SHA384()
+
     def sig_tlv(self):
         return "ECDSASIG"
 
@@ -4,6 +4,7 @@ Tests for ECDSA keys
 
 # SPDX-License-Identifier: Apache-2.0
 
+import hashlib
 import io
 import os.path
 import sys
@@ -16,7 +17,7 @@ from cryptography.hazmat.primitives.hashes import SHA256
 
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '../..')))
 
-from imgtool.keys import load, ECDSA256P1, ECDSAUsageError
+from imgtool.keys import load, ECDSA256P1, ECDSA384P1, ECDSAUsageError
 
 class EcKeyGeneration(unittest.TestCase):
 
@@ -78,6 +79,23 @@ class EcKeyGeneration(unittest.TestCase):
         k2.emit_rust_public(rustcode)
         self.assertIn("ECDSA_PUB_KEY", rustcode.getvalue())
 
+    def test_emit_hash(self):
+        """The key digest uses the hash algorithm of the images."""
+        for cls, hash_func in ((ECDSA256P1, hashlib.sha256),
+                               (ECDSA384P1, hashlib.sha384)):
+            k = cls.generate()
+            digest = hash_func(k.get_public_bytes()).digest()
+            self.assertEqual(k.get_public_key_hash(), digest)
+
+            cname = self.tname("pubkey.c")
+            k.emit_c_public(cname, with_hash=True)
+            with open(cname) as f:
+                ccode = f.read()
+            self.assertIn("_pub_key_hash[]", ccode)
+            self.assertIn("_pub_key_hash_len = {};".format(len(digest)),
+                          ccode)
+            self.assertIn("0x{:02x},".format(digest[-1]), ccode)
+
     def test_sig(self):
         k = ECDSA256P1.generate()
         buf = b'This is the message'
@@ -20,8 +20,9 @@ class KeyClass(object):
                                  sys.stdout, len_format)
 
     def _emit_to_output(self, header, trailer, encoded_bytes, indent, file,
-                        len_format):
-        print(AUTOGEN_MESSAGE, file=file)
+                        len_format, autogen=True):
+        if autogen:
+            print(AUTOGEN_MESSAGE, file=file)
         print(header, end='', file=file)
         for count, b in enumerate(encoded_bytes):
             if count % 8 == 0:
@@ -33,8 +34,26 @@ class KeyClass(object):
         if len_format is not None:
             print(len_format.format(len(encoded_bytes)), file=file)
 
-    def emit_c_public(self, file=sys.stdout):
-        self._emit(
+    def image_hash_algorithm(self):
+        """Hash algorithm of the images signed with this key, which is
+        also the one their KEYHASH TLV is computed with."""
+        return SHA256()
+
+    def get_public_key_hash(self):
+        digest = Hash(self.image_hash_algorithm())
+        digest.update(self.get_public_bytes())
+        return digest.finalize()
+
+    def emit_c_public(self, file=sys.stdout, with_hash=False,
+                      preparsed=False):
+        if file and file is not sys.stdout:
+            with open(file, 'w') as file:
+                self._emit_c_public_to_output(file, with_hash, preparsed)
+        else:
+            self._emit_c_public_to_output(sys.stdout, with_hash, preparsed)
+
+    def _emit_c_public_to_output(self, file, with_hash, preparsed=False):
+        self._emit_to_output(
                 header="const unsigned char {}_pub_key[] = {{"
                        .format(self.shortname()),
                 trailer="};",
@@ -43,6 +62,25 @@ class KeyClass(object):
                 len_format="const unsigned int {}_pub_key_len = {{}};"
                            .format(self.shortname()),
                 file=file)
+        if with_hash:
+            # Lets MCUBOOT_KEY_HASH_TABLE builds match the KEYHASH TLV
+            # without hashing the key on every boot.
+            self._emit_to_output(
+                    header="const unsigned char {}_pub_key_hash[] = {{"
+                           .format(self.shortname()),
+                    trailer="};",
+                    encoded_bytes=self.get_public_key_hash(),
+                    indent="    ",
+                    len_format="const unsigned int {}_pub_key_hash_len = {{}};"
+                               .format(self.shortname()),
+                    file=file,
+                    autogen=False)
+        if preparsed:
+            self._emit_c_preparsed_to_output(file)
+
+    def _emit_c_preparsed_to_output(self, file):
+        raise NotImplementedError(
+                "{} keys have no pre-decoded form".format(self.shortname()))
 
     def emit_c_public_hash(self, file=sys.stdout):
         digest = Hash(SHA256())
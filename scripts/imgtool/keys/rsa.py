@@ -64,6 +64,42 @@ class RSAPublic(KeyClass):
         with open(path, 'wb') as f:
             f.write(pem)
 
+    def get_preparsed_public(self):
+        """Returns (n0inv, n limbs, rr limbs) of the public key, the form
+        used by MCUBOOT_RSA_PREPARSED_KEYS. Limbs are 32 bits, least
+        significant first."""
+        numbers = self._get_public().public_numbers()
+        if numbers.e != 65537:
+            raise RSAUsageError("Pre-decoded keys require e = 65537")
+        n = numbers.n
+        limbs = self.key_size() // 32
+        rr = pow(2, 2 * 32 * limbs, n)
+        n0inv = -pow(n, -1, 1 << 32) % (1 << 32)
+
+        def to_limbs(v):
+            return [(v >> (32 * i)) & 0xffffffff for i in range(limbs)]
+        return n0inv, to_limbs(n), to_limbs(rr)
+
+    def _emit_c_preparsed_to_output(self, file):
+        n0inv, n, rr = self.get_preparsed_public()
+
+        def emit_limbs(name, limbs):
+            print("    .{} = {{".format(name), end='', file=file)
+            for count, limb in enumerate(limbs):
+                if count % 4 == 0:
+                    print("\n        ", end='', file=file)
+                else:
+                    print(" ", end='', file=file)
+                print("0x{:08x},".format(limb), end='', file=file)
+            print("\n    },", file=file)
+
+        print("const struct bootutil_rsa_pub_key {}_pub_key_preparsed = {{"
+              .format(self.shortname()), file=file)
+        print("    .n0inv = 0x{:08x},".format(n0inv), file=file)
+        emit_limbs("n", n)
+        emit_limbs("rr", rr)
+        print("};", file=file)
+
     def sig_type(self):
         return "PKCS1_PSS_RSA{}_SHA256".format(self.key_size())
 
@@ -90,6 +90,29 @@ class KeyGeneration(unittest.TestCase):
             k2.emit_rust_public(rustcode)
             self.assertIn("RSA_PUB_KEY", rustcode.getvalue())
 
+    def test_emit_preparsed(self):
+        """Check the pre-decoded key against the public numbers."""
+        for key_size in RSA_KEY_SIZES:
+            k = RSA.generate(key_size=key_size)
+            n = k._get_public().public_numbers().n
+
+            n0inv, n_limbs, rr_limbs = k.get_preparsed_public()
+            limbs = key_size // 32
+            self.assertEqual(len(n_limbs), limbs)
+            self.assertEqual(len(rr_limbs), limbs)
+            self.assertEqual(sum(v << (32 * i)
+                                 for i, v in enumerate(n_limbs)), n)
+            self.assertEqual((n * n0inv + 1) % (1 << 32), 0)
+            rr = sum(v << (32 * i) for i, v in enumerate(rr_limbs))
+            self.assertEqual(rr, pow(2, 64 * limbs, n))
+
+            cname = self.tname("preparsed.c")
+            k.emit_c_public(cname, preparsed=True)
+            with open(cname) as f:
+                ccode = f.read()
+            self.assertIn("rsa_pub_key_preparsed", ccode)
+            self.assertIn(".n0inv = 0x{:08x},".format(n0inv), ccode)
+
     def test_sig(self):
         for key_size in RSA_KEY_SIZES:
             k = RSA.generate(key_size=key_size)
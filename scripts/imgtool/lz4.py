@@ -0,0 +1,139 @@
+# Copyright (c) 2024 Alif Semiconductor
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+LZ4 blocks of compressed images, see boot/bootutil/src/decompress.c.
+
+The block format is the standard one, so any LZ4 decoder reads these blocks,
+but the matches never reach further back than the decompression window, the
+only history the bootloader keeps.
+"""
+
+# Shortest match, which match lengths are relative to.
+MIN_MATCH = 4
+# The last match starts at least MF_LIMIT bytes before the end, and the last
+# LAST_LITERALS bytes are always literals, as LZ4 decoders expect.
+MF_LIMIT = 12
+LAST_LITERALS = 5
+# Largest offset the format can hold.
+MAX_OFFSET = 0xffff
+# Number of positions remembered per prefix.
+MAX_CANDIDATES = 16
+
+
+def _length(out, n):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def _sequence(out, literal, match_len, offset):
+    lit_len = len(literal)
+    token = min(lit_len, 15) << 4
+    if match_len:
+        token |= min(match_len - MIN_MATCH, 15)
+    out.append(token)
+    if lit_len >= 15:
+        _length(out, lit_len - 15)
+    out += literal
+    if match_len:
+        out += offset.to_bytes(2, 'little')
+        if match_len - MIN_MATCH >= 15:
+            _length(out, match_len - MIN_MATCH - 15)
+
+
+def _match_len(data, q, p, limit):
+    n = 0
+    while (n + 32 <= limit - p and
+           data[q + n:q + n + 32] == data[p + n:p + n + 32]):
+        n += 32
+    while p + n < limit and data[q + n] == data[p + n]:
+        n += 1
+    return n
+
+
+def compress_block(data, window):
+    """Returns data as an LZ4 block whose matches reach at most window bytes
+    back."""
+    max_offset = min(window, MAX_OFFSET)
+    match_limit = len(data) - LAST_LITERALS
+    index = {}
+    out = bytearray()
+    literal_start = 0
+    p = 0
+    while p + MF_LIMIT < len(data):
+        prefix = data[p:p + MIN_MATCH]
+        positions = index.setdefault(prefix, [])
+        best_q, best_len = 0, 0
+        for q in reversed(positions):
+            if p - q > max_offset:
+                break
+            n = _match_len(data, q, p, match_limit)
+            if n > best_len:
+                best_q, best_len = q, n
+        if len(positions) == MAX_CANDIDATES:
+            positions.pop(0)
+        positions.append(p)
+        if best_len < MIN_MATCH:
+            p += 1
+            continue
+
+        _sequence(out, data[literal_start:p], best_len, p - best_q)
+        # Index the matched bytes too, for the matches that follow.
+        for i in range(p + 1, min(p + best_len, len(data) - MF_LIMIT)):
+            positions = index.setdefault(data[i:i + MIN_MATCH], [])
+            if len(positions) == MAX_CANDIDATES:
+                positions.pop(0)
+            positions.append(i)
+        p += best_len
+        literal_start = p
+
+    _sequence(out, data[literal_start:], 0, 0)
+    return bytes(out)
+
+
+def decompress_block(block, window):
+    """Decompresses an LZ4 block the way the bootloader does, checking that
+    its matches stay within the window."""
+    out = bytearray()
+    pos = 0
+
+    def read_length(n):
+        nonlocal pos
+        if n == 15:
+            while True:
+                byte = block[pos]
+                pos += 1
+                n += byte
+                if byte != 255:
+                    break
+        return n
+
+    while True:
+        token = block[pos]
+        pos += 1
+        lit_len = read_length(token >> 4)
+        out += block[pos:pos + lit_len]
+        pos += lit_len
+        if pos == len(block):
+            return bytes(out)
+        offset = int.from_bytes(block[pos:pos + 2], 'little')
+        pos += 2
+        if offset == 0 or offset > window or offset > len(out):
+            raise ValueError("LZ4 match out of the window")
+        for _ in range(read_length(token & 0x0f) + MIN_MATCH):
+            out.append(out[-offset])
@@ -132,8 +132,15 @@ def keygen(type, key, password):
 @click.option('-o', '--output', metavar='output', required=False,
               help='Specify the output file\'s name. \
                     The stdout is used if it is not provided.')
+@click.option('--with-hash', default=False, is_flag=True,
+              help='Also emit the digest of the key, as used by '
+                   'MCUBOOT_KEY_HASH_TABLE. Only valid with the C encoding.')
+@click.option('--rsa-preparsed', default=False, is_flag=True,
+              help='Also emit the RSA key pre-decoded, as used by '
+                   'MCUBOOT_RSA_PREPARSED_KEYS. Only valid with the C '
+                   'encoding.')
 @click.command(help='Dump public key from keypair')
-def getpub(key, encoding, lang, output):
+def getpub(key, encoding, lang, output, with_hash, rsa_preparsed):
     if encoding and lang:
         raise click.UsageError('Please use only one of `--encoding/-e` '
                                'or `--lang/-l`')
@@ -141,14 +148,24 @@ def getpub(key, encoding, lang, output):
         # Preserve old behavior defaulting to `c`. If `lang` is removed,
         # `default=valid_encodings[0]` should be added to `-e` param.
         lang = valid_langs[0]
+    if with_hash and not (lang == 'c' or encoding == 'lang-c'):
+        raise click.UsageError('`--with-hash` is only valid with the C '
+                               'encoding')
+    if rsa_preparsed and not (lang == 'c' or encoding == 'lang-c'):
+        raise click.UsageError('`--rsa-preparsed` is only valid with the C '
+                               'encoding')
     key = load_key(key)
+    if rsa_preparsed and key is not None and \
+            not isinstance(key, (keys.RSA, keys.RSAPublic)):
+        raise click.UsageError('`--rsa-preparsed` requires an RSA key')
 
     if not output:
         output = sys.stdout
     if key is None:
         print("Invalid passphrase")
     elif lang == 'c' or encoding == 'lang-c':
-        key.emit_c_public(file=output)
+        key.emit_c_public(file=output, with_hash=with_hash,
+                          preparsed=rsa_preparsed)
     elif lang == 'rust' or encoding == 'lang-rust':
         key.emit_rust_public(file=output)
     elif encoding == 'pem':
@@ -396,6 +413,22 @@ class BasedIntParamType(click.ParamType):
 @click.option('--sig-out', metavar='filename',
               help='Path to the file to which signature will be written. '
               'The image signature will be encoded as base64 formatted string')
+@click.option('--delta-base', metavar='filename',
+              help='Make a delta image, holding a patch against this signed '
+              'image, which must be the one in the primary slot. Requires '
+              'MCUBOOT_DELTA_UPGRADE.')
+@click.option('--delta-window', type=BasedIntParamType(), default='4096',
+              help='Size of the blocks a delta image is applied in. At most '
+              'MCUBOOT_DELTA_WINDOW_SIZE and a multiple of the sector size of '
+              'the primary slot (default: 4096).')
+@click.option('--compression', type=click.Choice(['none', 'lz4']),
+              default='none', help='Compress the image, which the '
+              'bootloader decompresses into the primary slot. Requires '
+              'MCUBOOT_DECOMPRESS_IMAGES.')
+@click.option('--compression-window', type=BasedIntParamType(),
+              default='4096', help='How far back the matches of a compressed '
+              'image may reach. At most MCUBOOT_DECOMPRESS_WINDOW_SIZE '
+              '(default: 4096).')
 @click.option('--vector-to-sign', type=click.Choice(['payload', 'digest']),
               help='send to OUTFILE the payload or payload''s digest instead '
               'of complied image. These data can be used for external image '
@@ -408,7 +441,8 @@ def sign(key, public_key_format, align, version, pad_sig, header_size,
          endian, encrypt_keylen, encrypt, infile, outfile, dependencies,
          load_addr, hex_addr, erased_val, save_enctlv, security_counter,
          boot_record, custom_tlv, rom_fixed, max_align, clear, fix_sig,
-         fix_sig_pubkey, sig_out, vector_to_sign):
+         fix_sig_pubkey, sig_out, delta_base, delta_window, compression,
+         compression_window, vector_to_sign):
 
     if confirm:
         # Confirmed but non-padded images don't make much sense, because
@@ -473,6 +507,29 @@ def sign(key, public_key_format, align, version, pad_sig, header_size,
             'value': raw_signature
         }
 
+    if delta_base is not None:
+        if enckey is not None:
+            raise click.UsageError("Delta images can not be encrypted")
+        if baked_signature is not None or vector_to_sign is not None:
+            raise click.UsageError("Delta images must be signed by imgtool")
+        if compression != 'none':
+            raise click.UsageError("Delta images can not be compressed")
+        # The patch produces the image that would have been signed.
+        img.create(key, public_key_format, None, dependencies, boot_record,
+                   custom_tlvs)
+        img = img.make_delta(delta_base, delta_window)
+
+    if compression != 'none':
+        if enckey is not None:
+            raise click.UsageError("Compressed images can not be encrypted")
+        if baked_signature is not None or vector_to_sign is not None:
+            raise click.UsageError("Compressed images must be signed by "
+                                   "imgtool")
+        # The compressed image is the one that would have been signed.
+        img.create(key, public_key_format, None, dependencies, boot_record,
+                   custom_tlvs)
+        img = img.make_compressed(compression_window)
+
     img.create(key, public_key_format, enckey, dependencies, boot_record,
                custom_tlvs, int(encrypt_keylen), clear, baked_signature,
                pub_key, vector_to_sign)
@@ -17,9 +17,15 @@ fn main() {
     let sig_ecdsa_mbedtls = env::var("CARGO_FEATURE_SIG_ECDSA_MBEDTLS").is_ok();
     let sig_ecdsa_psa = env::var("CARGO_FEATURE_SIG_ECDSA_PSA").is_ok();
     let sig_p384 = env::var("CARGO_FEATURE_SIG_P384").is_ok();
+    let sha384_tinycrypt = env::var("CARGO_FEATURE_SHA384_TINYCRYPT").is_ok();
     let sig_ed25519 = env::var("CARGO_FEATURE_SIG_ED25519").is_ok();
     let overwrite_only = env::var("CARGO_FEATURE_OVERWRITE_ONLY").is_ok();
+    let overwrite_only_resume = env::var("CARGO_FEATURE_OVERWRITE_ONLY_RESUME").is_ok();
+    let overwrite_only_diff = env::var("CARGO_FEATURE_OVERWRITE_ONLY_DIFF").is_ok();
+    let delta_upgrade = env::var("CARGO_FEATURE_DELTA_UPGRADE").is_ok();
+    let decompress_images = env::var("CARGO_FEATURE_DECOMPRESS_IMAGES").is_ok();
     let swap_move = env::var("CARGO_FEATURE_SWAP_MOVE").is_ok();
+    let swap_offset = env::var("CARGO_FEATURE_SWAP_OFFSET").is_ok();
     let validate_primary_slot =
                   env::var("CARGO_FEATURE_VALIDATE_PRIMARY_SLOT").is_ok();
     let enc_rsa = env::var("CARGO_FEATURE_ENC_RSA").is_ok();
@@ -36,8 +42,22 @@ fn main() {
     let downgrade_prevention = env::var("CARGO_FEATURE_DOWNGRADE_PREVENTION").is_ok();
     let ram_load = env::var("CARGO_FEATURE_RAM_LOAD").is_ok();
     let direct_xip = env::var("CARGO_FEATURE_DIRECT_XIP").is_ok();
+    let max_align_16 = env::var("CARGO_FEATURE_MAX_ALIGN_16").is_ok();
     let max_align_32 = env::var("CARGO_FEATURE_MAX_ALIGN_32").is_ok();
     let hw_rollback_protection = env::var("CARGO_FEATURE_HW_ROLLBACK_PROTECTION").is_ok();
+    let async_read = env::var("CARGO_FEATURE_ASYNC_READ").is_ok();
+    let crypto_offload = env::var("CARGO_FEATURE_CRYPTO_OFFLOAD").is_ok();
+    let key_hash_table = env::var("CARGO_FEATURE_KEY_HASH_TABLE").is_ok();
+    let rsa_preparsed = env::var("CARGO_FEATURE_RSA_PREPARSED").is_ok();
+    let tlv_index = env::var("CARGO_FEATURE_TLV_INDEX").is_ok();
+    let boot_timeline = env::var("CARGO_FEATURE_BOOT_TIMELINE").is_ok();
+    let flash_stats = env::var("CARGO_FEATURE_FLASH_STATS").is_ok();
+    let dev_without_erase = env::var("CARGO_FEATURE_DEV_WITHOUT_ERASE").is_ok();
+    let validation_cache = env::var("CARGO_FEATURE_VALIDATION_CACHE").is_ok();
+    let hash_on_copy = env::var("CARGO_FEATURE_HASH_ON_COPY").is_ok();
+    let sha256_unrolled = env::var("CARGO_FEATURE_SHA256_UNROLLED").is_ok();
+    let sha512_unrolled = env::var("CARGO_FEATURE_SHA512_UNROLLED").is_ok();
+    let ecc_verify_windowed = env::var("CARGO_FEATURE_ECC_VERIFY_WINDOWED").is_ok();
 
     let mut conf = CachedBuild::new();
     conf.conf.define("__BOOTSIM__", None);
@@ -46,8 +66,14 @@ fn main() {
     conf.conf.define("MCUBOOT_HAVE_ASSERT_H", None);
     conf.conf.define("MCUBOOT_MAX_IMG_SECTORS", Some("128"));
 
+    if max_align_16 && max_align_32 {
+        panic!("max-align-16 and max-align-32 are exclusive");
+    }
+
     if max_align_32 {
         conf.conf.define("MCUBOOT_BOOT_MAX_ALIGN", Some("32"));
+    } else if max_align_16 {
+        conf.conf.define("MCUBOOT_BOOT_MAX_ALIGN", Some("16"));
     } else {
         conf.conf.define("MCUBOOT_BOOT_MAX_ALIGN", Some("8"));
     }
@@ -58,6 +84,34 @@ fn main() {
         panic!("Downgrade prevention requires overwrite only");
     }
 
+    if overwrite_only_resume && !overwrite_only {
+        panic!("Resuming overwrite upgrades requires overwrite only");
+    }
+
+    if overwrite_only_diff && !overwrite_only {
+        panic!("Sector-diff overwrite upgrades require overwrite only");
+    }
+
+    if validation_cache && !validate_primary_slot {
+        panic!("The validation cache requires validate primary slot");
+    }
+
+    if validation_cache && !(sig_ecdsa || sig_rsa || sig_rsa3072) {
+        panic!("The validation cache requires sig-ecdsa or sig-rsa for its HMAC");
+    }
+
+    if hash_on_copy && !(overwrite_only || bootstrap) {
+        panic!("Hashing on copy requires overwrite only or bootstrap");
+    }
+
+    if delta_upgrade && !overwrite_only {
+        panic!("Delta upgrades require overwrite only");
+    }
+
+    if decompress_images && !overwrite_only {
+        panic!("Compressed images require overwrite only");
+    }
+
     if bootstrap {
         conf.conf.define("MCUBOOT_BOOTSTRAP", None);
         conf.conf.define("MCUBOOT_OVERWRITE_ONLY_FAST", None);
@@ -71,6 +125,67 @@ fn main() {
         conf.conf.define("MCUBOOT_DOWNGRADE_PREVENTION", None);
     }
 
+    if tlv_index {
+        conf.conf.define("MCUBOOT_TLV_INDEX", None);
+    }
+
+    if key_hash_table {
+        conf.conf.define("MCUBOOT_KEY_HASH_TABLE", None);
+    }
+
+    if rsa_preparsed {
+        conf.conf.define("MCUBOOT_RSA_PREPARSED_KEYS", None);
+    }
+
+    if async_read {
+        conf.conf.define("MCUBOOT_FLASH_AREA_ASYNC_READ", None);
+    }
+
+    if boot_timeline || flash_stats {
+        conf.conf.define("MCUBOOT_USE_BENCH", None);
+    }
+
+    if boot_timeline {
+        conf.conf.define("MCUBOOT_BOOT_TIMELINE", None);
+    }
+
+    if flash_stats {
+        conf.conf.define("MCUBOOT_FLASH_STATS", None);
+    }
+
+    if dev_without_erase {
+        conf.conf.define("MCUBOOT_SUPPORT_DEV_WITHOUT_ERASE", None);
+    }
+
+    if hash_on_copy {
+        conf.conf.define("MCUBOOT_HASH_ON_COPY", None);
+    }
+
+    if sha256_unrolled {
+        conf.conf.define("TC_SHA256_UNROLLED", None);
+    }
+
+    if sha512_unrolled {
+        conf.conf.define("TC_SHA512_UNROLLED", None);
+    }
+
+    if ecc_verify_windowed {
+        conf.conf.define("TC_ECC_VERIFY_WINDOWED", None);
+    }
+
+    if validation_cache {
+        conf.conf.define("MCUBOOT_VALIDATION_CACHE", None);
+        conf.file("csupport/validation_cache.c");
+        if sig_ecdsa {
+            conf.file("../../ext/tinycrypt/lib/source/hmac.c");
+        }
+    }
+
+    if crypto_offload {
+        conf.conf.define("MCUBOOT_CRYPTO_OFFLOAD", None);
+        conf.file("csupport/crypto_offload.c");
+    }
+
     if ram_load {
         conf.conf.define("MCUBOOT_RAM_LOAD", None);
     }
@@ -213,6 +328,13 @@ fn main() {
         if sig_p384 {
             conf.conf.define("MCUBOOT_SIGN_EC384", None);
             conf.file("../../ext/mbedtls/library/sha512.c");
+            if sha384_tinycrypt {
+                conf.conf.define("MCUBOOT_SHA384_USE_TINYCRYPT", None);
+                conf.conf.include("../../ext/tinycrypt/lib/include");
+                conf.conf.include("../../ext/tinycrypt-sha512/lib/include");
+                conf.file("../../ext/tinycrypt-sha512/lib/source/sha512.c");
+                conf.file("../../ext/tinycrypt/lib/source/utils.c");
+            }
         } else {
             conf.conf.define("MCUBOOT_SIGN_EC256", None);
             conf.file("../../ext/mbedtls/library/sha256.c");
@@ -228,6 +350,8 @@ fn main() {
     } else if sig_ed25519 {
         conf.conf.define("MCUBOOT_SIGN_ED25519", None);
         conf.conf.define("MCUBOOT_USE_TINYCRYPT", None);
+        // Exercise one of the larger base point tables of ED25519_verify().
+        conf.conf.define("CURVE25519_BASE_TABLE_SIZE", Some("32"));
 
         conf.conf.include("../../ext/tinycrypt/lib/include");
         conf.conf.include("../../ext/tinycrypt-sha512/lib/include");
@@ -253,8 +377,26 @@ fn main() {
         conf.conf.define("MCUBOOT_OVERWRITE_ONLY", None);
     }
 
+    if overwrite_only_resume {
+        conf.conf.define("MCUBOOT_OVERWRITE_ONLY_RESUME", None);
+    }
+
+    if overwrite_only_diff {
+        conf.conf.define("MCUBOOT_OVERWRITE_ONLY_DIFF", None);
+    }
+
+    if delta_upgrade {
+        conf.conf.define("MCUBOOT_DELTA_UPGRADE", None);
+    }
+
+    if decompress_images {
+        conf.conf.define("MCUBOOT_DECOMPRESS_IMAGES", None);
+    }
+
     if swap_move {
         conf.conf.define("MCUBOOT_SWAP_USING_MOVE", None);
+    } else if swap_offset {
+        conf.conf.define("MCUBOOT_SWAP_USING_OFFSET", None);
     } else if !overwrite_only {
         conf.conf.define("CONFIG_BOOT_SWAP_USING_SCRATCH", None);
         conf.conf.define("MCUBOOT_SWAP_USING_SCRATCH", None);
@@ -458,10 +600,16 @@ fn main() {
     conf.file("../../boot/bootutil/src/swap_misc.c");
     conf.file("../../boot/bootutil/src/swap_scratch.c");
     conf.file("../../boot/bootutil/src/swap_move.c");
+    conf.file("../../boot/bootutil/src/swap_offset.c");
+    conf.file("../../boot/bootutil/src/delta.c");
+    conf.file("../../boot/bootutil/src/decompress.c");
     conf.file("../../boot/bootutil/src/caps.c");
     conf.file("../../boot/bootutil/src/bootutil_misc.c");
     conf.file("../../boot/bootutil/src/bootutil_public.c");
     conf.file("../../boot/bootutil/src/tlv.c");
+    conf.file("../../boot/bootutil/src/validation_cache.c");
+    conf.file("../../boot/bootutil/src/boot_timeline.c");
+    conf.file("../../boot/bootutil/src/flash_stats.c");
     conf.file("../../boot/bootutil/src/fault_injection_hardening.c");
     conf.file("csupport/run.c");
     conf.conf.include("../../boot/bootutil/include");
@@ -0,0 +1,194 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Crypto offload for the simulator. A worker thread stands in for the crypto
+ * engine: it takes the jobs in order from a queue shared by all simulator
+ * threads and runs them with the software implementations.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bootutil/crypto/offload.h"
+
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+
+#define SIM_CRYPTO_QUEUE_LEN 64
+
+enum sim_crypto_op {
+    SIM_CRYPTO_SHA_UPDATE,
+    SIM_CRYPTO_AES_CTR,
+};
+
+struct sim_crypto_entry {
+    struct boot_crypto_job *job;
+    enum sim_crypto_op op;
+    void *ctx;
+    uint8_t *counter;
+    const uint8_t *in;
+    uint8_t *out;
+    uint32_t len;
+    uint32_t blk_off;
+    unsigned *pending;          /* Jobs in flight of the submitting thread. */
+};
+
+static pthread_mutex_t sim_crypto_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_crypto_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t sim_crypto_once = PTHREAD_ONCE_INIT;
+
+/* The job at the head stays queued until it has completed. */
+static struct sim_crypto_entry sim_crypto_queue[SIM_CRYPTO_QUEUE_LEN];
+static unsigned sim_crypto_head;
+static unsigned sim_crypto_count;
+
+static __thread unsigned sim_crypto_pending;
+
+static int sim_crypto_run(struct sim_crypto_entry *e)
+{
+    switch (e->op) {
+    case SIM_CRYPTO_SHA_UPDATE:
+        return bootutil_sha_update(e->ctx, e->in, e->len);
+#ifdef MCUBOOT_ENC_IMAGES
+    case SIM_CRYPTO_AES_CTR:
+        return bootutil_aes_ctr_encrypt(e->ctx, e->counter, e->in, e->len,
+                                        e->blk_off, e->out);
+#endif
+    default:
+        return -1;
+    }
+}
+
+static void *sim_crypto_worker(void *arg)
+{
+    struct sim_crypto_entry e;
+    int rc;
+
+    (void)arg;
+
+    pthread_mutex_lock(&sim_crypto_lock);
+    for (;;) {
+        while (sim_crypto_count == 0) {
+            pthread_cond_wait(&sim_crypto_cond, &sim_crypto_lock);
+        }
+        e = sim_crypto_queue[sim_crypto_head];
+        pthread_mutex_unlock(&sim_crypto_lock);
+
+        rc = sim_crypto_run(&e);
+
+        pthread_mutex_lock(&sim_crypto_lock);
+        e.job->done(e.job, rc);
+        sim_crypto_head = (sim_crypto_head + 1) % SIM_CRYPTO_QUEUE_LEN;
+        sim_crypto_count--;
+        (*e.pending)--;
+        pthread_cond_broadcast(&sim_crypto_cond);
+    }
+
+    return NULL;
+}
+
+static void sim_crypto_start(void)
+{
+    pthread_t thread;
+
+    if (pthread_create(&thread, NULL, sim_crypto_worker, NULL) != 0) {
+        printf("Cannot start the crypto offload worker\n");
+        abort();
+    }
+    pthread_detach(thread);
+}
+
+static int sim_crypto_submit(struct sim_crypto_entry *e)
+{
+    pthread_once(&sim_crypto_once, sim_crypto_start);
+
+    e->pending = &sim_crypto_pending;
+
+    pthread_mutex_lock(&sim_crypto_lock);
+    while (sim_crypto_count == SIM_CRYPTO_QUEUE_LEN) {
+        pthread_cond_wait(&sim_crypto_cond, &sim_crypto_lock);
+    }
+    sim_crypto_queue[(sim_crypto_head + sim_crypto_count) %
+                     SIM_CRYPTO_QUEUE_LEN] = *e;
+    sim_crypto_count++;
+    sim_crypto_pending++;
+    pthread_cond_broadcast(&sim_crypto_cond);
+    pthread_mutex_unlock(&sim_crypto_lock);
+
+    return 0;
+}
+
+static int sim_crypto_queued(const struct boot_crypto_job *job)
+{
+    unsigned i;
+
+    for (i = 0; i < sim_crypto_count; i++) {
+        if (sim_crypto_queue[(sim_crypto_head + i) %
+                             SIM_CRYPTO_QUEUE_LEN].job == job) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int boot_crypto_sha_update_submit(struct boot_crypto_job *job,
+                                  bootutil_sha_context *ctx,
+                                  const void *data, uint32_t len)
+{
+    struct sim_crypto_entry e = {
+        .job = job,
+        .op = SIM_CRYPTO_SHA_UPDATE,
+        .ctx = ctx,
+        .in = data,
+        .len = len,
+    };
+
+    return sim_crypto_submit(&e);
+}
+
+#ifdef MCUBOOT_ENC_IMAGES
+int boot_crypto_aes_ctr_submit(struct boot_crypto_job *job,
+                               bootutil_aes_ctr_context *ctx,
+                               uint8_t *counter, const uint8_t *in,
+                               uint32_t len, uint32_t blk_off, uint8_t *out)
+{
+    struct sim_crypto_entry e = {
+        .job = job,
+        .op = SIM_CRYPTO_AES_CTR,
+        .ctx = ctx,
+        .counter = counter,
+        .in = in,
+        .out = out,
+        .len = len,
+        .blk_off = blk_off,
+    };
+
+    return sim_crypto_submit(&e);
+}
+#endif
+
+void boot_crypto_wait(struct boot_crypto_job *job)
+{
+    pthread_mutex_lock(&sim_crypto_lock);
+    while (sim_crypto_queued(job)) {
+        pthread_cond_wait(&sim_crypto_cond, &sim_crypto_lock);
+    }
+    pthread_mutex_unlock(&sim_crypto_lock);
+}
+
+/*
+ * Waits for all the jobs of the calling thread. Called before a simulated
+ * power failure unwinds the bootloader, whose buffers the jobs still use.
+ */
+void sim_crypto_offload_drain(void)
+{
+    pthread_mutex_lock(&sim_crypto_lock);
+    while (sim_crypto_pending != 0) {
+        pthread_cond_wait(&sim_crypto_cond, &sim_crypto_lock);
+    }
+    pthread_mutex_unlock(&sim_crypto_lock);
+}
+
+#endif /* MCUBOOT_CRYPTO_OFFLOAD */
@@ -50,6 +50,54 @@ const unsigned char root_pub_der[] = {
     0xc9, 0x02, 0x03, 0x01, 0x00, 0x01
 };
 const unsigned int root_pub_der_len = 270;
+const unsigned char root_pub_der_hash[] = {
+    0xfc, 0x57, 0x01, 0xdc, 0x61, 0x35, 0xe1, 0x32,
+    0x38, 0x47, 0xbd, 0xc4, 0x0f, 0x04, 0xd2, 0xe5,
+    0xbe, 0xe5, 0x83, 0x3b, 0x23, 0xc2, 0x9f, 0x93,
+    0x59, 0x3d, 0x00, 0x01, 0x8c, 0xfa, 0x99, 0x94,
+};
+const unsigned int root_pub_der_hash_len = 32;
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+const struct bootutil_rsa_pub_key root_pub_der_preparsed = {
+    .n0inv = 0x80aee787,
+    .n = {
+        0x62e1d1c9, 0xefb14b2c, 0xd167c647, 0xaf5c3aa7,
+        0xfa0d119d, 0x666435ec, 0xdcce681b, 0x59f81cab,
+        0xf81a2466, 0x1a1dfee8, 0xab873e93, 0x692723f3,
+        0x8217f28a, 0x31ad5fb0, 0x4cc88881, 0x5818f65e,
+        0x2bd0d308, 0x54f43ee1, 0xe0fa8237, 0x2abeafb8,
+        0xfeb8cefa, 0xa76a9df9, 0xa3aed20f, 0x1339833f,
+        0xffb7fdf3, 0xe4530d2f, 0x85d55c4a, 0x3ec80ed7,
+        0xf8656e64, 0x896924fb, 0xbe7b7221, 0xdb7773d4,
+        0x7eb7e115, 0x35ca6261, 0x4baa8d38, 0xc3776754,
+        0x7e473c94, 0xb4a9c888, 0x6fe75bba, 0xf8cf3d1e,
+        0x5c14dff2, 0xac414d9e, 0x698c2f5f, 0xb43c10e6,
+        0x2849a701, 0x4160ed15, 0x840baa77, 0x99dfe04d,
+        0x5ceeecb3, 0x080f0dbb, 0x2c44d167, 0x435e0d57,
+        0x7f10537e, 0xdb42e78c, 0xcbf3bc74, 0xf09c341b,
+        0x188019f9, 0xd35ae96d, 0xaad24b18, 0xbbee5ef9,
+        0x0da34f1f, 0xe8fbfdf7, 0x18442c18, 0xd106081a,
+    },
+    .rr = {
+        0xa46d7e40, 0x61d887b3, 0x1af6c61d, 0xa0bf6f48,
+        0xb8cec2e8, 0x6f6895e7, 0x723eaea3, 0x9f4cf49b,
+        0xc1648e24, 0x4933b156, 0xb620cc9e, 0x6a3d596a,
+        0xd7607b1c, 0xb9c7f122, 0x05a7314e, 0xfabdabfa,
+        0xb7ee0465, 0x9d9422c6, 0x7760b779, 0x7ef32296,
+        0xc25d8581, 0xa71a32cb, 0xfa31586c, 0xed49b341,
+        0x5249dd8c, 0xdae158dc, 0x936a5cd7, 0x2fb58c91,
+        0x1f617238, 0xf4c40bbe, 0xfc9ef774, 0xbb62bd84,
+        0xba88107e, 0xef1a0c45, 0x52124603, 0x6557f87a,
+        0x9c26779b, 0x05863028, 0x35875518, 0xf9b8d106,
+        0x51c66c09, 0x7941f544, 0xbcf6f070, 0x39b53706,
+        0x3166a931, 0xc97f93f7, 0x23f7bd3a, 0x5edb8506,
+        0xabe50eda, 0xfc98167d, 0xa4ca5244, 0xf93f6a95,
+        0x447cd5a9, 0x15ef7110, 0xa57c2d5e, 0x2e5d61f4,
+        0x613d3217, 0x4ff52cce, 0xafe3f5e1, 0x696f8e30,
+        0x1ef051f7, 0x006e298c, 0xb97f1d14, 0xa920a3e8,
+    },
+};
+#endif
 #elif MCUBOOT_SIGN_RSA_LEN == 3072
 #define HAVE_KEYS
 const unsigned char root_pub_der[] = {
@@ -105,6 +153,70 @@ const unsigned char root_pub_der[] = {
     0x3b, 0x02, 0x03, 0x01, 0x00, 0x01,
 };
 const unsigned int root_pub_der_len = 398;
+const unsigned char root_pub_der_hash[] = {
+    0x44, 0x97, 0x93, 0xfb, 0x65, 0xcd, 0x76, 0x98,
+    0x75, 0x3d, 0x5b, 0x3f, 0x35, 0xfa, 0xb1, 0x5f,
+    0x1e, 0x3a, 0x45, 0x11, 0x1f, 0xf2, 0x4e, 0x1d,
+    0x46, 0x74, 0x1d, 0xe5, 0xae, 0x12, 0xd5, 0x9e,
+};
+const unsigned int root_pub_der_hash_len = 32;
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+const struct bootutil_rsa_pub_key root_pub_der_preparsed = {
+    .n0inv = 0x8a1ab50d,
+    .n = {
+        0xe673de3b, 0x6374ac5a, 0x2daf9366, 0xb57bd3b0,
+        0x6e886591, 0x8a18cf23, 0xd99f0717, 0xb565dd01,
+        0x2b0ef881, 0xf55fafe7, 0x0162fff7, 0x060a81f3,
+        0x6d8c4374, 0xad01cab7, 0x4a05751f, 0xe69df40c,
+        0x23305736, 0x52e89637, 0xf7fa65dd, 0xa0a094c8,
+        0x1f0dd01e, 0xcf150880, 0xac2a22f4, 0x5985ee85,
+        0x5872a4b0, 0x99bfac68, 0x019ce70c, 0xb0f3f683,
+        0xb1517c12, 0x1d1bff1a, 0xd1ea1a40, 0x06eedcbe,
+        0xa77eda87, 0x6a7751eb, 0xa4094fa5, 0x768c6b94,
+        0x1122fb7f, 0xe819fd2f, 0x5b82e77a, 0x9a6fcbbb,
+        0xe7cac4f8, 0xb37cc3fb, 0x6f7babb7, 0xb2aa5a6c,
+        0x30089c4d, 0x4485cc73, 0xd473338d, 0x936cd7bf,
+        0xcea4a8ca, 0x25f88dbe, 0x8e87ee60, 0x51665e99,
+        0xada7f63a, 0x9be41ce8, 0x96edcfb3, 0x131b172e,
+        0xa8ba7a80, 0xb69acde5, 0x226c5e61, 0x671fc86e,
+        0x78e5be47, 0xd3b4cc2f, 0x2502aa00, 0x4e68b2e0,
+        0x7e9c9bba, 0xd24e570c, 0xadc2e1a5, 0x6fd1154f,
+        0xa72b1325, 0x04da8c34, 0x76dd5f54, 0x36804938,
+        0xf949db78, 0x6ecc85ed, 0xf91000d8, 0x72463f8b,
+        0x5cfd7305, 0xad870083, 0xb8a71d44, 0x7e72d37a,
+        0x574bde0f, 0x8c229e71, 0xf4ef2a8f, 0x15688c1a,
+        0x8173bf6e, 0x228b2d4e, 0xaaa68a63, 0xea7bb115,
+        0x25e5d296, 0x45c87126, 0x1a34205d, 0x3433f896,
+        0xdd082a28, 0x58997c01, 0x5810a4a7, 0xb42c0e98,
+    },
+    .rr = {
+        0xa04638d4, 0x3a879048, 0x7ca61b2d, 0xe0dd6259,
+        0x55123fc5, 0x2ef5deec, 0x9ac7688c, 0x8a5bb339,
+        0x04083dcf, 0xfba082e4, 0xf5bd5f21, 0x3bc0bb80,
+        0x0508b168, 0xd326e831, 0x1a3e396d, 0x00bf7fe1,
+        0xc536bc01, 0x42b332aa, 0xfe4cab9d, 0x7d5a6a66,
+        0x032bca90, 0xa5a3c4a7, 0xb729a6a8, 0x2d602549,
+        0xd5bc2223, 0x3187a304, 0x4af6e591, 0x9bdbafc1,
+        0xf13c6f69, 0xb9734cc0, 0x6655e882, 0x9d2fb3b0,
+        0xd3102df5, 0x33cd4027, 0x94e72bb3, 0x7c55230a,
+        0x9ab167b2, 0x1d4fedc3, 0xd8a83c6f, 0x54ec8329,
+        0xd5eeb4d1, 0xed2a7bec, 0x91db40c5, 0x16d3274a,
+        0xdc805893, 0xbbb2332b, 0x1868df5b, 0xcd0b6e0a,
+        0x798003c8, 0x84f4f932, 0xb098e8d7, 0x498fc166,
+        0xaeefc41f, 0xf000fe77, 0x93c44eee, 0x95bcfe91,
+        0x60f5867d, 0x07a09792, 0x238701a7, 0x0e499545,
+        0x3e9d92e1, 0xbb075158, 0x54715f22, 0xf7726675,
+        0x47489602, 0x4e2c2bea, 0xd14cbd50, 0xbd60e1fb,
+        0x82da2bec, 0x997052d1, 0x7e2762df, 0x85aa9f1c,
+        0xaf38710c, 0x14a5c5c5, 0xd61e9416, 0xf991dbbc,
+        0xc3d2506c, 0x9dc4db1b, 0xc77bb7fe, 0x4a34329a,
+        0x2b966e7b, 0xd30b11c5, 0xeb1328d3, 0xb239db53,
+        0x8a8295d9, 0x29598798, 0x504c872d, 0x65fa9b83,
+        0x184b19fc, 0xb1db1fcf, 0x43751595, 0x3d4338f5,
+        0x62862673, 0x0717ef99, 0xa6d2f092, 0x0b940021,
+    },
+};
+#endif
 #endif
 #elif defined(MCUBOOT_SIGN_EC256) || \
       defined(MCUBOOT_SIGN_EC384)
@@ -124,6 +236,13 @@ const unsigned char root_pub_der[] = {
     0x8b, 0x68, 0x34, 0xcc, 0x3a, 0x6a, 0xfc, 0x53,
     0x8e, 0xfa, 0xc1, };
 const unsigned int root_pub_der_len = 91;
+const unsigned char root_pub_der_hash[] = {
+    0xe3, 0x04, 0x66, 0xf6, 0xb8, 0x47, 0x0c, 0x1f,
+    0x29, 0x07, 0x0b, 0x17, 0xf1, 0xe2, 0xd3, 0xe9,
+    0x4d, 0x44, 0x5e, 0x3f, 0x60, 0x80, 0x87, 0xfd,
+    0xc7, 0x11, 0xe4, 0x38, 0x2b, 0xb5, 0x38, 0xb6,
+};
+const unsigned int root_pub_der_hash_len = 32;
 #else /* MCUBOOT_SIGN_EC384 */
 const unsigned char root_pub_der[] = {
     0x30, 0x76, 0x30, 0x10, 0x06, 0x07, 0x2a, 0x86,
@@ -143,6 +262,15 @@ const unsigned char root_pub_der[] = {
     0xa8, 0xf2, 0x48, 0xfe, 0x3a, 0x60, 0x69, 0xa5,
 };
 const unsigned int root_pub_der_len = 120;
+const unsigned char root_pub_der_hash[] = {
+    0x85, 0xb7, 0xbd, 0x5f, 0x5d, 0xff, 0x9a, 0x03,
+    0xa9, 0x99, 0x27, 0xad, 0xaf, 0x6c, 0xa6, 0xfe,
+    0xbd, 0xe8, 0x22, 0xc1, 0xa4, 0x80, 0x92, 0x83,
+    0x24, 0xa8, 0xe6, 0x03, 0x23, 0x71, 0x5c, 0x57,
+    0x79, 0x46, 0x1c, 0x49, 0x6a, 0x95, 0xae, 0xe8,
+    0xc4, 0xf9, 0x0b, 0x99, 0x77, 0x9f, 0x84, 0x8a,
+};
+const unsigned int root_pub_der_hash_len = 48;
 #endif /* MCUBOOT_SIGN_EC384 */
 #elif defined(MCUBOOT_SIGN_ED25519)
 #define HAVE_KEYS
@@ -155,6 +283,13 @@ const unsigned char root_pub_der[] = {
     0x20, 0xff, 0xb4, 0xe0,
 };
 const unsigned int root_pub_der_len = 44;
+const unsigned char root_pub_der_hash[] = {
+    0xc1, 0x90, 0x7f, 0xa4, 0xea, 0xc7, 0xfa, 0xe3,
+    0x84, 0x0a, 0x78, 0x90, 0x2b, 0x6f, 0x07, 0x10,
+    0xb0, 0x37, 0xe9, 0x96, 0x8e, 0x5c, 0x62, 0x74,
+    0xa1, 0x2a, 0x28, 0x79, 0x0c, 0x7d, 0x4e, 0x3c,
+};
+const unsigned int root_pub_der_hash_len = 32;
 #endif
 
 #if defined(HAVE_KEYS)
@@ -162,6 +297,13 @@ const struct bootutil_key bootutil_keys[] = {
     {
         .key = root_pub_der,
         .len = &root_pub_der_len,
+#ifdef MCUBOOT_KEY_HASH_TABLE
+        .hash = root_pub_der_hash,
+        .hash_len = &root_pub_der_hash_len,
+#endif
+#ifdef MCUBOOT_RSA_PREPARSED_KEYS
+        .rsa = &root_pub_der_preparsed,
+#endif
     },
 };
 const int bootutil_key_cnt = 1;
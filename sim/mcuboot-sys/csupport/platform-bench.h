@@ -0,0 +1,26 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef H_SIM_BENCH_H__
+#define H_SIM_BENCH_H__
+
+#include <inttypes.h>
+#include <stdint.h>
+#include "bootutil/bootutil_log.h"
+
+typedef uint32_t bench_state_t;
+
+/* Nanoseconds of the monotonic clock, see run.c. */
+uint32_t plat_bench_cycles(void);
+
+#define plat_bench_start(_s) do { \
+    *(_s) = plat_bench_cycles(); \
+} while (0)
+
+#define plat_bench_stop(_s) do { \
+    uint32_t _stop_time = plat_bench_cycles(); \
+    BOOT_LOG_INF("bench: %" PRIu32 " ns", _stop_time - *(_s)); \
+} while (0)
+
+#endif /* not H_SIM_BENCH_H__ */
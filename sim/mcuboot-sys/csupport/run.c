@@ -1,10 +1,20 @@
 /* Run the boot image. */
 
+/* For clock_gettime(), the simulator is built with -std=c99. */
+#define _POSIX_C_SOURCE 199309L
+
+/* This file implements the flash_area_*() functions counted by
+ * MCUBOOT_FLASH_STATS. */
+#define BOOT_FLASH_STATS_NO_WRAP
+
 #include <assert.h>
+#include <inttypes.h>
 #include <setjmp.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <bootutil/bootutil.h>
 #include <bootutil/image.h>
 
@@ -45,6 +55,15 @@ extern int sim_flash_write(uint8_t flash_id, uint32_t offset, const uint8_t *src
         uint32_t size);
 extern uint32_t sim_flash_align(uint8_t flash_id);
 extern uint8_t sim_flash_erased_val(uint8_t flash_id);
+extern bool sim_flash_erase_required(uint8_t flash_id);
+
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+static void sim_async_read_report(void);
+#endif
+
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+extern void sim_crypto_offload_drain(void);
+#endif
 
 struct sim_context {
     int flash_counter;
@@ -232,6 +251,11 @@ uint8_t flash_area_erased_val(const struct flash_area *area)
     return sim_flash_erased_val(area->fa_device_id);
 }
 
+bool flash_area_erase_required(const struct flash_area *area)
+{
+    return sim_flash_erase_required(area->fa_device_id);
+}
+
 struct area {
     struct flash_area whole;
     struct flash_area *areas;
@@ -275,12 +299,18 @@ int invoke_boot_go(struct sim_context *ctx, struct area_desc *adesc,
 #endif /* BOOT_IMAGE_NUMBER > 1 */
 
         res = context_boot_go(state, rsp);
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+        sim_async_read_report();
+#endif
         sim_reset_flash_areas();
         sim_reset_context();
         free(state);
         /* printf("boot_go off: %d (0x%08x)\n", res, rsp.br_image_off); */
         return res;
     } else {
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+        sim_async_read_report();
+#endif
         sim_reset_flash_areas();
         sim_reset_context();
         free(state);
@@ -288,6 +318,26 @@ int invoke_boot_go(struct sim_context *ctx, struct area_desc *adesc,
     }
 }
 
+#ifdef MCUBOOT_FLASH_STATS
+/*
+ * Copies the flash accounting of operation `op` on area `fa_id`, during the
+ * last boot run by the calling thread, to `out`.
+ *
+ * Returns 0 on success, -1 if the area was not accessed.
+ */
+int sim_flash_stats_get(uint8_t fa_id, int op, struct boot_flash_op_stats *out)
+{
+    const struct boot_flash_area_stats *st = boot_flash_stats_get(fa_id);
+
+    if (st == NULL || op < 0 || op >= BOOT_FLASH_OP_MAX) {
+        return -1;
+    }
+
+    *out = st->ops[op];
+    return 0;
+}
+#endif
+
 void *os_malloc(size_t size)
 {
     // printf("os_malloc 0x%x bytes\n", size);
@@ -342,6 +392,101 @@ int flash_area_read(const struct flash_area *area, uint32_t off, void *dst,
     return sim_flash_read(area->fa_device_id, area->fa_off + off, dst, len);
 }
 
+#if defined(MCUBOOT_FLASH_AREA_ASYNC_READ) || defined(MCUBOOT_USE_BENCH)
+static uint64_t sim_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#ifdef MCUBOOT_USE_BENCH
+/* The simulator has no cycle counter, its benchmarks count nanoseconds. */
+uint32_t plat_bench_cycles(void)
+{
+    return (uint32_t)sim_now_ns();
+}
+#endif
+
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+/*
+ * Models a flash controller that reads in the background: the data is copied
+ * straight away, but is only considered available once a latency of
+ * SIM_ASYNC_READ_SETUP_NS plus SIM_ASYNC_READ_NS_PER_BYTE per byte has
+ * elapsed since the start. Waiting before that busy-waits, and the time
+ * spent doing so is accounted as stall, so the overlap achieved by the caller
+ * shows up as the difference between the modeled latency and the stall.
+ */
+#define SIM_ASYNC_READ_SETUP_NS     2000
+#define SIM_ASYNC_READ_NS_PER_BYTE  20
+
+struct sim_async_read {
+    const struct flash_area *area;
+    uint64_t ready_ns;
+    int rc;
+
+    uint32_t reads;
+    uint64_t latency_ns;
+    uint64_t stall_ns;
+};
+
+static __thread struct sim_async_read sim_async_read;
+
+int flash_area_read_start(const struct flash_area *area, uint32_t off,
+                          void *dst, uint32_t len)
+{
+    struct sim_async_read *ar = &sim_async_read;
+    uint64_t latency_ns;
+
+    BOOT_LOG_SIM("%s: area=%d, off=%x, len=%x",
+                 __func__, area->fa_id, off, len);
+    assert(ar->area == NULL);
+
+    latency_ns = SIM_ASYNC_READ_SETUP_NS +
+                 (uint64_t)len * SIM_ASYNC_READ_NS_PER_BYTE;
+
+    ar->area = area;
+    ar->ready_ns = sim_now_ns() + latency_ns;
+    ar->rc = sim_flash_read(area->fa_device_id, area->fa_off + off, dst, len);
+    ar->reads++;
+    ar->latency_ns += latency_ns;
+    return 0;
+}
+
+int flash_area_read_wait(const struct flash_area *area)
+{
+    struct sim_async_read *ar = &sim_async_read;
+    uint64_t now;
+
+    assert(ar->area == area);
+    ar->area = NULL;
+
+    now = sim_now_ns();
+    if (now < ar->ready_ns) {
+        ar->stall_ns += ar->ready_ns - now;
+        while (sim_now_ns() < ar->ready_ns) {
+        }
+    }
+
+    return ar->rc;
+}
+
+static void sim_async_read_report(void)
+{
+    struct sim_async_read *ar = &sim_async_read;
+
+    if (ar->reads != 0) {
+        BOOT_LOG_INF("async reads: %u, latency %" PRIu64 " us, "
+                     "stalled %" PRIu64 " us",
+                     (unsigned)ar->reads, ar->latency_ns / 1000,
+                     ar->stall_ns / 1000);
+    }
+    memset(ar, 0, sizeof(*ar));
+}
+#endif /* MCUBOOT_FLASH_AREA_ASYNC_READ */
+
 int flash_area_write(const struct flash_area *area, uint32_t off, const void *src,
                      uint32_t len)
 {
@@ -350,6 +495,9 @@ int flash_area_write(const struct flash_area *area, uint32_t off, const void *sr
     struct sim_context *ctx = sim_get_context();
     if (--(ctx->flash_counter) == 0) {
         ctx->jumped++;
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+        sim_crypto_offload_drain();
+#endif
         longjmp(ctx->boot_jmpbuf, 1);
     }
     return sim_flash_write(area->fa_device_id, area->fa_off + off, src, len);
@@ -362,6 +510,9 @@ int flash_area_erase(const struct flash_area *area, uint32_t off, uint32_t len)
     struct sim_context *ctx = sim_get_context();
     if (--(ctx->flash_counter) == 0) {
         ctx->jumped++;
+#ifdef MCUBOOT_CRYPTO_OFFLOAD
+        sim_crypto_offload_drain();
+#endif
         longjmp(ctx->boot_jmpbuf, 1);
     }
     return sim_flash_erase(area->fa_device_id, area->fa_off + off, len);
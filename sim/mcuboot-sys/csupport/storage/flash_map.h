@@ -42,6 +42,7 @@ extern "C" {
  * and match the target offset specified in download script.
  */
 #include <inttypes.h>
+#include <stdbool.h>
 
 /**
  * @brief Structure describing an area on a flash device.
@@ -120,6 +121,16 @@ int flash_area_write(const struct flash_area *, uint32_t off, const void *src,
   uint32_t len);
 int flash_area_erase(const struct flash_area *, uint32_t off, uint32_t len);
 
+#ifdef MCUBOOT_FLASH_AREA_ASYNC_READ
+/*
+ * Split read: start a read, then wait for it to complete. At most one read
+ * per flash area is outstanding, `dst` is only valid after the wait.
+ */
+int flash_area_read_start(const struct flash_area *, uint32_t off, void *dst,
+  uint32_t len);
+int flash_area_read_wait(const struct flash_area *);
+#endif
+
 /*
  * Alignment restriction for flash writes.
  */
@@ -130,6 +141,11 @@ uint32_t flash_area_align(const struct flash_area *);
  */
 uint8_t flash_area_erased_val(const struct flash_area *);
 
+/*
+ * Whether the device has to be erased before it is written.
+ */
+bool flash_area_erase_required(const struct flash_area *);
+
 /*
  * Given flash area ID, return info about sectors within the area.
  */
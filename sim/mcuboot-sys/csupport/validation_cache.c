@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Copyright (c) 2024 Alif Semiconductor
+ */
+
+#include "bootutil/validation_cache.h"
+
+/*
+ * Since the simulator is executing unit tests in parallel,
+ * the storage area where the cache entries reside has to be
+ * managed per thread from Rust's side.
+ */
+#ifdef MCUBOOT_VALIDATION_CACHE
+
+int sim_validation_cache_load(uint32_t image_index, uint8_t *entry,
+                              uint32_t len);
+
+int sim_validation_cache_store(uint32_t image_index, const uint8_t *entry,
+                               uint32_t len);
+
+/* Stands in for the device unique key. */
+static const uint8_t sim_validation_cache_key[32] = {
+    0x6d, 0x63, 0x75, 0x62, 0x6f, 0x6f, 0x74, 0x2d,
+    0x73, 0x69, 0x6d, 0x2d, 0x76, 0x61, 0x6c, 0x69,
+    0x64, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2d, 0x63,
+    0x61, 0x63, 0x68, 0x65, 0x2d, 0x6b, 0x65, 0x79,
+};
+
+int boot_validation_cache_load(uint32_t image_id,
+                               struct boot_validation_cache *entry)
+{
+    return sim_validation_cache_load(image_id, (uint8_t *)entry,
+                                     sizeof(*entry));
+}
+
+int boot_validation_cache_store(uint32_t image_id,
+                                const struct boot_validation_cache *entry)
+{
+    return sim_validation_cache_store(image_id, (const uint8_t *)entry,
+                                      sizeof(*entry));
+}
+
+int boot_validation_cache_get_key(const uint8_t **key, uint32_t *key_len)
+{
+    *key = sim_validation_cache_key;
+    *key_len = sizeof(sim_validation_cache_key);
+
+    return 0;
+}
+
+#endif /* MCUBOOT_VALIDATION_CACHE */
@@ -23,6 +23,7 @@ pub type FlashMap = HashMap<u8, FlashPtr>;
 pub struct FlashParamsStruct {
     align: u32,
     erased_val: u8,
+    erase_required: bool,
 }
 
 pub type FlashParams = HashMap<u8, FlashParamsStruct>;
@@ -153,11 +154,38 @@ impl NvCounterStorage {
     }
 }
 
+/// This struct stores the validation cache entries per image, as opaque bytes, along with the
+/// number of entries stored and cleared.  It will be stored per test thread, and the C code will
+/// load / store the entries here.
+#[derive(Debug, Default)]
+pub struct ValidationCacheStorage {
+    pub entries: Vec<Vec<u8>>,
+    pub stores: usize,
+    pub clears: usize,
+}
+
+impl ValidationCacheStorage {
+    pub fn new() -> Self {
+        let count = if cfg!(feature = "multiimage") {
+            2
+        } else {
+            1
+        };
+        Self {
+            entries: vec![vec![]; count],
+            stores: 0,
+            clears: 0,
+        }
+    }
+}
+
 thread_local! {
     pub static THREAD_CTX: RefCell<FlashContext> = RefCell::new(FlashContext::new());
     pub static SIM_CTX: RefCell<CSimContextPtr> = RefCell::new(CSimContextPtr::new());
     pub static RAM_CTX: RefCell<BootsimRamInfo> = RefCell::new(BootsimRamInfo::default());
     pub static NV_COUNTER_CTX: RefCell<NvCounterStorage> = RefCell::new(NvCounterStorage::new());
+    pub static VALIDATION_CACHE_CTX: RefCell<ValidationCacheStorage> =
+        RefCell::new(ValidationCacheStorage::new());
 }
 
 /// Set the flash device to be used by the simulation.  The pointer is unsafely stashed away.
@@ -171,6 +199,7 @@ pub fn set_flash(dev_id: u8, dev: &mut dyn Flash) {
         ctx.borrow_mut().flash_params.insert(dev_id, FlashParamsStruct {
             align: dev.align() as u32,
             erased_val: dev.erased_val(),
+            erase_required: dev.erase_required(),
         });
         unsafe {
             let dev: &'static mut dyn Flash = mem::transmute(dev);
@@ -308,6 +337,13 @@ pub extern fn sim_flash_erased_val(id: u8) -> u8 {
     })
 }
 
+#[no_mangle]
+pub extern fn sim_flash_erase_required(id: u8) -> bool {
+    THREAD_CTX.with(|ctx| {
+        ctx.borrow().flash_params.get(&id).unwrap().erase_required
+    })
+}
+
 fn map_err(err: Result<()>) -> libc::c_int {
     match err {
         Ok(()) => 0,
@@ -376,3 +412,45 @@ pub extern "C" fn sim_get_nv_counter_for_image(image_index: u32, security_counte
     });
     return rc;
 }
+
+/// Read the validation cache entry of an image.  An entry that was never stored reads as zeroes,
+/// which the bootloader takes as no entry.
+#[no_mangle]
+pub extern "C" fn sim_validation_cache_load(image_index: u32, entry: *mut u8, len: u32) -> libc::c_int {
+    let mut rc = 0;
+    VALIDATION_CACHE_CTX.with(|ctx| {
+        let cache = ctx.borrow();
+        if image_index as usize >= cache.entries.len() {
+            rc = -1;
+            return;
+        }
+        let buf: &mut [u8] = unsafe { slice::from_raw_parts_mut(entry, len as usize) };
+        let stored = &cache.entries[image_index as usize];
+        buf.fill(0);
+        let n = stored.len().min(buf.len());
+        buf[..n].copy_from_slice(&stored[..n]);
+    });
+    rc
+}
+
+/// Store the validation cache entry of an image.  An entry of zeroes is how the bootloader
+/// invalidates it, and is counted as a clear.
+#[no_mangle]
+pub extern "C" fn sim_validation_cache_store(image_index: u32, entry: *const u8, len: u32) -> libc::c_int {
+    let mut rc = 0;
+    VALIDATION_CACHE_CTX.with(|ctx| {
+        let mut cache = ctx.borrow_mut();
+        if image_index as usize >= cache.entries.len() {
+            rc = -1;
+            return;
+        }
+        let buf: &[u8] = unsafe { slice::from_raw_parts(entry, len as usize) };
+        if buf.iter().all(|&b| b == 0) {
+            cache.clears += 1;
+        } else {
+            cache.stores += 1;
+        }
+        cache.entries[image_index as usize] = buf.to_vec();
+    });
+    rc
+}
@@ -165,6 +165,68 @@ pub fn get_security_counter(image_index: u32) -> u32 {
     return counter_val;
 }
 
+/// Forget all the validation cache entries, and the counts of stores and clears.
+pub fn reset_validation_cache() {
+    api::VALIDATION_CACHE_CTX.with(|ctx| {
+        *ctx.borrow_mut() = api::ValidationCacheStorage::new();
+    });
+}
+
+/// Drop the validation cache entry of an image, the way a writer of the primary slot other than
+/// the bootloader must.  This is not counted as a clear.
+pub fn drop_validation_cache(image_index: usize) {
+    api::VALIDATION_CACHE_CTX.with(|ctx| {
+        ctx.borrow_mut().entries[image_index].clear();
+    });
+}
+
+/// Return the number of validation cache entries stored and cleared by the bootloader.
+pub fn validation_cache_counts() -> (usize, usize) {
+    api::VALIDATION_CACHE_CTX.with(|ctx| {
+        let cache = ctx.borrow();
+        (cache.stores, cache.clears)
+    })
+}
+
+/// The flash accounting of one type of operation on one flash area, as kept by
+/// `boot/bootutil/src/flash_stats.c`.
+#[repr(C)]
+#[derive(Debug, Default, Clone)]
+pub struct FlashOpStats {
+    /// Time spent in the calls, in `plat_bench_cycles()` units.
+    pub cycles: u64,
+    pub calls: u32,
+    pub errors: u32,
+    pub bytes: u32,
+    /// Bucket i counts the requests of 2^i to 2^(i+1) - 1 bytes.
+    pub size_hist: [u32; 13],
+    /// Bucket i counts the requests at offsets aligned to 2^i but not 2^(i+1).
+    pub align_hist: [u32; 13],
+}
+
+#[derive(Debug, Clone, Copy)]
+pub enum FlashOp {
+    Read = 0,
+    Write = 1,
+    Erase = 2,
+}
+
+/// The flash accounting of `op` on the flash area `area_id` during the last `boot_go` of this
+/// thread, or None if the area was not accessed or the accounting is not built in.
+#[cfg(feature = "flash-stats")]
+pub fn flash_stats(area_id: u8, op: FlashOp) -> Option<FlashOpStats> {
+    let mut stats = FlashOpStats::default();
+    match unsafe { raw::sim_flash_stats_get(area_id, op as libc::c_int, &mut stats) } {
+        0 => Some(stats),
+        _ => None,
+    }
+}
+
+#[cfg(not(feature = "flash-stats"))]
+pub fn flash_stats(_area_id: u8, _op: FlashOp) -> Option<FlashOpStats> {
+    None
+}
+
 mod raw {
     use crate::area::CAreaDesc;
     use crate::api::{BootRsp, CSimContext};
@@ -189,6 +251,10 @@ mod raw {
         pub fn kw_encrypt_(kek: *const u8, seckey: *const u8,
                            encbuf: *mut u8) -> libc::c_int;
 
+        #[cfg(feature = "flash-stats")]
+        pub fn sim_flash_stats_get(fa_id: u8, op: libc::c_int,
+                                   out: *mut super::FlashOpStats) -> libc::c_int;
+
         #[allow(unused)]
         pub fn psa_crypto_init() -> u32;
 
@@ -7,6 +7,9 @@
 //!
 //! This module is capable of simulating the type of NOR flash commonly used in microcontrollers.
 //! These generally can be written as individual bytes, but must be erased in larger units.
+//!
+//! It can also model the MRAM found on Alif devices, which is programmed in 16-byte lines that
+//! can be overwritten in place, and has no physical erase.
 
 mod pdump;
 
@@ -66,6 +69,10 @@ pub trait Flash {
 
     fn align(&self) -> usize;
     fn erased_val(&self) -> u8;
+
+    /// Whether the device has to be erased before it is written, as reported to a bootloader
+    /// built with `MCUBOOT_SUPPORT_DEV_WITHOUT_ERASE`.
+    fn erase_required(&self) -> bool;
 }
 
 fn ebounds<T: AsRef<str>>(message: T) -> FlashError {
@@ -82,6 +89,19 @@ fn esimulatedwrite<T: AsRef<str>>(message: T) -> FlashError {
     FlashError::SimulatedFail(message.as_ref().to_owned())
 }
 
+/// The size of an MRAM line, which is the unit MRAM is programmed in.
+pub const MRAM_LINE_SIZE: usize = 16;
+
+/// Counters of the line programs issued to an MRAM device.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct LineStats {
+    /// Number of lines programmed.
+    pub programmed: usize,
+    /// Number of those lines that already held the data written to them.  A backend built with
+    /// `MCUBOOT_MRAM_SKIP_UNCHANGED_LINES` does not program these.
+    pub unchanged: usize,
+}
+
 /// An emulated flash device.  It is represented as a block of bytes, and a list of the sector
 /// mappings.
 #[derive(Clone)]
@@ -94,6 +114,8 @@ pub struct SimFlash {
     align: usize,
     verify_writes: bool,
     erased_val: u8,
+    // Present when the device models MRAM rather than NOR flash.
+    mram_stats: Option<LineStats>,
 }
 
 impl SimFlash {
@@ -112,9 +134,28 @@ impl SimFlash {
             align,
             verify_writes: true,
             erased_val,
+            mram_stats: None,
         }
     }
 
+    /// Construct an MRAM device with the given sector size map.  MRAM reads as 0x00 when erased,
+    /// and accepts writes of any size at any offset: partial lines are read, merged with the new
+    /// data and programmed back, the same as the Alif flash map backend does.  The sectors are
+    /// only the units the bootloader is told about, erasing works on any range of whole lines,
+    /// and the device reports that it does not have to be erased before it is written.  The write
+    /// alignment reported to the bootloader is the line size, as on the device.
+    pub fn new_mram(sectors: Vec<usize>) -> SimFlash {
+        let mut flash = SimFlash::new(sectors, MRAM_LINE_SIZE, 0);
+        assert!(flash.data.len() % MRAM_LINE_SIZE == 0);
+        flash.mram_stats = Some(LineStats::default());
+        flash
+    }
+
+    /// Return the line program counters of an MRAM device, or None for NOR flash.
+    pub fn line_stats(&self) -> Option<LineStats> {
+        self.mram_stats
+    }
+
     #[allow(dead_code)]
     pub fn dump(&self) {
         self.data.dump();
@@ -141,6 +182,32 @@ impl SimFlash {
         None
     }
 
+    // Program the MRAM lines covering `payload`.  Every line touched is read back, merged with
+    // the new data and programmed as a whole.
+    fn mram_program(&mut self, offset: usize, payload: &[u8]) {
+        let end = offset + payload.len();
+        let mut stats = self.mram_stats.unwrap_or_default();
+        let mut line = offset & !(MRAM_LINE_SIZE - 1);
+
+        while line < end {
+            let lo = line.max(offset);
+            let hi = (line + MRAM_LINE_SIZE).min(end);
+            let mut buf = [0u8; MRAM_LINE_SIZE];
+
+            buf.copy_from_slice(&self.data[line .. line + MRAM_LINE_SIZE]);
+            buf[lo - line .. hi - line].copy_from_slice(&payload[lo - offset .. hi - offset]);
+
+            if buf[..] == self.data[line .. line + MRAM_LINE_SIZE] {
+                stats.unchanged += 1;
+            }
+            stats.programmed += 1;
+
+            self.data[line .. line + MRAM_LINE_SIZE].copy_from_slice(&buf);
+            line += MRAM_LINE_SIZE;
+        }
+
+        self.mram_stats = Some(stats);
+    }
 }
 
 pub type SimMultiFlash = HashMap<u8, SimFlash>;
@@ -149,7 +216,24 @@ impl Flash for SimFlash {
     /// The flash drivers tend to erase beyond the bounds of the given range.  Instead, we'll be
     /// strict, and make sure that the passed arguments are exactly at a sector boundary, otherwise
     /// return an error.
+    ///
+    /// MRAM has no sectors to speak of, so there erasing only has to cover whole lines, and is
+    /// done by programming the range with the erased value.  A bootloader that knows
+    /// the device needs no erase only erases the trailer and the image magic this way.
     fn erase(&mut self, offset: usize, len: usize) -> Result<()> {
+        if self.mram_stats.is_some() {
+            if offset + len > self.data.len() {
+                bail!(ebounds("Erase outside of device"));
+            }
+            if (offset | len) & (MRAM_LINE_SIZE - 1) != 0 {
+                bail!(ebounds("erase not aligned to the MRAM line size"));
+            }
+
+            let erased = vec![self.erased_val; len];
+            self.mram_program(offset, &erased);
+            return Ok(());
+        }
+
         let (_start, slen) = self.get_sector(offset).ok_or_else(|| ebounds("start"))?;
         let (end, elen) = self.get_sector(offset + len - 1).ok_or_else(|| ebounds("end"))?;
 
@@ -179,6 +263,8 @@ impl Flash for SimFlash {
     /// This emulates a flash device which starts out erased, with the
     /// added restriction that repeated writes to the same location
     /// are disallowed, even if they would be safe to do.
+    ///
+    /// MRAM has none of these restrictions.
     fn write(&mut self, offset: usize, payload: &[u8]) -> Result<()> {
         for &(off, len, rate) in &self.bad_region {
             if offset >= off && (offset + payload.len()) <= (off + len) {
@@ -195,6 +281,11 @@ impl Flash for SimFlash {
             panic!("Write outside of device");
         }
 
+        if self.mram_stats.is_some() {
+            self.mram_program(offset, payload);
+            return Ok(());
+        }
+
         // Verify the alignment (which must be a power of two).
         if offset & (self.align - 1) != 0 {
             panic!("Misaligned write address");
@@ -267,6 +358,10 @@ impl Flash for SimFlash {
     fn erased_val(&self) -> u8 {
         self.erased_val
     }
+
+    fn erase_required(&self) -> bool {
+        self.mram_stats.is_none()
+    }
 }
 
 /// It is possible to iterate over the sectors in the device, each element returning this.
@@ -306,7 +401,7 @@ impl<'a> Iterator for SectorIter<'a> {
 
 #[cfg(test)]
 mod test {
-    use super::{Flash, FlashError, SimFlash, Result, Sector};
+    use super::{Flash, FlashError, LineStats, MRAM_LINE_SIZE, SimFlash, Result, Sector};
 
     #[test]
     fn test_flash() {
@@ -322,6 +417,44 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_mram() {
+        let mut f1 = SimFlash::new_mram(vec![1024usize; 128]);
+        test_device(&mut f1, 0);
+
+        let mut f2 = SimFlash::new_mram(vec![1024usize; 4]);
+        let mut buf = [0xAA; 48];
+
+        // Lines are overwritten in place, without an erase in between, and a partial line
+        // keeps the bytes around it.
+        f2.write(0, &[0x11; 32]).unwrap();
+        f2.write(8, &[0x22; 16]).unwrap();
+        f2.read(0, &mut buf).unwrap();
+        assert!(buf[..8].iter().all(|&x| x == 0x11));
+        assert!(buf[8..24].iter().all(|&x| x == 0x22));
+        assert!(buf[24..32].iter().all(|&x| x == 0x11));
+        assert!(buf[32..].iter().all(|&x| x == 0));
+        assert_eq!(f2.line_stats(), Some(LineStats { programmed: 4, unchanged: 0 }));
+
+        // Rewriting the same data still programs the line.
+        f2.write(0, &[0x11; 8]).unwrap();
+        assert_eq!(f2.line_stats(), Some(LineStats { programmed: 5, unchanged: 1 }));
+
+        // Erasing only needs to cover whole lines, which are not sectors.
+        assert_eq!(f2.align(), MRAM_LINE_SIZE);
+        assert!(f2.erase(0, 8).is_bounds());
+        assert!(f2.erase(8, 16).is_bounds());
+        f2.erase(16, 16).unwrap();
+        f2.read(0, &mut buf).unwrap();
+        assert!(buf[..8].iter().all(|&x| x == 0x11));
+        assert!(buf[16..].iter().all(|&x| x == 0));
+        assert_eq!(f2.line_stats(), Some(LineStats { programmed: 6, unchanged: 1 }));
+
+        assert!(!f2.erase_required());
+        assert!(SimFlash::new(vec![1024usize; 4], 1, 0).erase_required());
+        assert_eq!(SimFlash::new(vec![1024usize; 4], 1, 0).line_stats(), None);
+    }
+
     fn test_device(flash: &mut dyn Flash, erased_val: u8) {
         let sectors: Vec<Sector> = flash.sector_iter().collect();
 
@@ -30,6 +30,12 @@ pub enum Caps {
     DirectXip            = (1 << 17),
     HwRollbackProtection = (1 << 18),
     EcdsaP384            = (1 << 19),
+    SwapUsingOffset      = (1 << 20),
+    OverwriteResume      = (1 << 21),
+    OverwriteDiff        = (1 << 22),
+    DeltaUpgrade         = (1 << 23),
+    DecompressImages     = (1 << 24),
+    ValidationCache      = (1 << 25),
 }
 
 impl Caps {
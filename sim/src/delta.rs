@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Alif Semiconductor
+//
+// SPDX-License-Identifier: Apache-2.0
+
+//! Patches of delta images, as made by imgtool, see scripts/imgtool/delta.py.
+//!
+//! A patch is a sequence of records, each made of the number of bytes to copy from the base, the
+//! number of bytes to insert from the patch, the zigzag encoded move of the base position after
+//! the copy, and the bytes to insert.  The target is written over the base window by window, so a
+//! copy to window k may only read the base from the start of window k on.
+
+use std::collections::HashMap;
+
+/// The length of the blocks indexed to find matches, and the shortest match used.
+const BLOCK_SIZE: usize = 8;
+
+fn push_leb128(out: &mut Vec<u8>, mut val: u32) {
+    loop {
+        let byte = (val & 0x7f) as u8;
+        val >>= 7;
+        if val == 0 {
+            out.push(byte);
+            return;
+        }
+        out.push(byte | 0x80);
+    }
+}
+
+fn zigzag(val: i64) -> u32 {
+    if val >= 0 {
+        (val as u32) << 1
+    } else {
+        (((-val - 1) as u32) << 1) | 1
+    }
+}
+
+fn match_len(base: &[u8], target: &[u8], q: usize, p: usize, window: usize) -> usize {
+    let mut n = 0;
+    while p + n < target.len() && q + n < base.len() && base[q + n] == target[p + n] &&
+        q + n >= (p + n) / window * window
+    {
+        n += 1;
+    }
+    n
+}
+
+fn push_record(out: &mut Vec<u8>, copy: usize, literal: &[u8], seek: i64) {
+    push_leb128(out, copy as u32);
+    push_leb128(out, literal.len() as u32);
+    push_leb128(out, zigzag(seek));
+    out.extend_from_slice(literal);
+}
+
+/// Make a patch turning `base` into `target`, written `window` bytes at a time.
+pub fn make_patch(base: &[u8], target: &[u8], window: usize) -> Vec<u8> {
+    let mut index: HashMap<&[u8], usize> = HashMap::new();
+    for q in 0 .. base.len().saturating_sub(BLOCK_SIZE - 1) {
+        index.insert(&base[q .. q + BLOCK_SIZE], q);
+    }
+
+    let mut patch = vec![];
+    let mut copy_off = 0;
+    let mut copy_len = 0;
+    let mut literal_start = 0;
+    let mut shift: i64 = 0;
+    let mut p = 0;
+    while p < target.len() {
+        let mut best = (0, 0);
+        let mut candidates = vec![];
+        if p as i64 + shift >= 0 {
+            candidates.push((p as i64 + shift) as usize);
+        }
+        if p + BLOCK_SIZE <= target.len() {
+            if let Some(&q) = index.get(&target[p .. p + BLOCK_SIZE]) {
+                candidates.push(q);
+            }
+        }
+        for q in candidates {
+            let n = match_len(base, target, q, p, window);
+            if n > best.1 {
+                best = (q, n);
+            }
+        }
+        if best.1 < BLOCK_SIZE {
+            p += 1;
+            continue;
+        }
+
+        push_record(&mut patch, copy_len, &target[literal_start .. p],
+                    best.0 as i64 - (copy_off + copy_len) as i64);
+        copy_off = best.0;
+        copy_len = best.1;
+        shift = best.0 as i64 - p as i64;
+        p += best.1;
+        literal_start = p;
+    }
+    push_record(&mut patch, copy_len, &target[literal_start ..], 0);
+
+    patch
+}
@@ -37,13 +37,15 @@ use cipher::{
     StreamCipher,
     };
 
-use simflash::{Flash, SimFlash, SimMultiFlash};
+use simflash::{Flash, SimFlash, SimMultiFlash, MRAM_LINE_SIZE};
 use mcuboot_sys::{c, AreaDesc, FlashId, RamBlock};
 use crate::{
     ALL_DEVICES,
     DeviceName,
 };
 use crate::caps::Caps;
+use crate::delta;
+use crate::lz4;
 use crate::depends::{
     BoringDep,
     Depender,
@@ -53,7 +55,7 @@ use crate::depends::{
     PairDep,
     UpgradeInfo,
 };
-use crate::tlv::{ManifestGen, TlvGen, TlvFlags};
+use crate::tlv::{ManifestGen, TlvGen, TlvFlags, TlvKinds};
 use crate::utils::align_up;
 use typenum::{U32, U16};
 
@@ -61,6 +63,12 @@ use typenum::{U32, U16};
 /// properly, but the value is not really that important.
 const RAM_LOAD_ADDR: u32 = 1024;
 
+/// The window size of delta images, which is the largest the bootloader supports by default.
+const DELTA_WINDOW_SIZE: usize = 4096;
+
+/// The window size of compressed images, which is the largest the bootloader supports by default.
+const DECOMPRESS_WINDOW_SIZE: usize = 4096;
+
 /// A builder for Images.  This describes a single run of the simulator,
 /// capturing the configuration of a particular set of devices, including
 /// the flash simulator(s) and the information about the slots.
@@ -141,6 +149,16 @@ impl ImagesBuilder {
     /// Some(builder) if is possible to test this configuration, or None if
     /// not possible (for example, if there aren't enough image slots).
     pub fn new(device: DeviceName, align: usize, erased_val: u8) -> Result<Self, String> {
+        if matches!(device, DeviceName::AlifMram) && erased_val != 0 {
+            return Err("MRAM only erases to 0x00".to_string());
+        }
+        // MRAM is always written in whole lines, so it is run once, with a BOOT_MAX_ALIGN that
+        // holds a line as on the device.
+        if matches!(device, DeviceName::AlifMram) &&
+                (align < MRAM_LINE_SIZE || c::boot_max_align() < MRAM_LINE_SIZE) {
+            return Err(format!("MRAM needs a write alignment of {}", MRAM_LINE_SIZE));
+        }
+
         let (flash, areadesc, unsupported_caps) = Self::make_device(device, align, erased_val);
 
         for cap in unsupported_caps {
@@ -176,11 +194,21 @@ impl ImagesBuilder {
 
             let offset_from_end = c::boot_magic_sz() + c::boot_max_align() * 4;
 
+            // With swap using offset, an upgrade image is written one sector
+            // into the secondary slot.
+            let secondary_image_off = if Caps::SwapUsingOffset.present() {
+                let dev = flash.get(&secondary_dev_id).unwrap();
+                dev.sector_iter().next().unwrap().size
+            } else {
+                0
+            };
+
             // Construct a primary image.
             let primary = SlotInfo {
                 base_off: primary_base as usize,
                 trailer_off: primary_base + primary_len - offset_from_end,
                 len: primary_len as usize,
+                image_off: 0,
                 dev_id: primary_dev_id,
                 index: 0,
             };
@@ -190,6 +218,7 @@ impl ImagesBuilder {
                 base_off: secondary_base as usize,
                 trailer_off: secondary_base + secondary_len - offset_from_end,
                 len: secondary_len as usize,
+                image_off: secondary_image_off,
                 dev_id: secondary_dev_id,
                 index: 1,
             };
@@ -432,6 +461,120 @@ impl ImagesBuilder {
         }
     }
 
+    /// Construct an `Images` whose secondary slots hold delta images against the images in the
+    /// primary slots, or against other images if `wrong_base` is set.  Configurations that can't
+    /// apply delta images get no upgrade and no flash operation count.
+    pub fn make_delta_image(self, wrong_base: bool) -> Images {
+        let encrypted = TlvFlags::ENCRYPTED_AES128 as u32 | TlvFlags::ENCRYPTED_AES256 as u32;
+        // Each sector of the primary slots has to be within a window.
+        let fits_windows = self.slots.iter().all(|slots| {
+            let slot = &slots[0];
+            let dev = self.flash.get(&slot.dev_id).unwrap();
+            dev.sector_iter()
+                .filter(|sect| sect.base >= slot.base_off && sect.base < slot.base_off + slot.len)
+                .all(|sect| {
+                    let off = sect.base - slot.base_off;
+                    off / DELTA_WINDOW_SIZE == (off + sect.size - 1) / DELTA_WINDOW_SIZE
+                })
+        });
+        if !Caps::DeltaUpgrade.present() || (make_tlv().get_flags() & encrypted) != 0 ||
+            !fits_windows
+        {
+            return self.make_no_upgrade_image(&NO_DEPS, ImageManipulation::None);
+        }
+
+        let mut flash = self.flash;
+        let ram = self.ram.clone(); // TODO: Avoid this clone.
+        let images = self.slots.into_iter().enumerate().map(|(image_num, slots)| {
+            let dep = BoringDep::new(image_num, &NO_DEPS);
+            let mut other = flash.clone();
+            let primaries = install_image(&mut flash, &slots[0],
+                maximal(42784), &ram, &dep, ImageManipulation::None, Some(0));
+            let base = if wrong_base {
+                let image = install_image(&mut other, &slots[0],
+                    maximal(42000), &ram, &dep, ImageManipulation::None, Some(0));
+                image.plain[..image.size].to_vec()
+            } else {
+                primaries.plain[..primaries.size].to_vec()
+            };
+            let upgrades = install_delta_image(&mut flash, &slots[1], &base, &dep);
+            OneImage {
+                slots,
+                primaries,
+                upgrades,
+            }}).collect();
+        install_ptable(&mut flash, &self.areadesc);
+        let mut images = Images {
+            flash,
+            areadesc: self.areadesc,
+            images,
+            total_count: None,
+            ram: self.ram,
+        };
+        for image in &images.images {
+            mark_upgrade(&mut images.flash, &image.slots[1]);
+        }
+
+        // Upgrades without fails, counts the number of flash operations.
+        let total_count = if wrong_base {
+            0
+        } else {
+            match images.run_basic_upgrade(true) {
+                Some(v) => v,
+                None => panic!("Unable to apply the delta images"),
+            }
+        };
+        images.total_count = Some(total_count);
+        images
+    }
+
+    /// Construct an `Images` whose secondary slots hold compressed images, or, if `bad_hash` is
+    /// set, compressed images whose hash TLV doesn't match what they decompress to.
+    /// Configurations that can't decompress images get no upgrade and no flash operation count.
+    pub fn make_compressed_image(self, bad_hash: bool) -> Images {
+        let encrypted = TlvFlags::ENCRYPTED_AES128 as u32 | TlvFlags::ENCRYPTED_AES256 as u32;
+        if !Caps::DecompressImages.present() || (make_tlv().get_flags() & encrypted) != 0 {
+            return self.make_no_upgrade_image(&NO_DEPS, ImageManipulation::None);
+        }
+
+        let mut flash = self.flash;
+        let ram = self.ram.clone(); // TODO: Avoid this clone.
+        let images = self.slots.into_iter().enumerate().map(|(image_num, slots)| {
+            let dep = BoringDep::new(image_num, &NO_DEPS);
+            let primaries = install_image(&mut flash, &slots[0],
+                maximal(42784), &ram, &dep, ImageManipulation::None, Some(0));
+            let upgrades = install_compressed_image(&mut flash, &slots[1], 42784, &dep,
+                                                    bad_hash);
+            OneImage {
+                slots,
+                primaries,
+                upgrades,
+            }}).collect();
+        install_ptable(&mut flash, &self.areadesc);
+        let mut images = Images {
+            flash,
+            areadesc: self.areadesc,
+            images,
+            total_count: None,
+            ram: self.ram,
+        };
+        for image in &images.images {
+            mark_upgrade(&mut images.flash, &image.slots[1]);
+        }
+
+        // Upgrades without fails, counts the number of flash operations.
+        let total_count = if bad_hash {
+            0
+        } else {
+            match images.run_basic_upgrade(true) {
+                Some(v) => v,
+                None => panic!("Unable to decompress the images"),
+            }
+        };
+        images.total_count = Some(total_count);
+        images
+    }
+
     /// Build the Flash and area descriptor for a given device.
     pub fn make_device(device: DeviceName, align: usize, erased_val: u8) -> (SimMultiFlash, AreaDesc, &'static [Caps]) {
         match device {
@@ -454,7 +597,7 @@ impl ImagesBuilder {
 
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
-                (flash, areadesc, &[Caps::SwapUsingMove])
+                (flash, areadesc, &[Caps::SwapUsingMove, Caps::SwapUsingOffset])
             }
             DeviceName::K64f => {
                 // NXP style flash.  Small sectors, one small sector for scratch.
@@ -485,7 +628,10 @@ impl ImagesBuilder {
 
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
-                (flash, areadesc, &[Caps::SwapUsingMove])
+                // Each slot is a single sector, which leaves no room for the image next to the
+                // trailer when overwrite upgrades are resumable.
+                (flash, areadesc, &[Caps::SwapUsingMove, Caps::SwapUsingOffset,
+                                    Caps::OverwriteResume, Caps::DeltaUpgrade])
             }
             DeviceName::Nrf52840 => {
                 // Simulating the flash on the nrf52840 with partitions set up so that the scratch size
@@ -514,7 +660,24 @@ impl ImagesBuilder {
 
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
-                (flash, areadesc, &[Caps::SwapUsingScratch, Caps::OverwriteUpgrade])
+                (flash, areadesc, &[Caps::SwapUsingScratch, Caps::OverwriteUpgrade,
+                                    Caps::SwapUsingOffset])
+            }
+            DeviceName::Nrf52840UnequalSlotsLargerSlot1 => {
+                // The layout preferred by swap using offset: the secondary slot is one sector
+                // larger than the primary slot.
+                let dev = SimFlash::new(vec![4096; 128], align as usize, erased_val);
+
+                let dev_id = 0;
+                let mut areadesc = AreaDesc::new();
+                areadesc.add_flash_sectors(dev_id, &dev);
+                areadesc.add_image(0x008000, 0x03b000, FlashId::Image0, dev_id);
+                areadesc.add_image(0x043000, 0x03c000, FlashId::Image1, dev_id);
+
+                let mut flash = SimMultiFlash::new();
+                flash.insert(dev_id, dev);
+                (flash, areadesc, &[Caps::SwapUsingScratch, Caps::OverwriteUpgrade,
+                                    Caps::SwapUsingMove])
             }
             DeviceName::Nrf52840SpiFlash => {
                 // Simulate nrf52840 with external SPI flash. The external SPI flash
@@ -533,7 +696,7 @@ impl ImagesBuilder {
                 let mut flash = SimMultiFlash::new();
                 flash.insert(0, dev0);
                 flash.insert(1, dev1);
-                (flash, areadesc, &[Caps::SwapUsingMove])
+                (flash, areadesc, &[Caps::SwapUsingMove, Caps::SwapUsingOffset])
             }
             DeviceName::K64fMulti => {
                 // NXP style flash, but larger, to support multiple images.
@@ -548,6 +711,23 @@ impl ImagesBuilder {
                 areadesc.add_image(0x080000, 0x020000, FlashId::Image2, dev_id);
                 areadesc.add_image(0x0a0000, 0x020000, FlashId::Image3, dev_id);
 
+                let mut flash = SimMultiFlash::new();
+                flash.insert(dev_id, dev);
+                (flash, areadesc, &[])
+            }
+            DeviceName::AlifMram => {
+                // Alif style MRAM.  Programmed in 16-byte lines that can be overwritten in place,
+                // and reported to the bootloader as 1 KiB logical sectors with a write alignment
+                // of a line, matching `boot/alif/flash/flash_map_mram.c`.
+                let dev = SimFlash::new_mram(vec![1024; 512]);
+
+                let dev_id = 0;
+                let mut areadesc = AreaDesc::new();
+                areadesc.add_flash_sectors(dev_id, &dev);
+                areadesc.add_image(0x020000, 0x020000, FlashId::Image0, dev_id);
+                areadesc.add_image(0x040000, 0x020000, FlashId::Image1, dev_id);
+                areadesc.add_image(0x060000, 0x001000, FlashId::ImageScratch, dev_id);
+
                 let mut flash = SimMultiFlash::new();
                 flash.insert(dev_id, dev);
                 (flash, areadesc, &[])
@@ -569,6 +749,8 @@ impl Images {
     pub fn run_basic_upgrade(&self, permanent: bool) -> Option<i32> {
         let (flash, total_count) = self.try_upgrade(None, permanent);
         info!("Total flash operation count={}", total_count);
+        log_line_programs(&self.flash, &flash);
+        log_flash_stats();
 
         if !self.verify_images(&flash, 0, 1) {
             warn!("Image mismatch after first boot");
@@ -656,7 +838,8 @@ impl Images {
     }
 
     fn is_swap_upgrade(&self) -> bool {
-        Caps::SwapUsingScratch.present() || Caps::SwapUsingMove.present()
+        Caps::SwapUsingScratch.present() || Caps::SwapUsingMove.present() ||
+            Caps::SwapUsingOffset.present()
     }
 
     pub fn run_basic_revert(&self) -> bool {
@@ -733,9 +916,23 @@ impl Images {
 
         let mut fails = 0;
         let total_flash_ops = self.total_count.unwrap();
-        let (flash, total_counts) = self.try_random_fails(total_flash_ops, total_fails);
+        let (flash, total_counts, last_count) = self.try_random_fails(total_flash_ops, total_fails);
         info!("Random interruptions at reset points={:?}", total_counts);
 
+        if Caps::OverwriteResume.present() {
+            // The operation a reset hits is not performed.  Each reset may only make the
+            // upgrade redo the sector being copied when it happened.
+            let done_ops = total_counts.iter().map(|c| c - 1).sum::<i32>() + last_count;
+            let redone_ops = done_ops - total_flash_ops;
+            let allowed_ops = total_fails as i32 * self.max_sector_copy_ops();
+            info!("Flash operations redone after resets: {}", redone_ops);
+            if redone_ops > allowed_ops {
+                error!("Upgrade redid {} flash operations after {} resets, at most {} expected",
+                       redone_ops, total_fails, allowed_ops);
+                fails += 1;
+            }
+        }
+
         let primary_slot_ok = self.verify_images(&flash, 0, 1);
         let secondary_slot_ok = if self.is_swap_upgrade() {
             // TODO: This result is ignored.
@@ -768,6 +965,134 @@ impl Images {
         fails > 0
     }
 
+    /// Upgrade to the same images a second time.  With sector-diff overwrite
+    /// upgrades, the primary slot already holds them, so only a small part
+    /// of the flash operations of the first upgrade should be done again.
+    pub fn run_same_image_upgrade(&self) -> bool {
+        if !Caps::OverwriteDiff.present() {
+            return false;
+        }
+
+        // Encrypted images are always copied in full.
+        if self.images.iter().any(|image| image.upgrades.cipher.is_some()) {
+            return false;
+        }
+
+        let mut fails = 0;
+        let total_flash_ops = self.total_count.unwrap();
+
+        let mut secondaries = self.flash.clone();
+        self.mark_permanent_upgrades(&mut secondaries, 1);
+
+        let (mut flash, _) = self.try_upgrade(None, true);
+
+        // Install the same upgrades again.
+        for image in &self.images {
+            let slot = &image.slots[1];
+            let mut buf = vec![0u8; slot.len];
+            secondaries.get(&slot.dev_id).unwrap().read(slot.base_off, &mut buf).unwrap();
+            let dev = flash.get_mut(&slot.dev_id).unwrap();
+            dev.erase(slot.base_off, slot.len).unwrap();
+            dev.write(slot.base_off, &buf).unwrap();
+        }
+
+        let mut counter = 0;
+        if !c::boot_go(&mut flash, &self.areadesc, Some(&mut counter), None, false).success() {
+            warn!("Failed second upgrade");
+            fails += 1;
+        }
+
+        let flash_ops = -counter;
+        info!("Flash operations: first upgrade={}, same upgrade={}",
+              total_flash_ops, flash_ops);
+
+        // Both upgrades record every sector in the progress journal.
+        let journal_ops = if Caps::OverwriteResume.present() {
+            self.primary_sector_count()
+        } else {
+            0
+        };
+        if (flash_ops - journal_ops) * 4 > total_flash_ops - journal_ops {
+            error!("Upgrade to the same images did {} of {} flash operations",
+                   flash_ops, total_flash_ops);
+            fails += 1;
+        }
+
+        if !self.verify_images(&flash, 0, 1) {
+            error!("Image mismatch after the same upgrade");
+            fails += 1;
+        }
+
+        fails > 0
+    }
+
+    /// Apply delta images, interrupted at each of the flash operations in turn.
+    pub fn run_delta_upgrade(&self) -> bool {
+        if !Caps::DeltaUpgrade.present() || self.total_count.is_none() {
+            return false;
+        }
+
+        self.run_perm_with_fails()
+    }
+
+    /// Boot with delta images made against other images than the ones in the primary slots.
+    /// They must be erased, leaving the primary slots alone.
+    pub fn run_delta_wrong_base(&self) -> bool {
+        if !Caps::DeltaUpgrade.present() || self.total_count.is_none() {
+            return false;
+        }
+
+        self.run_rejected_upgrade("delta image against another image")
+    }
+
+    /// Decompress images, interrupted at each of the flash operations in turn.
+    pub fn run_compressed_upgrade(&self) -> bool {
+        if !Caps::DecompressImages.present() || self.total_count.is_none() {
+            return false;
+        }
+
+        self.run_perm_with_fails()
+    }
+
+    /// Boot with compressed images that don't decompress to the image they were signed with.
+    /// They must be erased, leaving the primary slots alone.
+    pub fn run_compressed_bad_hash(&self) -> bool {
+        if !Caps::DecompressImages.present() || self.total_count.is_none() {
+            return false;
+        }
+
+        self.run_rejected_upgrade("compressed image with a bad hash")
+    }
+
+    /// Boot with upgrades that pass their signature check but must be rejected before the
+    /// primary slots are touched, and check that they are erased.
+    fn run_rejected_upgrade(&self, what: &str) -> bool {
+        let mut fails = 0;
+        let mut flash = self.flash.clone();
+        if !c::boot_go(&mut flash, &self.areadesc, None, None, false).success() {
+            warn!("Failed to boot with a {}", what);
+            fails += 1;
+        }
+
+        if !self.verify_images(&flash, 0, 0) {
+            warn!("Primary slot changed by a {}", what);
+            fails += 1;
+        }
+
+        for image in &self.images {
+            let slot = &image.slots[1];
+            let mut magic = [0u8; 4];
+            flash.get(&slot.dev_id).unwrap()
+                .read(slot.base_off + slot.image_off, &mut magic).unwrap();
+            if u32::from_le_bytes(magic) == make_tlv().get_magic() {
+                warn!("The {} was left in the secondary slot", what);
+                fails += 1;
+            }
+        }
+
+        fails > 0
+    }
+
     pub fn run_revert_with_fails(&self) -> bool {
         if Caps::OverwriteUpgrade.present() || !Caps::modifies_flash() {
             return false;
@@ -1346,6 +1671,102 @@ impl Images {
         false
     }
 
+    /// Boot the images twice, the second time from their validation cache entries.  Then rewrite
+    /// the payload of the primary slots only, keeping the headers and TLVs, and drop the entries
+    /// the way any other writer of the slots must.  The next boot must validate the images in
+    /// full, and reject them.
+    pub fn run_validation_cache(&self) -> bool {
+        if !Caps::ValidationCache.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+        let num_images = self.images.len();
+
+        c::reset_validation_cache();
+
+        for boot in 0 .. 2 {
+            if !c::boot_go(&mut flash, &self.areadesc, None, None, false).success() {
+                warn!("Failed boot {}", boot);
+                fails += 1;
+            }
+            // Only the first boot stores the entries.
+            if c::validation_cache_counts() != (num_images, 0) {
+                warn!("Unexpected validation cache stores/clears {:?} after boot {}",
+                      c::validation_cache_counts(), boot);
+                fails += 1;
+            }
+        }
+
+        for (image_num, image) in self.images.iter().enumerate() {
+            let slot = &image.slots[0];
+            let dev = flash.get_mut(&slot.dev_id).unwrap();
+            let align = dev.align();
+            let off = (slot.base_off + slot.image_off + image.primaries.size / 2) & !(align - 1);
+            let mut buf = vec![0u8; align];
+            dev.read(off, &mut buf).unwrap();
+            buf[0] ^= 0xff;
+            dev.set_verify_writes(false);
+            dev.write(off, &buf).unwrap();
+            dev.set_verify_writes(true);
+            c::drop_validation_cache(image_num);
+        }
+
+        let result = c::boot_go(&mut flash, &self.areadesc, None, None, false);
+        if Caps::Bootstrap.present() {
+            // The primary slots are restored from the secondary ones instead.
+            if !result.success() || !self.verify_images(&flash, 0, 1) {
+                warn!("Failed to bootstrap over images with a rewritten payload");
+                fails += 1;
+            }
+        } else if result.success() {
+            warn!("Booted images with a rewritten payload");
+            fails += 1;
+        }
+
+        fails > 0
+    }
+
+    /// Upgrade images whose validation is cached.  The upgrade must clear the entries before it
+    /// writes the primary slots, and the new images be cached after their validation.
+    pub fn run_validation_cache_upgrade(&self) -> bool {
+        if !Caps::ValidationCache.present() {
+            return false;
+        }
+
+        let mut flash = self.flash.clone();
+        let mut fails = 0;
+        let num_images = self.images.len();
+
+        c::reset_validation_cache();
+
+        if !c::boot_go(&mut flash, &self.areadesc, None, None, false).success() {
+            warn!("Failed first boot");
+            fails += 1;
+        }
+
+        for image in &self.images {
+            mark_upgrade(&mut flash, &image.slots[1]);
+        }
+
+        if !c::boot_go(&mut flash, &self.areadesc, None, None, false).success() {
+            warn!("Failed to boot the upgrade");
+            fails += 1;
+        }
+        if !self.verify_images(&flash, 0, 1) {
+            warn!("Image mismatch after the upgrade");
+            fails += 1;
+        }
+        if c::validation_cache_counts() != (2 * num_images, num_images) {
+            warn!("Unexpected validation cache stores/clears {:?} after the upgrade",
+                  c::validation_cache_counts());
+            fails += 1;
+        }
+
+        fails > 0
+    }
+
     pub fn run_ram_load_boot_with_result(&self, expected_result: bool) -> bool {
         if !Caps::RamLoad.present() {
             return false;
@@ -1548,7 +1969,9 @@ impl Images {
     }
 
 
-    fn try_random_fails(&self, total_ops: i32, count: usize) -> (SimMultiFlash, Vec<i32>) {
+    /// Returns the flash after the upgrade, the reset points, and the number of flash
+    /// operations of the last, uninterrupted, boot.
+    fn try_random_fails(&self, total_ops: i32, count: usize) -> (SimMultiFlash, Vec<i32>, i32) {
         let mut flash = self.flash.clone();
 
         self.mark_permanent_upgrades(&mut flash, 1);
@@ -1568,20 +1991,54 @@ impl Images {
             *reset = reset_counter;
         }
 
-        match c::boot_go(&mut flash, &self.areadesc, None, None, false) {
+        let mut counter = 0;
+        match c::boot_go(&mut flash, &self.areadesc, Some(&mut counter), None, false) {
             x if x.interrupted() => panic!("Should not be have been interrupted!"),
             x if x.success() => (),
             x => panic!("Unknown return: {:?}", x),
         }
 
-        (flash, resets)
+        (flash, resets, -counter)
+    }
+
+    /// The largest number of flash operations that copying one sector of a primary slot
+    /// takes in an overwrite upgrade with progress journal: erasing the sector, writing it
+    /// 1 KiB at a time, and recording it.  Three more cover starting the journal: erasing
+    /// the trailer, and writing the image hash and the copy size.
+    fn max_sector_copy_ops(&self) -> i32 {
+        self.images.iter().map(|image| {
+            let slot = &image.slots[0];
+            let dev = self.flash.get(&slot.dev_id).unwrap();
+            dev.sector_iter()
+                .filter(|sect| sect.base >= slot.base_off && sect.base < slot.base_off + slot.len)
+                .map(|sect| (sect.size + 1023) / 1024 + 5)
+                .max()
+                .unwrap() as i32
+        }).max().unwrap()
+    }
+
+    /// The number of sectors in the primary slots of all images.
+    fn primary_sector_count(&self) -> i32 {
+        self.images.iter().map(|image| {
+            let slot = &image.slots[0];
+            let dev = self.flash.get(&slot.dev_id).unwrap();
+            dev.sector_iter()
+                .filter(|sect| sect.base >= slot.base_off && sect.base < slot.base_off + slot.len)
+                .count() as i32
+        }).sum()
     }
 
     /// Verify the image in the given flash device, the specified slot
     /// against the expected image.
     fn verify_images(&self, flash: &SimMultiFlash, slot: usize, against: usize) -> bool {
         self.images.iter().all(|image| {
-            verify_image(flash, &image.slots[slot],
+            // After a swap using offset, the image from the primary slot is
+            // stored at the beginning of the secondary slot.
+            let mut slot_info = image.slots[slot].clone();
+            if against == 0 {
+                slot_info.image_off = 0;
+            }
+            verify_image(flash, &slot_info,
                          match against {
                              0 => &image.primaries,
                              1 => &image.upgrades,
@@ -1703,6 +2160,37 @@ fn show_flash(flash: &dyn Flash) {
     println!();
 }
 
+/// Log the MRAM line programs it took to go from `before` to `after`, so the cost of the
+/// different upgrade strategies can be compared.
+fn log_line_programs(before: &SimMultiFlash, after: &SimMultiFlash) {
+    for (dev_id, dev) in after {
+        let then = before.get(dev_id).and_then(|d| d.line_stats());
+        if let (Some(now), Some(then)) = (dev.line_stats(), then) {
+            info!("Device {} MRAM line programs={}, unchanged={}", dev_id,
+                  now.programmed - then.programmed, now.unchanged - then.unchanged);
+        }
+    }
+}
+
+/// Log the flash accounting of the last boot, when it is built in, so the number and size of
+/// the flash requests of the different upgrade strategies can be compared.
+fn log_flash_stats() {
+    let areas = [FlashId::Image0, FlashId::Image1, FlashId::ImageScratch,
+                 FlashId::Image2, FlashId::Image3];
+    let ops = [c::FlashOp::Read, c::FlashOp::Write, c::FlashOp::Erase];
+
+    for area in areas {
+        for op in ops {
+            if let Some(st) = c::flash_stats(area as u8, op) {
+                // Requests of less than 32 bytes, typically trailer and TLV accesses.
+                let small: u32 = st.size_hist[..5].iter().sum();
+                info!("Area {:?} {:?}: calls={}, bytes={}, small={}, ns={}",
+                      area, op, st.calls, st.bytes, small, st.cycles);
+            }
+        }
+    }
+}
+
 #[derive(Debug)]
 enum ImageSize {
     /// Make the image the specified given size.
@@ -1729,11 +2217,13 @@ fn tralier_estimation(dev: &dyn Flash) -> usize {
 fn image_largest_trailer(dev: &dyn Flash) -> usize {
             // Using the header size we know, the trailer size, and the slot size, we can compute
             // the largest image possible.
-            let trailer = if Caps::OverwriteUpgrade.present() {
+            let trailer = if Caps::OverwriteUpgrade.present() && !Caps::OverwriteResume.present() &&
+                    !Caps::DeltaUpgrade.present() {
                 // This computation is incorrect, and we need to figure out the correct size.
                 // c::boot_status_sz(dev.align() as u32) as usize
                 16 + 4 * dev.align()
-            } else if Caps::SwapUsingMove.present() {
+            } else if Caps::SwapUsingMove.present() || Caps::SwapUsingOffset.present() ||
+                    Caps::OverwriteResume.present() || Caps::DeltaUpgrade.present() {
                 let sector_size = dev.sector_iter().next().unwrap().size as u32;
                 align_up(c::boot_trailer_sz(dev.align() as u32), sector_size) as usize
             } else if Caps::SwapUsingScratch.present() {
@@ -1752,6 +2242,8 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
                  deps: &dyn Depender, img_manipulation: ImageManipulation, security_counter:Option<u32>) -> ImageData {
     let offset = slot.base_off;
     let slot_len = slot.len;
+    let image_off = offset + slot.image_off;
+    let image_len = slot_len - slot.image_off;
     let dev_id = slot.dev_id;
     let dev = flash.get_mut(&dev_id).unwrap();
 
@@ -1787,8 +2279,8 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
             let trailer = image_largest_trailer(dev);
             let tlv_len = tlv.estimate_size();
             info!("slot: 0x{:x}, HDR: 0x{:x}, trailer: 0x{:x}",
-                slot_len, HDR_SIZE, trailer);
-            slot_len - HDR_SIZE - trailer - tlv_len
+                image_len, HDR_SIZE, trailer);
+            image_len - HDR_SIZE - trailer - tlv_len
         },
         ImageSize::Oversized => {
             let trailer = image_largest_trailer(dev);
@@ -1797,7 +2289,7 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
                 slot_len, HDR_SIZE, trailer);
             // the overflow size is rougly estimated to work for all
             // configurations. It might be precise if tlv_len will be maked precise.
-            slot_len - HDR_SIZE - trailer - tlv_len + dev.align()*4
+            image_len - HDR_SIZE - trailer - tlv_len + dev.align()*4
         }
 
     };
@@ -1901,10 +2393,10 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
         let enc_copy: Option<Vec<u8>>;
 
         if is_encrypted {
-            dev.write(offset, &encbuf).unwrap();
+            dev.write(image_off, &encbuf).unwrap();
 
             let mut enc = vec![0u8; encbuf.len()];
-            dev.read(offset, &mut enc).unwrap();
+            dev.read(image_off, &mut enc).unwrap();
 
             enc_copy = Some(enc);
 
@@ -1913,10 +2405,10 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
             enc_copy = None;
         }
 
-        dev.write(offset, &buf).unwrap();
+        dev.write(image_off, &buf).unwrap();
 
         let mut copy = vec![0u8; buf.len()];
-        dev.read(offset, &mut copy).unwrap();
+        dev.read(image_off, &mut copy).unwrap();
 
         ImageData {
             size: image_sz,
@@ -1925,20 +2417,20 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
         }
     } else {
 
-        dev.write(offset, &buf).unwrap();
+        dev.write(image_off, &buf).unwrap();
 
         let mut copy = vec![0u8; buf.len()];
-        dev.read(offset, &mut copy).unwrap();
+        dev.read(image_off, &mut copy).unwrap();
 
         let enc_copy: Option<Vec<u8>>;
 
         if is_encrypted {
             dev.erase(offset, slot_len).unwrap();
 
-            dev.write(offset, &encbuf).unwrap();
+            dev.write(image_off, &encbuf).unwrap();
 
             let mut enc = vec![0u8; encbuf.len()];
-            dev.read(offset, &mut enc).unwrap();
+            dev.read(image_off, &mut enc).unwrap();
 
             enc_copy = Some(enc);
         } else {
@@ -1953,6 +2445,188 @@ fn install_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: ImageSize,
     }
 }
 
+/// Build the image a delta image turns `base` into: the payload of `base` with a few bytes
+/// changed, inserted and removed, signed with the version of an upgrade.
+fn make_delta_target(base: &[u8], slot: &SlotInfo, deps: &dyn Depender) -> Vec<u8> {
+    let hdr_size = u16::from_le_bytes([base[8], base[9]]) as usize;
+    let img_size = u32::from_le_bytes([base[12], base[13], base[14], base[15]]) as usize;
+    let mut body = base[hdr_size .. hdr_size + img_size].to_vec();
+    for i in (1000 .. body.len()).step_by(5000) {
+        body[i] ^= 0xff;
+    }
+    body.splice(8000 .. 8000, vec![0x5a; 200]);
+    body.drain(20000 .. 20300);
+
+    make_signed_image(&body, hdr_size, slot, deps)
+}
+
+/// Build a signed image holding `body`, with the version of an upgrade.
+fn make_signed_image(body: &[u8], hdr_size: usize, slot: &SlotInfo,
+                     deps: &dyn Depender) -> Vec<u8> {
+    let mut tlv: Box<dyn ManifestGen> = Box::new(make_tlv());
+    tlv.set_security_counter(Some(0));
+
+    let header = ImageHeader {
+        magic: tlv.get_magic(),
+        load_addr: 0,
+        hdr_size: hdr_size as u16,
+        protect_tlv_size: tlv.protect_size(),
+        img_size: body.len() as u32,
+        flags: tlv.get_flags(),
+        ver: deps.my_version(slot.base_off, slot.index),
+        _pad2: 0,
+    };
+
+    let mut buf = header.as_raw().to_vec();
+    buf.resize(hdr_size, 0);
+    buf.extend_from_slice(body);
+    tlv.add_bytes(&buf);
+    buf.append(&mut tlv.make_tlv());
+    buf
+}
+
+/// Return the hash TLV of an image.
+fn image_hash_tlv(image: &[u8]) -> Vec<u8> {
+    let hdr_size = u16::from_le_bytes([image[8], image[9]]) as usize;
+    let protect_size = u16::from_le_bytes([image[10], image[11]]) as usize;
+    let img_size = u32::from_le_bytes([image[12], image[13], image[14], image[15]]) as usize;
+    let mut off = hdr_size + img_size + protect_size;
+    let end = off + u16::from_le_bytes([image[off + 2], image[off + 3]]) as usize;
+    off += 4;
+    while off < end {
+        let kind = u16::from_le_bytes([image[off], image[off + 1]]);
+        let len = u16::from_le_bytes([image[off + 2], image[off + 3]]) as usize;
+        off += 4;
+        if kind == TlvKinds::SHA256 as u16 || kind == TlvKinds::SHA384 as u16 {
+            return image[off .. off + len].to_vec();
+        }
+        off += len;
+    }
+    panic!("Image without a hash TLV");
+}
+
+/// Install a delta image turning `base` into a new image.  Returns the new image, which is
+/// what the primary slot holds after the upgrade.
+fn install_delta_image(flash: &mut SimMultiFlash, slot: &SlotInfo, base: &[u8],
+                       deps: &dyn Depender) -> ImageData {
+    const HDR_SIZE: usize = 32;
+    let dev = flash.get_mut(&slot.dev_id).unwrap();
+
+    let target = make_delta_target(base, slot, deps);
+    let patch = delta::make_patch(base, &target, DELTA_WINDOW_SIZE);
+    info!("Delta patch of {:#x} bytes for an image of {:#x}", patch.len(), target.len());
+
+    let mut tlv: Box<dyn ManifestGen> = Box::new(make_tlv());
+    tlv.set_security_counter(Some(0));
+    tlv.set_delta(&image_hash_tlv(base), &image_hash_tlv(&target), target.len() as u32,
+                  DELTA_WINDOW_SIZE as u32);
+
+    let header = ImageHeader {
+        magic: tlv.get_magic(),
+        load_addr: 0,
+        hdr_size: HDR_SIZE as u16,
+        protect_tlv_size: tlv.protect_size(),
+        img_size: patch.len() as u32,
+        flags: tlv.get_flags(),
+        ver: deps.my_version(slot.base_off, slot.index),
+        _pad2: 0,
+    };
+
+    let mut buf = header.as_raw().to_vec();
+    buf.extend_from_slice(&patch);
+    tlv.add_bytes(&buf);
+    buf.append(&mut tlv.make_tlv());
+
+    let align = dev.align();
+    while buf.len() % align != 0 {
+        buf.push(dev.erased_val());
+    }
+    dev.write(slot.base_off + slot.image_off, &buf).unwrap();
+
+    // The last window is padded to the write alignment.
+    let image_sz = target.len();
+    let mut plain = target;
+    while plain.len() % align != 0 {
+        plain.push(dev.erased_val());
+    }
+
+    ImageData {
+        size: image_sz,
+        plain,
+        cipher: None,
+    }
+}
+
+/// Install a compressed image holding a new image of `len` bytes of payload.  Returns the new
+/// image, which is what the primary slot holds after the upgrade.  With `bad_hash`, the hash TLV
+/// of the compressed image is not the one of the new image.
+fn install_compressed_image(flash: &mut SimMultiFlash, slot: &SlotInfo, len: usize,
+                            deps: &dyn Depender, bad_hash: bool) -> ImageData {
+    const HDR_SIZE: usize = 32;
+    let dev = flash.get_mut(&slot.dev_id).unwrap();
+
+    // Firmware compresses, random data doesn't: mostly use a few words.
+    let words: [&[u8]; 4] = [b"mcuboot", &[0; 8], &[0xff; 6], &[0x01, 0x20, 0x00, 0x4b]];
+    let mut rng = rand::thread_rng();
+    let mut body = vec![];
+    while body.len() < len {
+        if rng.gen_bool(0.2) {
+            body.push(rng.gen());
+        } else {
+            body.extend_from_slice(words[rng.gen_range(0 .. words.len())]);
+        }
+    }
+    body.truncate(len);
+
+    let image = make_signed_image(&body, HDR_SIZE, slot, deps);
+    let block = lz4::compress_block(&image, DECOMPRESS_WINDOW_SIZE);
+    info!("Compressed an image of {:#x} bytes to {:#x}", image.len(), block.len());
+
+    let mut image_hash = image_hash_tlv(&image);
+    if bad_hash {
+        image_hash[0] ^= 0xff;
+    }
+
+    let mut tlv: Box<dyn ManifestGen> = Box::new(make_tlv());
+    tlv.set_security_counter(Some(0));
+    tlv.set_compressed(&image_hash, image.len() as u32, DECOMPRESS_WINDOW_SIZE as u32);
+
+    let header = ImageHeader {
+        magic: tlv.get_magic(),
+        load_addr: 0,
+        hdr_size: HDR_SIZE as u16,
+        protect_tlv_size: tlv.protect_size(),
+        img_size: block.len() as u32,
+        flags: tlv.get_flags(),
+        ver: deps.my_version(slot.base_off, slot.index),
+        _pad2: 0,
+    };
+
+    let mut buf = header.as_raw().to_vec();
+    buf.extend_from_slice(&block);
+    tlv.add_bytes(&buf);
+    buf.append(&mut tlv.make_tlv());
+
+    let align = dev.align();
+    while buf.len() % align != 0 {
+        buf.push(dev.erased_val());
+    }
+    dev.write(slot.base_off + slot.image_off, &buf).unwrap();
+
+    // The last window is padded to the write alignment.
+    let image_sz = image.len();
+    let mut plain = image;
+    while plain.len() % align != 0 {
+        plain.push(dev.erased_val());
+    }
+
+    ImageData {
+        size: image_sz,
+        plain,
+        cipher: None,
+    }
+}
+
 /// Install no image.  This is used when no upgrade happens.
 fn install_no_image() -> ImageData {
     ImageData {
@@ -2037,7 +2711,7 @@ fn verify_image(flash: &SimMultiFlash, slot: &SlotInfo, images: &ImageData) -> b
     let dev_id = slot.dev_id;
 
     let mut copy = vec![0u8; buf.len()];
-    let offset = slot.base_off;
+    let offset = slot.base_off + slot.image_off;
     let dev = flash.get(&dev_id).unwrap();
     dev.read(offset, &mut copy).unwrap();
 
@@ -2205,6 +2879,8 @@ pub struct SlotInfo {
     pub base_off: usize,
     pub trailer_off: usize,
     pub len: usize,
+    // Offset of the image within the slot.
+    pub image_off: usize,
     // Which slot within this device.
     pub index: usize,
     pub dev_id: u8,
@@ -2289,7 +2965,8 @@ trait AsRaw : Sized {
 /// Returns an ImageSize representing the best size to test, possibly just with the given size.
 fn maximal(size: usize) -> ImageSize {
     if Caps::OverwriteUpgrade.present() ||
-        Caps::SwapUsingMove.present()
+        Caps::SwapUsingMove.present() ||
+        Caps::SwapUsingOffset.present()
     {
         ImageSize::Given(size)
     } else {
@@ -2305,11 +2982,16 @@ pub fn show_sizes() {
     }
 }
 
-#[cfg(not(feature = "max-align-32"))]
+#[cfg(not(any(feature = "max-align-16", feature = "max-align-32")))]
 fn test_alignments() -> &'static [usize] {
     &[1, 2, 4, 8]
 }
 
+#[cfg(feature = "max-align-16")]
+fn test_alignments() -> &'static [usize] {
+    &[1, 2, 4, 8, 16]
+}
+
 #[cfg(feature = "max-align-32")]
 fn test_alignments() -> &'static [usize] {
     &[32]
@@ -13,8 +13,10 @@ use std::{
 use serde_derive::Deserialize;
 
 mod caps;
+mod delta;
 mod depends;
 mod image;
+mod lz4;
 mod tlv;
 mod utils;
 pub mod testlog;
@@ -64,7 +66,7 @@ struct Args {
 #[derive(Copy, Clone, Debug, Deserialize)]
 pub enum DeviceName {
     Stm32f4, K64f, K64fBig, K64fMulti, Nrf52840, Nrf52840SpiFlash,
-    Nrf52840UnequalSlots,
+    Nrf52840UnequalSlots, Nrf52840UnequalSlotsLargerSlot1, AlifMram,
 }
 
 pub static ALL_DEVICES: &[DeviceName] = &[
@@ -75,6 +77,8 @@ pub static ALL_DEVICES: &[DeviceName] = &[
     DeviceName::Nrf52840,
     DeviceName::Nrf52840SpiFlash,
     DeviceName::Nrf52840UnequalSlots,
+    DeviceName::Nrf52840UnequalSlotsLargerSlot1,
+    DeviceName::AlifMram,
 ];
 
 impl fmt::Display for DeviceName {
@@ -87,6 +91,8 @@ impl fmt::Display for DeviceName {
             DeviceName::Nrf52840 => "nrf52840",
             DeviceName::Nrf52840SpiFlash => "Nrf52840SpiFlash",
             DeviceName::Nrf52840UnequalSlots => "Nrf52840UnequalSlots",
+            DeviceName::Nrf52840UnequalSlotsLargerSlot1 => "Nrf52840UnequalSlotsLargerSlot1",
+            DeviceName::AlifMram => "alifmram",
         };
         f.write_str(name)
     }
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Alif Semiconductor
+//
+// SPDX-License-Identifier: Apache-2.0
+
+//! LZ4 blocks of compressed images, as made by imgtool, see scripts/imgtool/lz4.py.
+//!
+//! The block format is the standard one, but the matches never reach further back than the
+//! decompression window, the only history the bootloader keeps.
+
+use std::collections::HashMap;
+
+/// The shortest match, which match lengths are relative to.
+const MIN_MATCH: usize = 4;
+
+/// The last match starts at least `MF_LIMIT` bytes before the end, and the last `LAST_LITERALS`
+/// bytes are always literals, as LZ4 decoders expect.
+const MF_LIMIT: usize = 12;
+const LAST_LITERALS: usize = 5;
+
+/// The largest offset the format can hold.
+const MAX_OFFSET: usize = 0xffff;
+
+fn push_length(out: &mut Vec<u8>, mut n: usize) {
+    while n >= 255 {
+        out.push(255);
+        n -= 255;
+    }
+    out.push(n as u8);
+}
+
+fn push_sequence(out: &mut Vec<u8>, literal: &[u8], match_len: usize, offset: usize) {
+    let mut token = (literal.len().min(15) as u8) << 4;
+    if match_len > 0 {
+        token |= (match_len - MIN_MATCH).min(15) as u8;
+    }
+    out.push(token);
+    if literal.len() >= 15 {
+        push_length(out, literal.len() - 15);
+    }
+    out.extend_from_slice(literal);
+    if match_len > 0 {
+        out.extend_from_slice(&(offset as u16).to_le_bytes());
+        if match_len - MIN_MATCH >= 15 {
+            push_length(out, match_len - MIN_MATCH - 15);
+        }
+    }
+}
+
+/// Compress `data` into an LZ4 block whose matches reach at most `window` bytes back.
+pub fn compress_block(data: &[u8], window: usize) -> Vec<u8> {
+    let max_offset = window.min(MAX_OFFSET);
+    let match_limit = data.len().saturating_sub(LAST_LITERALS);
+    let mut last: HashMap<&[u8], usize> = HashMap::new();
+
+    let mut out = vec![];
+    let mut literal_start = 0;
+    let mut p = 0;
+    while p + MF_LIMIT < data.len() {
+        let prefix = &data[p .. p + MIN_MATCH];
+        let candidate = last.insert(prefix, p);
+        let len = match candidate {
+            Some(q) if p - q <= max_offset => {
+                let mut n = 0;
+                while p + n < match_limit && data[q + n] == data[p + n] {
+                    n += 1;
+                }
+                n
+            }
+            _ => 0,
+        };
+        if len < MIN_MATCH {
+            p += 1;
+            continue;
+        }
+
+        push_sequence(&mut out, &data[literal_start .. p], len, p - candidate.unwrap());
+        p += len;
+        literal_start = p;
+    }
+    push_sequence(&mut out, &data[literal_start ..], 0, 0);
+
+    out
+}
@@ -62,6 +62,11 @@ pub enum TlvKinds {
     ENCX25519 = 0x33,
     DEPENDENCY = 0x40,
     SECCNT = 0x50,
+    DELTABASE = 0x80,
+    DELTATARGET = 0x81,
+    DELTAINFO = 0x82,
+    DECOMPHASH = 0x83,
+    DECOMPINFO = 0x84,
 }
 
 #[allow(dead_code, non_camel_case_types)]
@@ -71,6 +76,8 @@ pub enum TlvFlags {
     ENCRYPTED_AES128 = 0x04,
     ENCRYPTED_AES256 = 0x08,
     RAM_LOAD = 0x20,
+    DELTA = 0x40,
+    COMPRESSED_LZ4 = 0x80,
 }
 
 /// A generator for manifests.  The format of the manifest can be either a
@@ -118,6 +125,15 @@ pub trait ManifestGen {
     /// Sets the ignore_ram_load_flag so that can be validated when it is missing,
     /// it will not load successfully.
     fn set_ignore_ram_load_flag(&mut self);
+
+    /// Make this a delta image, whose payload is a patch turning the image with the hash
+    /// `base_hash` into the one with the hash `target_hash`.
+    fn set_delta(&mut self, base_hash: &[u8], target_hash: &[u8], target_size: u32,
+                 window_size: u32);
+
+    /// Make this a compressed image, whose payload decompresses to the image with the hash
+    /// `image_hash`.
+    fn set_compressed(&mut self, image_hash: &[u8], image_size: u32, window_size: u32);
 }
 
 #[derive(Debug, Default)]
@@ -132,6 +148,8 @@ pub struct TlvGen {
     security_cnt: Option<u32>,
     /// Ignore RAM_LOAD flag
     ignore_ram_load_flag: bool,
+    delta: Option<Delta>,
+    compressed: Option<Compressed>,
 }
 
 #[derive(Debug)]
@@ -140,6 +158,21 @@ struct Dependency {
     version: ImageVersion,
 }
 
+#[derive(Debug)]
+struct Delta {
+    base_hash: Vec<u8>,
+    target_hash: Vec<u8>,
+    target_size: u32,
+    window_size: u32,
+}
+
+#[derive(Debug)]
+struct Compressed {
+    image_hash: Vec<u8>,
+    image_size: u32,
+    window_size: u32,
+}
+
 impl TlvGen {
     /// Construct a new tlv generator that will only contain a hash of the data.
     #[allow(dead_code)]
@@ -330,11 +363,19 @@ impl ManifestGen for TlvGen {
 
     /// Retrieve the header flags for this configuration.  This can be called at any time.
     fn get_flags(&self) -> u32 {
+        let mut flags = self.flags;
+        if self.delta.is_some() {
+            flags |= TlvFlags::DELTA as u32;
+        }
+        if self.compressed.is_some() {
+            flags |= TlvFlags::COMPRESSED_LZ4 as u32;
+        }
+
         // For the RamLoad case, add in the flag for this feature.
         if Caps::RamLoad.present() && !self.ignore_ram_load_flag {
-            self.flags | (TlvFlags::RAM_LOAD as u32)
+            flags | (TlvFlags::RAM_LOAD as u32)
         } else {
-            self.flags
+            flags
         }
     }
 
@@ -345,7 +386,8 @@ impl ManifestGen for TlvGen {
 
     fn protect_size(&self) -> u16 {
         let mut size = 0;
-        if !self.dependencies.is_empty() || (Caps::HwRollbackProtection.present() && self.security_cnt.is_some()) {
+        if !self.dependencies.is_empty() || (Caps::HwRollbackProtection.present() && self.security_cnt.is_some()) ||
+            self.delta.is_some() || self.compressed.is_some() {
             // include the TLV area header.
             size += 4;
             // add space for each dependency.
@@ -353,6 +395,15 @@ impl ManifestGen for TlvGen {
             if Caps::HwRollbackProtection.present() && self.security_cnt.is_some() {
                 size += 4 + 4;
             }
+            if let Some(delta) = &self.delta {
+                size += 4 + delta.base_hash.len() as u16;
+                size += 4 + delta.target_hash.len() as u16;
+                size += 4 + 8;
+            }
+            if let Some(compressed) = &self.compressed {
+                size += 4 + compressed.image_hash.len() as u16;
+                size += 4 + 8;
+            }
         }
         size
     }
@@ -462,6 +513,29 @@ impl ManifestGen for TlvGen {
                 protected_tlv.write_u32::<LittleEndian>(self.security_cnt.unwrap() as u32).unwrap();
             }
 
+            if let Some(delta) = &self.delta {
+                protected_tlv.write_u16::<LittleEndian>(TlvKinds::DELTABASE as u16).unwrap();
+                protected_tlv.write_u16::<LittleEndian>(delta.base_hash.len() as u16).unwrap();
+                protected_tlv.extend_from_slice(&delta.base_hash);
+                protected_tlv.write_u16::<LittleEndian>(TlvKinds::DELTATARGET as u16).unwrap();
+                protected_tlv.write_u16::<LittleEndian>(delta.target_hash.len() as u16).unwrap();
+                protected_tlv.extend_from_slice(&delta.target_hash);
+                protected_tlv.write_u16::<LittleEndian>(TlvKinds::DELTAINFO as u16).unwrap();
+                protected_tlv.write_u16::<LittleEndian>(8).unwrap();
+                protected_tlv.write_u32::<LittleEndian>(delta.target_size).unwrap();
+                protected_tlv.write_u32::<LittleEndian>(delta.window_size).unwrap();
+            }
+
+            if let Some(compressed) = &self.compressed {
+                protected_tlv.write_u16::<LittleEndian>(TlvKinds::DECOMPHASH as u16).unwrap();
+                protected_tlv.write_u16::<LittleEndian>(compressed.image_hash.len() as u16).unwrap();
+                protected_tlv.extend_from_slice(&compressed.image_hash);
+                protected_tlv.write_u16::<LittleEndian>(TlvKinds::DECOMPINFO as u16).unwrap();
+                protected_tlv.write_u16::<LittleEndian>(8).unwrap();
+                protected_tlv.write_u32::<LittleEndian>(compressed.image_size).unwrap();
+                protected_tlv.write_u32::<LittleEndian>(compressed.window_size).unwrap();
+            }
+
             assert_eq!(size, protected_tlv.len() as u16, "protected TLV length incorrect");
         }
 
@@ -833,6 +907,24 @@ impl ManifestGen for TlvGen {
     fn set_ignore_ram_load_flag(&mut self) {
         self.ignore_ram_load_flag = true;
     }
+
+    fn set_delta(&mut self, base_hash: &[u8], target_hash: &[u8], target_size: u32,
+                 window_size: u32) {
+        self.delta = Some(Delta {
+            base_hash: base_hash.to_vec(),
+            target_hash: target_hash.to_vec(),
+            target_size,
+            window_size,
+        });
+    }
+
+    fn set_compressed(&mut self, image_hash: &[u8], image_size: u32, window_size: u32) {
+        self.compressed = Some(Compressed {
+            image_hash: image_hash.to_vec(),
+            image_size,
+            window_size,
+        });
+    }
 }
 
 include!("rsa_pub_key-rs.txt");
@@ -57,7 +57,12 @@ sim_test!(basic_revert, make_image(&NO_DEPS, true), run_basic_revert());
 sim_test!(revert_with_fails, make_image(&NO_DEPS, false), run_revert_with_fails());
 sim_test!(perm_with_fails, make_image(&NO_DEPS, true), run_perm_with_fails());
 sim_test!(perm_with_random_fails, make_image(&NO_DEPS, true), run_perm_with_random_fails(5));
+sim_test!(same_image_upgrade, make_image(&NO_DEPS, true), run_same_image_upgrade());
 sim_test!(norevert, make_image(&NO_DEPS, true), run_norevert());
+sim_test!(delta_upgrade, make_delta_image(false), run_delta_upgrade());
+sim_test!(delta_wrong_base, make_delta_image(true), run_delta_wrong_base());
+sim_test!(compressed_upgrade, make_compressed_image(false), run_compressed_upgrade());
+sim_test!(compressed_bad_hash, make_compressed_image(true), run_compressed_bad_hash());
 
 #[cfg(not(feature = "max-align-32"))]
 sim_test!(oversized_secondary_slot, make_oversized_secondary_slot_image(), run_oversizefail_upgrade());
@@ -71,6 +76,8 @@ sim_test!(ram_load_first, make_no_upgrade_image(&NO_DEPS, ImageManipulation::Non
 sim_test!(ram_load_split, make_no_upgrade_image(&NO_DEPS, ImageManipulation::None), run_split_ram_load());
 sim_test!(hw_prot_failed_security_cnt_check, make_image_with_security_counter(Some(0)), run_hw_rollback_prot());
 sim_test!(hw_prot_missing_security_cnt, make_image_with_security_counter(None), run_hw_rollback_prot());
+sim_test!(validation_cache, make_no_upgrade_image(&NO_DEPS, ImageManipulation::None), run_validation_cache());
+sim_test!(validation_cache_upgrade, make_no_upgrade_image(&NO_DEPS, ImageManipulation::None), run_validation_cache_upgrade());
 sim_test!(ram_load_out_of_bounds, make_no_upgrade_image(&NO_DEPS, ImageManipulation::WrongOffset), run_ram_load_boot_with_result(false));
 sim_test!(ram_load_missing_header_flag, make_no_upgrade_image(&NO_DEPS, ImageManipulation::IgnoreRamLoadFlag), run_ram_load_boot_with_result(false));
 sim_test!(ram_load_failed_validation, make_no_upgrade_image(&NO_DEPS, ImageManipulation::BadSignature), run_ram_load_boot_with_result(false));